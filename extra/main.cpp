@@ -1,5 +1,34 @@
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <shader_editor/heap_counter.h>
 #include <shader_editor/shader_editor.h>
 
+#ifdef CSE_COUNT_ALLOCATIONS
+// Replaced so the debug window can show how many heap allocations are made
+// Only the editor_alloc_count target defines this, the normal editor keeps the standard allocator
+void* operator new(const std::size_t size)
+{
+	cse::HeapCounter::record_allocation();
+	void* const result{ std::malloc(size == 0 ? 1 : size) };
+	if (result == nullptr) {
+		throw std::bad_alloc{};
+	}
+	return result;
+}
+
+void operator delete(void* const ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* const ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+#endif
+
 int main()
 {
 	cse::ShaderGraphEditor editor;
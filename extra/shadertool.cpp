@@ -0,0 +1,475 @@
+// Command line tool for checking and converting shader files in bulk, it needs only shader_core and shader_graph
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+
+#include <shader_graph/graph.h>
+#include <shader_graph/node.h>
+#include <shader_graph/node_type.h>
+#include <shader_graph/serialize.h>
+
+namespace fs = boost::filesystem;
+
+enum class Command {
+	VALIDATE,
+	CANONICALIZE,
+	TO_BINARY,
+	TO_TEXT,
+	STATS,
+};
+
+static const char USAGE[]{
+	"Usage: shadertool <command> [-j threads] <path>...\n"
+	"Commands:\n"
+	"  validate      check that every file can be read\n"
+	"  canonicalize  rewrite each file as the editor would save it, keeping its format\n"
+	"  to-binary     rewrite each file in the binary format\n"
+	"  to-text       rewrite each file in the text format\n"
+	"  stats         report node and connection totals\n"
+	"A directory is searched recursively for .shader files, a file is read whatever its extension.\n"
+	"Exits with 1 if any file could not be read or written, 2 for a usage error.\n"
+};
+
+static boost::optional<Command> command_from(const boost::string_view name)
+{
+	if (name == "validate") {
+		return Command::VALIDATE;
+	}
+	else if (name == "canonicalize") {
+		return Command::CANONICALIZE;
+	}
+	else if (name == "to-binary") {
+		return Command::TO_BINARY;
+	}
+	else if (name == "to-text") {
+		return Command::TO_TEXT;
+	}
+	else if (name == "stats") {
+		return Command::STATS;
+	}
+	return boost::none;
+}
+
+/**
+ * @brief Runs tasks on a fixed set of threads, an idle thread takes tasks queued by the others.
+ *
+ * Each thread keeps its own queue. A task queued while running on a worker goes to the back of that worker's queue
+ * and the worker takes from the back, so one directory is finished before the next is started. An idle worker takes
+ * from the front of another worker's queue, which holds the oldest and usually largest pieces of work.
+ */
+class WorkStealingPool {
+public:
+	explicit WorkStealingPool(size_t thread_count);
+
+	// Safe to call from within a task
+	void submit(std::function<void()> task);
+	// Returns once every task has finished, including tasks queued while running
+	void run();
+
+private:
+	struct WorkerQueue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	void work(size_t worker);
+	bool take_task(size_t worker, std::function<void()>& task);
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::atomic<size_t> next_queue{ 0 };
+
+	// Guards the counts below, idle workers wait on work_changed until one of them changes
+	std::mutex state_mutex;
+	std::condition_variable work_changed;
+	// Tasks queued or running, a task's own submissions are counted before the task itself finishes
+	size_t pending{ 0 };
+	// Every task ever submitted, a worker that found nothing to take sleeps until this grows
+	size_t submitted{ 0 };
+};
+
+// Index of the worker running on this thread, only set while the thread is working
+static thread_local boost::optional<size_t> this_worker;
+
+WorkStealingPool::WorkStealingPool(const size_t thread_count)
+{
+	for (size_t i = 0; i < std::max(thread_count, static_cast<size_t>(1)); i++) {
+		queues.push_back(std::make_unique<WorkerQueue>());
+	}
+}
+
+void WorkStealingPool::submit(std::function<void()> task)
+{
+	// Tasks from outside the pool are spread between the queues
+	const size_t worker{ this_worker.value_or(next_queue++ % queues.size()) };
+	{
+		std::lock_guard<std::mutex> lock{ state_mutex };
+		pending++;
+	}
+	{
+		std::lock_guard<std::mutex> lock{ queues[worker]->mutex };
+		queues[worker]->tasks.push_back(std::move(task));
+	}
+	// Counted only once the task can be taken, so a worker woken by this will find it
+	{
+		std::lock_guard<std::mutex> lock{ state_mutex };
+		submitted++;
+	}
+	work_changed.notify_one();
+}
+
+void WorkStealingPool::run()
+{
+	std::vector<std::thread> threads;
+	threads.reserve(queues.size());
+	for (size_t i = 1; i < queues.size(); i++) {
+		try {
+			threads.push_back(std::thread{ [this, i]() { work(i); } });
+		}
+		catch (const std::system_error&) {
+			// Queues left without a thread are emptied by the others stealing from them, down to this thread alone
+			break;
+		}
+	}
+	work(0);
+	for (std::thread& this_thread : threads) {
+		this_thread.join();
+	}
+}
+
+void WorkStealingPool::work(const size_t worker)
+{
+	this_worker = worker;
+	std::function<void()> task;
+	while (true) {
+		size_t seen_submitted;
+		{
+			std::lock_guard<std::mutex> lock{ state_mutex };
+			if (pending == 0) {
+				break;
+			}
+			seen_submitted = submitted;
+		}
+		if (take_task(worker, task)) {
+			task();
+			task = nullptr;
+			std::lock_guard<std::mutex> lock{ state_mutex };
+			pending--;
+			if (pending == 0) {
+				work_changed.notify_all();
+			}
+		}
+		else {
+			// Every queue was empty, sleep until another task is submitted or the last running one finishes
+			std::unique_lock<std::mutex> lock{ state_mutex };
+			work_changed.wait(lock, [this, seen_submitted]() { return pending == 0 || submitted != seen_submitted; });
+		}
+	}
+	this_worker = boost::none;
+}
+
+bool WorkStealingPool::take_task(const size_t worker, std::function<void()>& task)
+{
+	{
+		WorkerQueue& own_queue{ *queues[worker] };
+		std::lock_guard<std::mutex> lock{ own_queue.mutex };
+		if (own_queue.tasks.empty() == false) {
+			task = std::move(own_queue.tasks.back());
+			own_queue.tasks.pop_back();
+			return true;
+		}
+	}
+	for (size_t i = 1; i < queues.size(); i++) {
+		WorkerQueue& other_queue{ *queues[(worker + i) % queues.size()] };
+		std::lock_guard<std::mutex> lock{ other_queue.mutex };
+		if (other_queue.tasks.empty() == false) {
+			task = std::move(other_queue.tasks.front());
+			other_queue.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+// Totals for a set of files, each task fills its own and adds it to the shared one when done
+struct Report {
+	size_t file_count{ 0 };
+	size_t binary_count{ 0 };
+	size_t rewritten_count{ 0 };
+	uint64_t byte_count{ 0 };
+	uint64_t node_count{ 0 };
+	uint64_t connection_count{ 0 };
+	size_t max_node_count{ 0 };
+	std::array<uint64_t, static_cast<size_t>(csg::NodeType::COUNT)> type_counts{};
+	std::vector<std::string> errors;
+
+	void add(Report&& other)
+	{
+		file_count += other.file_count;
+		binary_count += other.binary_count;
+		rewritten_count += other.rewritten_count;
+		byte_count += other.byte_count;
+		node_count += other.node_count;
+		connection_count += other.connection_count;
+		max_node_count = std::max(max_node_count, other.max_node_count);
+		for (size_t i = 0; i < type_counts.size(); i++) {
+			type_counts[i] += other.type_counts[i];
+		}
+		std::move(other.errors.begin(), other.errors.end(), std::back_inserter(errors));
+	}
+};
+
+static boost::optional<std::string> read_file(const fs::path& path)
+{
+	std::ifstream input{ path.string(), std::ios::binary };
+	if (input.is_open() == false) {
+		return boost::none;
+	}
+	std::string result{ std::istreambuf_iterator<char>{ input }, std::istreambuf_iterator<char>{} };
+	if (input.bad()) {
+		return boost::none;
+	}
+	return result;
+}
+
+// Writes beside the file and renames over it so an interrupted run never leaves a partly written file
+static bool replace_file(const fs::path& path, const std::string& contents)
+{
+	fs::path temp_path{ path };
+	temp_path += ".tmp";
+	{
+		std::ofstream output{ temp_path.string(), std::ios::binary | std::ios::trunc };
+		output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+		output.close();
+		if (output.fail()) {
+			boost::system::error_code remove_error;
+			fs::remove(temp_path, remove_error);
+			return false;
+		}
+	}
+	boost::system::error_code error;
+	fs::rename(temp_path, path, error);
+	return !error;
+}
+
+class ShaderTool {
+public:
+	ShaderTool(Command command, size_t thread_count) : command{ command }, pool{ thread_count } {}
+
+	void add_path(const fs::path& path);
+	Report run();
+
+private:
+	void process_directory(const fs::path& path);
+	void process_file(const fs::path& path);
+	void finish(Report&& file_report);
+
+	const Command command;
+	WorkStealingPool pool;
+	std::mutex report_mutex;
+	Report report;
+};
+
+void ShaderTool::add_path(const fs::path& path)
+{
+	boost::system::error_code error;
+	if (fs::is_directory(path, error)) {
+		pool.submit([this, path]() { process_directory(path); });
+	}
+	else {
+		pool.submit([this, path]() { process_file(path); });
+	}
+}
+
+Report ShaderTool::run()
+{
+	pool.run();
+	std::sort(report.errors.begin(), report.errors.end());
+	return std::move(report);
+}
+
+void ShaderTool::process_directory(const fs::path& path)
+{
+	boost::system::error_code error;
+	fs::directory_iterator iter{ path, error };
+	for (; !error && iter != fs::directory_iterator{}; iter.increment(error)) {
+		const fs::path& entry_path{ iter->path() };
+		boost::system::error_code status_error;
+		// Links to directories are not followed, so a link cycle cannot make the search endless
+		if (fs::is_directory(iter->symlink_status(status_error))) {
+			pool.submit([this, entry_path]() { process_directory(entry_path); });
+		}
+		else if (fs::is_regular_file(iter->status(status_error)) && entry_path.extension() == ".shader") {
+			pool.submit([this, entry_path]() { process_file(entry_path); });
+		}
+	}
+	if (error) {
+		Report directory_report;
+		directory_report.errors.push_back(path.string() + ": could not list directory, " + error.message());
+		finish(std::move(directory_report));
+	}
+}
+
+void ShaderTool::process_file(const fs::path& path)
+{
+	Report file_report;
+	file_report.file_count = 1;
+
+	const boost::optional<std::string> contents{ read_file(path) };
+	if (contents.has_value() == false) {
+		file_report.errors.push_back(path.string() + ": could not read file");
+		finish(std::move(file_report));
+		return;
+	}
+	const bool is_binary{ csg::is_binary_graph(*contents) };
+	const boost::optional<csg::Graph> graph{ is_binary ? csg::deserialize_graph_binary(*contents) : csg::deserialize_graph(*contents) };
+	file_report.byte_count = contents->size();
+	file_report.binary_count = is_binary ? 1 : 0;
+	if (graph.has_value() == false) {
+		file_report.errors.push_back(path.string() + ": not a valid shader graph");
+		finish(std::move(file_report));
+		return;
+	}
+
+	file_report.node_count = graph->nodes().size();
+	file_report.connection_count = graph->connections().size();
+	file_report.max_node_count = graph->nodes().size();
+	if (command == Command::STATS) {
+		for (const auto& node : graph->nodes()) {
+			file_report.type_counts[static_cast<size_t>(node->type())]++;
+		}
+	}
+
+	boost::optional<std::string> new_contents;
+	switch (command) {
+	case Command::CANONICALIZE:
+		new_contents = is_binary ? graph->serialize_binary() : graph->serialize();
+		break;
+	case Command::TO_BINARY:
+		new_contents = graph->serialize_binary();
+		break;
+	case Command::TO_TEXT:
+		new_contents = graph->serialize();
+		break;
+	case Command::VALIDATE:
+	case Command::STATS:
+		break;
+	}
+	if (new_contents.has_value() && *new_contents != *contents) {
+		if (replace_file(path, *new_contents)) {
+			file_report.rewritten_count = 1;
+		}
+		else {
+			file_report.errors.push_back(path.string() + ": could not write file");
+		}
+	}
+
+	finish(std::move(file_report));
+}
+
+void ShaderTool::finish(Report&& file_report)
+{
+	std::lock_guard<std::mutex> lock{ report_mutex };
+	report.add(std::move(file_report));
+}
+
+static void print_report(const Command command, const Report& report, const double elapsed_seconds)
+{
+	for (const std::string& error : report.errors) {
+		std::cerr << error << std::endl;
+	}
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << report.file_count << " files read in " << elapsed_seconds << " s, " << report.errors.size() << " errors" << std::endl;
+	if (command == Command::CANONICALIZE || command == Command::TO_BINARY || command == Command::TO_TEXT) {
+		std::cout << report.rewritten_count << " files rewritten" << std::endl;
+	}
+	if (command != Command::STATS) {
+		return;
+	}
+
+	std::cout << report.binary_count << " binary, " << (report.file_count - report.binary_count) << " text, " << report.byte_count << " bytes" << std::endl;
+	std::cout << report.node_count << " nodes, largest graph " << report.max_node_count << " nodes" << std::endl;
+	std::cout << report.connection_count << " connections" << std::endl;
+
+	std::vector<std::pair<uint64_t, csg::NodeType>> type_counts;
+	for (const csg::NodeType type : csg::NodeTypeList{}) {
+		const uint64_t count{ report.type_counts[static_cast<size_t>(type)] };
+		if (count > 0) {
+			type_counts.push_back(std::make_pair(count, type));
+		}
+	}
+	std::sort(type_counts.begin(), type_counts.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+	std::cout << "Nodes by type:" << std::endl;
+	for (const auto& count_type : type_counts) {
+		const boost::optional<csg::NodeTypeInfo> info{ csg::NodeTypeInfo::from(count_type.second) };
+		std::cout << "  " << (info ? info->name() : "unknown") << ": " << count_type.first << std::endl;
+	}
+}
+
+int main(const int argc, const char* const argv[])
+{
+	if (argc < 2) {
+		std::cerr << USAGE;
+		return 2;
+	}
+	const boost::optional<Command> command{ command_from(argv[1]) };
+	if (command.has_value() == false) {
+		std::cerr << "Unknown command: " << argv[1] << std::endl << USAGE;
+		return 2;
+	}
+
+	size_t thread_count{ std::max(std::thread::hardware_concurrency(), 1u) };
+	std::vector<fs::path> paths;
+	for (int i = 2; i < argc; i++) {
+		const boost::string_view arg{ argv[i] };
+		if (arg == "-j" && i + 1 < argc) {
+			const long parsed_count{ std::strtol(argv[++i], nullptr, 10) };
+			if (parsed_count < 1) {
+				std::cerr << "Thread count must be at least 1" << std::endl;
+				return 2;
+			}
+			thread_count = static_cast<size_t>(parsed_count);
+		}
+		else {
+			paths.push_back(fs::path{ argv[i] });
+		}
+	}
+	if (paths.empty()) {
+		std::cerr << USAGE;
+		return 2;
+	}
+
+	const auto begin{ std::chrono::steady_clock::now() };
+	ShaderTool tool{ *command, thread_count };
+	for (const fs::path& path : paths) {
+		tool.add_path(path);
+	}
+	const Report report{ tool.run() };
+	const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - begin };
+
+	print_report(*command, report, elapsed.count());
+	return report.errors.empty() ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines Hasher.
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "vector.h"
+
+namespace csc {
+
+	/**
+	 * @brief Builds a 64-bit hash from a sequence of values. Not suitable for cryptographic use.
+	 */
+	class Hasher {
+	public:
+		Hasher(uint64_t seed = 0) : state{ mix(seed + 0x9e3779b97f4a7c15ULL) } {}
+
+		void add(const uint64_t value) { state = mix(state ^ (value + 0x9e3779b97f4a7c15ULL + (state << 6) + (state >> 2))); }
+		void add(const int64_t value) { add(static_cast<uint64_t>(value)); }
+		void add(const int value) { add(static_cast<uint64_t>(static_cast<int64_t>(value))); }
+		void add(const bool value) { add(static_cast<uint64_t>(value ? 1 : 0)); }
+		void add(const float value)
+		{
+			// 0.0f and -0.0f compare equal, so they must also hash equal
+			const float normalized{ (value == 0.0f) ? 0.0f : value };
+			uint32_t bits;
+			std::memcpy(&bits, &normalized, sizeof(bits));
+			add(static_cast<uint64_t>(bits));
+		}
+		void add(const Float2 value) { add(value.x); add(value.y); }
+		void add(const Float3 value) { add(value.x); add(value.y); add(value.z); }
+		void add(const Int2 value) { add(value.x); add(value.y); }
+
+		uint64_t value() const { return state; }
+
+	private:
+		// Finalizer from splitmix64, every input bit affects every output bit
+		static uint64_t mix(uint64_t x)
+		{
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			return x ^ (x >> 31);
+		}
+
+		uint64_t state;
+	};
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines PersistentMap.
+ */
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "shared_ptr.h"
+
+namespace csc {
+
+	/**
+	 * @brief Hash map that shares its contents with copies of itself.
+	 *
+	 * Entries are split across a fixed number of shards by hash. Copying the map only copies shard pointers, a shard
+	 * is copied the first time one of the maps sharing it is modified.
+	 */
+	template <typename K, typename V, typename Hash = std::hash<K>> class PersistentMap {
+	private:
+		typedef std::unordered_map<K, V, Hash> Shard;
+		static constexpr size_t SHARD_COUNT{ 64 };
+		typedef std::array<std::shared_ptr<Shard>, SHARD_COUNT> ShardArray;
+
+	public:
+		class const_iterator : public boost::iterator_facade<const_iterator, const std::pair<const K, V>, boost::forward_traversal_tag> {
+		public:
+			const_iterator() : shards{ nullptr }, shard_index{ SHARD_COUNT } {}
+			const_iterator(const ShardArray& shards, const size_t shard_index) : shards{ &shards }, shard_index{ shard_index }
+			{
+				skip_empty_shards();
+			}
+
+		private:
+			friend class boost::iterator_core_access;
+
+			void skip_empty_shards()
+			{
+				while (shard_index < SHARD_COUNT && ((*shards)[shard_index] == nullptr || (*shards)[shard_index]->empty())) {
+					shard_index++;
+				}
+				if (shard_index < SHARD_COUNT) {
+					entry = (*shards)[shard_index]->cbegin();
+				}
+			}
+
+			void increment()
+			{
+				entry++;
+				if (entry == (*shards)[shard_index]->cend()) {
+					shard_index++;
+					skip_empty_shards();
+				}
+			}
+
+			bool equal(const const_iterator& other) const
+			{
+				if (shard_index != other.shard_index) {
+					return false;
+				}
+				return shard_index == SHARD_COUNT || entry == other.entry;
+			}
+
+			const std::pair<const K, V>& dereference() const { return *entry; }
+
+			const ShardArray* shards;
+			size_t shard_index;
+			typename Shard::const_iterator entry;
+		};
+
+		const V* find(const K& key) const
+		{
+			const std::shared_ptr<Shard>& shard{ shards[shard_index(key)] };
+			if (shard == nullptr) {
+				return nullptr;
+			}
+			const auto iter{ shard->find(key) };
+			return (iter == shard->end()) ? nullptr : &iter->second;
+		}
+
+		// Returns a mutable pointer to the value for key, copying its shard first if it is shared
+		V* find_mutable(const K& key)
+		{
+			if (find(key) == nullptr) {
+				return nullptr;
+			}
+			return &mutable_shard(shard_index(key)).find(key)->second;
+		}
+
+		bool contains(const K& key) const { return find(key) != nullptr; }
+
+		// Returns the value for key, inserting a default constructed value if it does not exist
+		V& operator[](const K& key)
+		{
+			Shard& shard{ mutable_shard(shard_index(key)) };
+			const size_t old_size{ shard.size() };
+			V& result{ shard[key] };
+			_size += shard.size() - old_size;
+			return result;
+		}
+
+		void insert_or_assign(const K& key, V value)
+		{
+			Shard& shard{ mutable_shard(shard_index(key)) };
+			const auto iter{ shard.find(key) };
+			if (iter == shard.end()) {
+				shard.emplace(key, std::move(value));
+				_size++;
+			}
+			else {
+				iter->second = std::move(value);
+			}
+		}
+
+		bool erase(const K& key)
+		{
+			if (contains(key) == false) {
+				return false;
+			}
+			mutable_shard(shard_index(key)).erase(key);
+			_size--;
+			return true;
+		}
+
+		void clear()
+		{
+			shards.fill(nullptr);
+			_size = 0;
+		}
+
+		size_t size() const { return _size; }
+		bool empty() const { return _size == 0; }
+
+		const_iterator begin() const { return const_iterator{ shards, 0 }; }
+		const_iterator end() const { return const_iterator{ shards, SHARD_COUNT }; }
+
+		// Shards shared by both maps are skipped without looking at their contents
+		bool operator==(const PersistentMap& other) const
+		{
+			if (_size != other._size) {
+				return false;
+			}
+			for (size_t i = 0; i < SHARD_COUNT; i++) {
+				if (shards[i] == other.shards[i]) {
+					continue;
+				}
+				const bool this_empty{ shards[i] == nullptr || shards[i]->empty() };
+				const bool other_empty{ other.shards[i] == nullptr || other.shards[i]->empty() };
+				if (this_empty && other_empty) {
+					continue;
+				}
+				if (this_empty || other_empty || *shards[i] != *other.shards[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+		bool operator!=(const PersistentMap& other) const { return operator==(other) == false; }
+
+	private:
+		static size_t shard_index(const K& key) { return Hash{}(key) % SHARD_COUNT; }
+
+		Shard& mutable_shard(const size_t index)
+		{
+			std::shared_ptr<Shard>& shard{ shards[index] };
+			if (shard == nullptr) {
+				shard = std::make_shared<Shard>();
+			}
+			else if (is_sole_owner(shard) == false) {
+				// Shared with another map, this map gets its own copy
+				shard = std::make_shared<Shard>(*shard);
+			}
+			return *shard;
+		}
+
+		ShardArray shards;
+		size_t _size{ 0 };
+	};
+}
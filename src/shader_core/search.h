@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines count_before, a binary search for sorted lookup tables.
+ */
+
+#include <cstddef>
+
+namespace csc {
+	// Binary search that selects rather than branches, so a run of unpredictable inputs does not stall on mispredictions
+	// Returns the number of leading elements that are before the value, elements must be sorted so those all come first
+	template <typename T, typename TBefore>
+	size_t count_before(const T* const elements, const size_t count, const TBefore& is_before)
+	{
+		if (count == 0) {
+			return 0;
+		}
+		const T* base{ elements };
+		size_t remaining{ count };
+		while (remaining > 1) {
+			const size_t half{ remaining / 2 };
+			base = is_before(base[half]) ? base + half : base;
+			remaining -= half;
+		}
+		return static_cast<size_t>(base - elements) + (is_before(*base) ? 1 : 0);
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines is_sole_owner, the check used before writing to copy-on-write data in place.
+ */
+
+#include <atomic>
+#include <memory>
+
+namespace csc {
+	// Returns true if ptr holds the only reference to its object, which may then be modified in place
+	// use_count() is only a relaxed load. Another thread may have read the object through a copy it has just released,
+	// and the acquire fence orders those reads before any write the caller makes.
+	template <typename T> bool is_sole_owner(const std::shared_ptr<T>& ptr)
+	{
+		if (ptr.use_count() != 1) {
+			return false;
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return true;
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines SimdLanes, a thin wrapper over SSE2 or AVX2 intrinsics.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+// The widest instruction set the compiler has been told it may use is picked, there is no runtime detection
+// CSC_SIMD is only defined if one of them is available, code using SimdLanes needs a scalar path for when it is not
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CSC_SIMD
+#define CSC_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSC_SIMD
+#define CSC_SIMD_SSE2
+#endif
+
+namespace csc {
+#if defined(CSC_SIMD_AVX2)
+	/**
+	 * @brief Operations on 8 float or int32 lanes at once, using AVX2.
+	 *
+	 * Masks are float vectors with every bit of a lane set where a comparison was true.
+	 */
+	struct SimdLanes {
+		static constexpr size_t WIDTH{ 8 };
+		typedef __m256 Float;
+		typedef __m256i Int;
+		typedef __m256 Mask;
+
+		static Float load(const float* const values) { return _mm256_loadu_ps(values); }
+		static void store(float* const values, const Float a) { _mm256_storeu_ps(values, a); }
+		static Float set(const float value) { return _mm256_set1_ps(value); }
+		static Int set_int(const int32_t value) { return _mm256_set1_epi32(value); }
+
+		static Float add(const Float a, const Float b) { return _mm256_add_ps(a, b); }
+		static Float sub(const Float a, const Float b) { return _mm256_sub_ps(a, b); }
+		static Float mul(const Float a, const Float b) { return _mm256_mul_ps(a, b); }
+		static Float div(const Float a, const Float b) { return _mm256_div_ps(a, b); }
+		static Int add_int(const Int a, const Int b) { return _mm256_add_epi32(a, b); }
+		static Int sub_int(const Int a, const Int b) { return _mm256_sub_epi32(a, b); }
+
+		// Comparisons with a NaN lane are false
+		static Mask less(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static Mask less_equal(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		static Mask equal_int(const Int a, const Int b) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)); }
+		static Mask mask_and(const Mask a, const Mask b) { return _mm256_and_ps(a, b); }
+		static Mask mask_or(const Mask a, const Mask b) { return _mm256_or_ps(a, b); }
+		static Mask mask_not(const Mask a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+		// Bit i is set if lane i of the mask is set
+		static int mask_bits(const Mask a) { return _mm256_movemask_ps(a); }
+
+		static Float select(const Mask mask, const Float if_true, const Float if_false) { return _mm256_blendv_ps(if_false, if_true, mask); }
+		static Int select_int(const Mask mask, const Int if_true, const Int if_false)
+		{
+			return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(if_false), _mm256_castsi256_ps(if_true), mask));
+		}
+		// Adds one to each lane where mask is set
+		static Int increment(const Mask mask, const Int a) { return _mm256_sub_epi32(a, _mm256_castps_si256(mask)); }
+
+		static Float gather(const float* const values, const Int indices) { return _mm256_i32gather_ps(values, indices, 4); }
+		static Int gather_int(const int32_t* const values, const Int indices)
+		{
+			return _mm256_i32gather_epi32(reinterpret_cast<const int*>(values), indices, 4);
+		}
+	};
+#elif defined(CSC_SIMD_SSE2)
+	/**
+	 * @brief Operations on 4 float or int32 lanes at once, using SSE2.
+	 *
+	 * Masks are float vectors with every bit of a lane set where a comparison was true.
+	 */
+	struct SimdLanes {
+		static constexpr size_t WIDTH{ 4 };
+		typedef __m128 Float;
+		typedef __m128i Int;
+		typedef __m128 Mask;
+
+		static Float load(const float* const values) { return _mm_loadu_ps(values); }
+		static void store(float* const values, const Float a) { _mm_storeu_ps(values, a); }
+		static Float set(const float value) { return _mm_set1_ps(value); }
+		static Int set_int(const int32_t value) { return _mm_set1_epi32(value); }
+
+		static Float add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+		static Float sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+		static Float mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+		static Float div(const Float a, const Float b) { return _mm_div_ps(a, b); }
+		static Int add_int(const Int a, const Int b) { return _mm_add_epi32(a, b); }
+		static Int sub_int(const Int a, const Int b) { return _mm_sub_epi32(a, b); }
+
+		// Comparisons with a NaN lane are false
+		static Mask less(const Float a, const Float b) { return _mm_cmplt_ps(a, b); }
+		static Mask less_equal(const Float a, const Float b) { return _mm_cmple_ps(a, b); }
+		static Mask equal_int(const Int a, const Int b) { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b)); }
+		static Mask mask_and(const Mask a, const Mask b) { return _mm_and_ps(a, b); }
+		static Mask mask_or(const Mask a, const Mask b) { return _mm_or_ps(a, b); }
+		static Mask mask_not(const Mask a) { return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+		// Bit i is set if lane i of the mask is set
+		static int mask_bits(const Mask a) { return _mm_movemask_ps(a); }
+
+		static Float select(const Mask mask, const Float if_true, const Float if_false)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+		}
+		static Int select_int(const Mask mask, const Int if_true, const Int if_false)
+		{
+			return _mm_castps_si128(select(mask, _mm_castsi128_ps(if_true), _mm_castsi128_ps(if_false)));
+		}
+		// Adds one to each lane where mask is set
+		static Int increment(const Mask mask, const Int a) { return _mm_sub_epi32(a, _mm_castps_si128(mask)); }
+
+		// SSE2 has no gather instruction, each lane is loaded on its own
+		static Float gather(const float* const values, const Int indices)
+		{
+			alignas(16) int32_t lane_indices[WIDTH];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lane_indices), indices);
+			return _mm_setr_ps(values[lane_indices[0]], values[lane_indices[1]], values[lane_indices[2]], values[lane_indices[3]]);
+		}
+		static Int gather_int(const int32_t* const values, const Int indices)
+		{
+			alignas(16) int32_t lane_indices[WIDTH];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lane_indices), indices);
+			return _mm_setr_epi32(values[lane_indices[0]], values[lane_indices[1]], values[lane_indices[2]], values[lane_indices[3]]);
+		}
+	};
+#endif
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines SlotMap and SlotMapKey.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "shared_ptr.h"
+
+namespace csc {
+
+	/**
+	 * @brief Key used to address a single value in a SlotMap. A key is invalidated when its value is erased.
+	 */
+	class SlotMapKey {
+	public:
+		SlotMapKey() : _index{ UINT32_MAX }, _generation{ 0 } {}
+		SlotMapKey(uint32_t index, uint32_t generation) : _index{ index }, _generation{ generation } {}
+
+		uint32_t index() const { return _index; }
+		uint32_t generation() const { return _generation; }
+
+		bool operator==(const SlotMapKey& other) const { return _index == other._index && _generation == other._generation; }
+		bool operator!=(const SlotMapKey& other) const { return operator==(other) == false; }
+
+	private:
+		uint32_t _index;
+		uint32_t _generation;
+	};
+
+	/**
+	 * @brief A container that provides O(1) lookup by generational key and shares its contents with copies of itself.
+	 *
+	 * Slots are stored in fixed-size chunks. Copying the map only copies chunk pointers, a chunk is copied the first
+	 * time one of the maps sharing it is modified. The slot of an erased value is reused by a later insert, its new
+	 * key has a different generation so the old key stays invalid.
+	 */
+	template <typename T> class SlotMap {
+	public:
+		SlotMapKey insert(T value)
+		{
+			uint32_t slot_index;
+			if (free_head != NO_INDEX) {
+				slot_index = free_head;
+				free_head = slot(slot_index).next_free;
+			}
+			else {
+				slot_index = slot_count++;
+				if (slot_index / CHUNK_SIZE >= chunks.size()) {
+					chunks.push_back(std::make_shared<Chunk>());
+				}
+			}
+			Slot& new_slot{ mutable_slot(slot_index) };
+			new_slot.value = std::move(value);
+			new_slot.next_free = OCCUPIED;
+			_size++;
+			return SlotMapKey{ slot_index, new_slot.generation };
+		}
+
+		bool contains(const SlotMapKey key) const { return get(key) != nullptr; }
+
+		const T* get(const SlotMapKey key) const
+		{
+			if (key.index() >= slot_count) {
+				return nullptr;
+			}
+			const Slot& this_slot{ slot(key.index()) };
+			if (this_slot.next_free != OCCUPIED || this_slot.generation != key.generation()) {
+				return nullptr;
+			}
+			return &this_slot.value;
+		}
+
+		// Returns a mutable pointer to the value for key, copying its chunk first if it is shared
+		T* get_mutable(const SlotMapKey key)
+		{
+			if (contains(key) == false) {
+				return nullptr;
+			}
+			return &mutable_slot(key.index()).value;
+		}
+
+		bool erase(const SlotMapKey key)
+		{
+			if (contains(key) == false) {
+				return false;
+			}
+			Slot& this_slot{ mutable_slot(key.index()) };
+			this_slot.value = T{};
+			this_slot.generation++;
+			this_slot.next_free = free_head;
+			free_head = key.index();
+			_size--;
+			return true;
+		}
+
+		void clear()
+		{
+			chunks.clear();
+			slot_count = 0;
+			free_head = NO_INDEX;
+			_size = 0;
+		}
+
+		size_t size() const { return _size; }
+		bool empty() const { return _size == 0; }
+
+	private:
+		static constexpr size_t CHUNK_SIZE{ 64 };
+		static constexpr uint32_t NO_INDEX{ UINT32_MAX };
+		static constexpr uint32_t OCCUPIED{ UINT32_MAX - 1 };
+
+		struct Slot {
+			T value{};
+			uint32_t generation{ 0 };
+			// Index of the next free slot while free, OCCUPIED while holding a value
+			uint32_t next_free{ NO_INDEX };
+		};
+		typedef std::array<Slot, CHUNK_SIZE> Chunk;
+
+		const Slot& slot(const uint32_t index) const { return (*chunks[index / CHUNK_SIZE])[index % CHUNK_SIZE]; }
+
+		Slot& mutable_slot(const uint32_t index)
+		{
+			std::shared_ptr<Chunk>& chunk{ chunks[index / CHUNK_SIZE] };
+			if (is_sole_owner(chunk) == false) {
+				// Shared with another map, this map gets its own copy
+				chunk = std::make_shared<Chunk>(*chunk);
+			}
+			return (*chunk)[index % CHUNK_SIZE];
+		}
+
+		std::vector<std::shared_ptr<Chunk>> chunks;
+		// Number of slots ever used, slots past this have never held a value
+		uint32_t slot_count{ 0 };
+		uint32_t free_head{ NO_INDEX };
+		size_t _size{ 0 };
+	};
+}
@@ -0,0 +1,2071 @@
+#include "benchmark.h"
+
+// Only built with CSE_BENCHMARKS, see BENCHMARKS in the makefile
+#ifdef CSE_BENCHMARKS
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/tokenizer.hpp>
+
+#include "shader_core/config.h"
+#include "shader_core/lerp.h"
+#include "shader_core/search.h"
+#include "shader_core/simd.h"
+#include "shader_core/vector.h"
+#include "shader_graph/bake.h"
+#include "shader_graph/curves.h"
+#include "shader_graph/graph.h"
+#include "shader_graph/library.h"
+#include "shader_graph/node.h"
+#include "shader_graph/node_id.h"
+#include "shader_graph/node_schema.h"
+#include "shader_graph/node_type.h"
+#include "shader_graph/ramp.h"
+#include "shader_graph/serialize.h"
+#include "shader_graph/slot.h"
+#include "shader_graph/slot_id.h"
+
+#include "alt_slot_names.h"
+#include "event.h"
+#include "heap_counter.h"
+#include "undo.h"
+
+typedef std::chrono::steady_clock BenchmarkClock;
+
+static double elapsed_ms(const BenchmarkClock::time_point begin)
+{
+	const std::chrono::duration<double, std::milli> elapsed{ BenchmarkClock::now() - begin };
+	return elapsed.count();
+}
+
+// Fastest of passes runs of run in ms, the slower runs are the ones this machine spent partly on other work
+template <typename F> static double best_ms(const size_t passes, const F& run)
+{
+	double result{ std::numeric_limits<double>::max() };
+	for (size_t pass = 0; pass < passes; pass++) {
+		const BenchmarkClock::time_point begin{ BenchmarkClock::now() };
+		run();
+		result = std::min(result, elapsed_ms(begin));
+	}
+	return result;
+}
+
+static void write_row(std::stringstream& out_stream, const char* const label, const std::vector<double>& times)
+{
+	out_stream << std::left << std::setw(10) << label << std::right;
+	for (const double this_time : times) {
+		out_stream << std::setw(12) << this_time;
+	}
+	out_stream << std::endl;
+}
+
+std::string cse::Benchmark::graph_storage()
+{
+	constexpr size_t ITERATE_PASSES{ 10 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Graph node storage, times in ms" << std::endl;
+
+	for (const size_t node_count : { static_cast<size_t>(10000), static_cast<size_t>(100000) }) {
+		out_stream << std::endl << "Nodes: " << node_count << std::endl;
+		out_stream << std::left << std::setw(10) << "" << std::right;
+		out_stream << std::setw(12) << "add" << std::setw(12) << "get" << std::setw(12) << "iterate" << std::setw(12) << "remove" << std::endl;
+
+		std::vector<csg::NodeId> ids;
+		ids.reserve(node_count);
+
+		// Previous layout of csg::Graph, a list for draw order and a map for lookup
+		{
+			std::list<std::shared_ptr<csg::Node>> node_list;
+			std::map<csg::NodeId, std::shared_ptr<csg::Node>> node_map;
+			std::vector<double> times;
+
+			auto begin{ BenchmarkClock::now() };
+			for (size_t i = 0; i < node_count; i++) {
+				const std::shared_ptr<csg::Node> new_node{ std::make_shared<csg::Node>(csg::NodeType::VALUE, csc::Int2{ static_cast<int>(i), 0 }) };
+				node_list.push_front(new_node);
+				node_map[new_node->id()] = new_node;
+				ids.push_back(new_node->id());
+			}
+			times.push_back(elapsed_ms(begin));
+
+			std::shuffle(ids.begin(), ids.end(), std::mt19937{ 1 });
+
+			begin = BenchmarkClock::now();
+			long long position_sum{ 0 };
+			for (const csg::NodeId this_id : ids) {
+				const auto iter{ node_map.find(this_id) };
+				if (iter != node_map.end()) {
+					position_sum += iter->second->position.x;
+				}
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			for (size_t pass = 0; pass < ITERATE_PASSES; pass++) {
+				for (const auto& this_node : node_list) {
+					position_sum += this_node->position.y;
+				}
+			}
+			times.push_back(elapsed_ms(begin) / ITERATE_PASSES);
+
+			const std::set<csg::NodeId> to_remove{ ids.begin(), ids.begin() + node_count / 2 };
+			begin = BenchmarkClock::now();
+			for (auto iter{ node_list.begin() }; iter != node_list.end(); ) {
+				if (to_remove.count((*iter)->id())) {
+					node_map.erase((*iter)->id());
+					iter = node_list.erase(iter);
+				}
+				else {
+					++iter;
+				}
+			}
+			times.push_back(elapsed_ms(begin));
+
+			write_row(out_stream, "list+map", times);
+			if (position_sum == -1) {
+				// Only here so the loops above can not be optimized away
+				out_stream << std::endl;
+			}
+		}
+
+		// Current csg::Graph
+		{
+			csg::Graph graph{ csg::GraphType::EMPTY };
+			std::vector<double> times;
+			ids.clear();
+
+			auto begin{ BenchmarkClock::now() };
+			for (size_t i = 0; i < node_count; i++) {
+				ids.push_back(graph.add(csg::NodeType::VALUE, csc::Int2{ static_cast<int>(i), 0 }));
+			}
+			times.push_back(elapsed_ms(begin));
+
+			std::shuffle(ids.begin(), ids.end(), std::mt19937{ 1 });
+
+			begin = BenchmarkClock::now();
+			long long position_sum{ 0 };
+			for (const csg::NodeId this_id : ids) {
+				const auto this_node{ graph.get(this_id) };
+				if (this_node) {
+					position_sum += this_node->position.x;
+				}
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			for (size_t pass = 0; pass < ITERATE_PASSES; pass++) {
+				for (const auto& this_node : graph.nodes()) {
+					position_sum += this_node->position.y;
+				}
+			}
+			times.push_back(elapsed_ms(begin) / ITERATE_PASSES);
+
+			const std::set<csg::NodeId> to_remove{ ids.begin(), ids.begin() + node_count / 2 };
+			begin = BenchmarkClock::now();
+			graph.remove(to_remove);
+			times.push_back(elapsed_ms(begin));
+
+			write_row(out_stream, "Graph", times);
+			if (position_sum == -1) {
+				out_stream << std::endl;
+			}
+		}
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::graph_connections()
+{
+	constexpr size_t ITERATE_PASSES{ 10 };
+	// Output slot and one float input of a math node
+	constexpr size_t SOURCE_INDEX{ 0 };
+	constexpr size_t DEST_INDEX{ 2 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Graph connections, times in ms" << std::endl;
+
+	for (const size_t node_count : { static_cast<size_t>(1000), static_cast<size_t>(10000) }) {
+		out_stream << std::endl << "Connections: " << node_count - 1 << std::endl;
+		out_stream << std::left << std::setw(10) << "" << std::right;
+		out_stream << std::setw(12) << "connect" << std::setw(12) << "lookup" << std::setw(12) << "iterate" << std::setw(12) << "disconnect" << std::endl;
+
+		csg::Graph graph{ csg::GraphType::EMPTY };
+		std::vector<csg::NodeId> ids;
+		ids.reserve(node_count);
+		for (size_t i = 0; i < node_count; i++) {
+			ids.push_back(graph.add(csg::NodeType::MATH, csc::Int2{ static_cast<int>(i), 0 }));
+		}
+
+		// Previous layout of csg::Graph, a list searched linearly by dest
+		{
+			std::list<csg::Connection> connections;
+			std::vector<double> times;
+
+			auto begin{ BenchmarkClock::now() };
+			for (size_t i = 1; i < node_count; i++) {
+				const csg::SlotId dest{ ids[i], DEST_INDEX };
+				for (auto iter{ connections.begin() }; iter != connections.end(); iter++) {
+					if (iter->dest() == dest) {
+						connections.erase(iter);
+						break;
+					}
+				}
+				connections.push_back(csg::Connection{ csg::SlotId{ ids[i - 1], SOURCE_INDEX }, dest });
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			size_t found_count{ 0 };
+			for (size_t i = 1; i < node_count; i++) {
+				const csg::SlotId dest{ ids[i], DEST_INDEX };
+				for (const csg::Connection& this_conn : connections) {
+					if (this_conn.dest() == dest) {
+						found_count++;
+						break;
+					}
+				}
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			for (size_t pass = 0; pass < ITERATE_PASSES; pass++) {
+				// The old accessor returned the list by value
+				const std::list<csg::Connection> connections_copy{ connections };
+				for (const csg::Connection& this_conn : connections_copy) {
+					found_count += this_conn.dest().index();
+				}
+			}
+			times.push_back(elapsed_ms(begin) / ITERATE_PASSES);
+
+			// Disconnect newest first so the list search has to walk the whole list
+			begin = BenchmarkClock::now();
+			for (size_t i = node_count - 1; i > 0; i--) {
+				const csg::SlotId dest{ ids[i], DEST_INDEX };
+				for (auto iter{ connections.begin() }; iter != connections.end(); iter++) {
+					if (iter->dest() == dest) {
+						connections.erase(iter);
+						break;
+					}
+				}
+			}
+			times.push_back(elapsed_ms(begin));
+
+			write_row(out_stream, "list", times);
+			if (found_count == 0) {
+				out_stream << std::endl;
+			}
+		}
+
+		// Current csg::Graph
+		{
+			std::vector<double> times;
+
+			auto begin{ BenchmarkClock::now() };
+			for (size_t i = 1; i < node_count; i++) {
+				graph.add_connection(csg::SlotId{ ids[i - 1], SOURCE_INDEX }, csg::SlotId{ ids[i], DEST_INDEX });
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			size_t found_count{ 0 };
+			for (size_t i = 1; i < node_count; i++) {
+				if (graph.connection_to(csg::SlotId{ ids[i], DEST_INDEX })) {
+					found_count++;
+				}
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			for (size_t pass = 0; pass < ITERATE_PASSES; pass++) {
+				for (const csg::Connection& this_conn : graph.connections()) {
+					found_count += this_conn.dest().index();
+				}
+			}
+			times.push_back(elapsed_ms(begin) / ITERATE_PASSES);
+
+			begin = BenchmarkClock::now();
+			for (size_t i = node_count - 1; i > 0; i--) {
+				graph.remove_connection(csg::SlotId{ ids[i], DEST_INDEX });
+			}
+			times.push_back(elapsed_ms(begin));
+
+			write_row(out_stream, "Graph", times);
+			if (found_count == 0) {
+				out_stream << std::endl;
+			}
+		}
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::undo_snapshot()
+{
+	constexpr size_t REPEAT_COUNT{ 50 };
+	// Output slot and one float input of a math node
+	constexpr size_t SOURCE_INDEX{ 0 };
+	constexpr size_t DEST_INDEX{ 2 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(4);
+	out_stream << "Undo snapshots, average time per operation in ms" << std::endl;
+	out_stream << std::endl << std::left << std::setw(10) << "Nodes" << std::right;
+	out_stream << std::setw(12) << "deep copy" << std::setw(12) << "copy" << std::setw(12) << "edit" << std::setw(12) << "push undo" << std::endl;
+
+	for (const size_t node_count : { static_cast<size_t>(500), static_cast<size_t>(5000), static_cast<size_t>(50000) }) {
+		csg::Graph graph{ csg::GraphType::MATERIAL };
+		std::vector<csg::NodeId> ids;
+		ids.reserve(node_count);
+		for (size_t i = 0; i < node_count; i++) {
+			ids.push_back(graph.add(csg::NodeType::MATH, csc::Int2{ static_cast<int>(i), 0 }));
+			if (i > 0) {
+				graph.add_connection(csg::SlotId{ ids[i - 1], SOURCE_INDEX }, csg::SlotId{ ids[i], DEST_INDEX });
+			}
+		}
+		std::mt19937 random{ 1 };
+		std::vector<double> times;
+
+		// What copying a graph used to cost, every node copied into a new allocation
+		auto begin{ BenchmarkClock::now() };
+		for (size_t i = 0; i < REPEAT_COUNT; i++) {
+			std::vector<std::shared_ptr<csg::Node>> node_copies;
+			node_copies.reserve(graph.nodes().size());
+			for (const auto& this_node : graph.nodes()) {
+				node_copies.push_back(std::make_shared<csg::Node>(*this_node));
+			}
+		}
+		times.push_back(elapsed_ms(begin) / REPEAT_COUNT);
+
+		std::vector<csg::Graph> snapshots;
+		snapshots.reserve(REPEAT_COUNT);
+		begin = BenchmarkClock::now();
+		for (size_t i = 0; i < REPEAT_COUNT; i++) {
+			snapshots.push_back(graph);
+		}
+		times.push_back(elapsed_ms(begin) / REPEAT_COUNT);
+
+		// Each edit touches a graph that shares everything with a snapshot, so it pays for copy-on-write
+		begin = BenchmarkClock::now();
+		for (size_t i = 0; i < REPEAT_COUNT; i++) {
+			snapshots[i].set_float(csg::SlotId{ ids[random() % ids.size()], DEST_INDEX + 1 }, static_cast<float>(i + 1));
+		}
+		times.push_back(elapsed_ms(begin) / REPEAT_COUNT);
+
+		UndoStack undo_stack{ graph };
+		double push_time{ 0.0 };
+		for (size_t i = 0; i < REPEAT_COUNT; i++) {
+			graph.set_float(csg::SlotId{ ids[random() % ids.size()], DEST_INDEX + 1 }, static_cast<float>(i + 1));
+			begin = BenchmarkClock::now();
+			undo_stack.push_undo(graph);
+			push_time += elapsed_ms(begin);
+		}
+		times.push_back(push_time / REPEAT_COUNT);
+
+		out_stream << std::left << std::setw(10) << node_count << std::right;
+		for (const double this_time : times) {
+			out_stream << std::setw(12) << this_time;
+		}
+		out_stream << std::endl;
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::node_creation()
+{
+	constexpr size_t REPEAT_COUNT{ 2000 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Creating " << REPEAT_COUNT << " nodes of every type, times in ms" << std::endl;
+	out_stream << std::left << std::setw(10) << "" << std::right;
+	out_stream << std::setw(12) << "time" << std::setw(12) << "KiB" << std::endl;
+
+	// Before NodeSchema, every node held its own vector of Slot including names and defaults
+	{
+		size_t total_bytes{ 0 };
+		const auto begin{ BenchmarkClock::now() };
+		for (const csg::NodeType this_type : csg::NodeTypeList{}) {
+			const csg::NodeSchema& schema{ csg::NodeSchema::from(this_type) };
+			std::vector<std::vector<csg::Slot>> slot_vectors;
+			slot_vectors.reserve(REPEAT_COUNT);
+			for (size_t i = 0; i < REPEAT_COUNT; i++) {
+				slot_vectors.push_back(schema.slots());
+			}
+			total_bytes += REPEAT_COUNT * schema.slots().size() * sizeof(csg::Slot);
+		}
+		const double time{ elapsed_ms(begin) };
+		out_stream << std::left << std::setw(10) << "slots" << std::right;
+		out_stream << std::setw(12) << time << std::setw(12) << total_bytes / 1024 << std::endl;
+	}
+
+	{
+		size_t total_bytes{ 0 };
+		const auto begin{ BenchmarkClock::now() };
+		for (const csg::NodeType this_type : csg::NodeTypeList{}) {
+			std::vector<csg::Node> nodes;
+			nodes.reserve(REPEAT_COUNT);
+			for (size_t i = 0; i < REPEAT_COUNT; i++) {
+				nodes.push_back(csg::Node{ this_type, csc::Int2{ static_cast<int>(i), 0 } });
+			}
+			total_bytes += REPEAT_COUNT * csg::NodeSchema::from(this_type).default_values().size() * sizeof(csg::SlotValue);
+		}
+		const double time{ elapsed_ms(begin) };
+		out_stream << std::left << std::setw(10) << "values" << std::right;
+		out_stream << std::setw(12) << time << std::setw(12) << total_bytes / 1024 << std::endl;
+	}
+
+	return out_stream.str();
+}
+
+// Reads every slot value the way a frame of the node graph and parameter editor does
+// Returns a sum of some of the values so the reads can not be optimized out
+static float read_slots_by_copy(const csg::Graph& graph, const csg::SlotId selected_slot)
+{
+	float result{ 0.0f };
+	for (const auto& this_node : graph.nodes()) {
+		for (size_t i = 0; i < this_node->slot_count(); i++) {
+			result += static_cast<float>(cse::get_alt_slot_name(*this_node, this_node->slot(i)->disp_name()).size());
+			const boost::optional<csg::SlotValue> opt_value{ this_node->slot_value(i) };
+			if (opt_value) {
+				if (const auto opt_float{ opt_value->as<csg::FloatSlotValue>() }) {
+					result += opt_float->get();
+				}
+				else if (const auto opt_ramp{ opt_value->as<csg::ColorRampSlotValue>() }) {
+					result += static_cast<float>(opt_ramp->get().size());
+				}
+			}
+		}
+	}
+	if (const auto opt_ramp{ graph.get_slot_value_as<csg::ColorRampSlotValue>(selected_slot) }) {
+		result += static_cast<float>(opt_ramp->get().size());
+	}
+	return result;
+}
+
+static float read_slots_by_pointer(const csg::Graph& graph, const csg::SlotId selected_slot)
+{
+	float result{ 0.0f };
+	for (const auto& this_node : graph.nodes()) {
+		for (size_t i = 0; i < this_node->slot_count(); i++) {
+			result += static_cast<float>(cse::get_alt_slot_name(*this_node, this_node->slot(i)->disp_name()).size());
+			const csg::SlotValue* const value_ptr{ this_node->slot_value_ptr(i) };
+			if (value_ptr) {
+				if (const csg::FloatSlotValue* const float_ptr{ value_ptr->as_ptr<csg::FloatSlotValue>() }) {
+					result += float_ptr->get();
+				}
+				else if (const csg::ColorRampSlotValue* const ramp_ptr{ value_ptr->as_ptr<csg::ColorRampSlotValue>() }) {
+					result += static_cast<float>(ramp_ptr->get().size());
+				}
+			}
+		}
+	}
+	if (const csg::ColorRampSlotValue* const ramp_ptr{ graph.get_slot_value_as_ptr<csg::ColorRampSlotValue>(selected_slot) }) {
+		result += static_cast<float>(ramp_ptr->get().size());
+	}
+	return result;
+}
+
+std::string cse::Benchmark::slot_access()
+{
+	constexpr size_t NODES_PER_TYPE{ 10 };
+	constexpr size_t FRAME_COUNT{ 200 };
+
+	csg::Graph graph{ csg::GraphType::MATERIAL };
+	boost::optional<csg::SlotId> ramp_slot;
+	for (size_t i = 0; i < NODES_PER_TYPE; i++) {
+		for (const csg::NodeType this_type : csg::NodeTypeList{}) {
+			if (this_type == csg::NodeType::MATERIAL_OUTPUT) {
+				continue;
+			}
+			const csg::NodeId new_id{ graph.add(this_type, csc::Int2{ static_cast<int>(i), 0 }) };
+			if (this_type == csg::NodeType::COLOR_RAMP && ramp_slot.has_value() == false) {
+				const boost::optional<size_t> opt_index{ graph.get(new_id)->slot_index(csg::SlotDirection::INPUT, "ramp") };
+				if (opt_index) {
+					ramp_slot = csg::SlotId{ new_id, *opt_index };
+				}
+			}
+		}
+	}
+	const csg::SlotId selected_slot{ ramp_slot ? *ramp_slot : csg::SlotId{ graph.nodes().begin()->get()->id(), 0 } };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Reading every slot of " << graph.nodes().size() << " nodes, per frame" << std::endl;
+	out_stream << std::left << std::setw(10) << "" << std::right;
+	out_stream << std::setw(12) << "ms" << std::setw(12) << "allocs" << std::endl;
+
+	float checksum{ 0.0f };
+	const auto run_frames = [&](const char* const label, float (*const read_slots)(const csg::Graph&, csg::SlotId)) {
+		const uint64_t allocations_begin{ HeapCounter::allocations() };
+		const auto begin{ BenchmarkClock::now() };
+		for (size_t i = 0; i < FRAME_COUNT; i++) {
+			checksum += read_slots(graph, selected_slot);
+		}
+		const double time{ elapsed_ms(begin) / FRAME_COUNT };
+		const uint64_t allocations{ (HeapCounter::allocations() - allocations_begin) / FRAME_COUNT };
+		out_stream << std::left << std::setw(10) << label << std::right << std::setw(12) << time;
+		if (HeapCounter::active()) {
+			out_stream << std::setw(12) << allocations << std::endl;
+		}
+		else {
+			out_stream << std::setw(12) << "n/a" << std::endl;
+		}
+	};
+	run_frames("copy", read_slots_by_copy);
+	run_frames("pointer", read_slots_by_pointer);
+
+	if (HeapCounter::active() == false) {
+		out_stream << "Allocations are only counted in the editor_alloc_count build." << std::endl;
+	}
+	out_stream << "Checksum: " << checksum << std::endl;
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::slot_edit()
+{
+	constexpr size_t FRAME_COUNT{ 1000 };
+
+	csg::Graph graph{ csg::GraphType::MATERIAL };
+	const csg::NodeId math_id{ graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+	const csg::NodeId ramp_id{ graph.add(csg::NodeType::COLOR_RAMP, csc::Int2{ 0, 0 }) };
+	const csg::SlotId float_slot{ math_id, *graph.get(math_id)->slot_index(csg::SlotDirection::INPUT, "value1") };
+	const csg::SlotId ramp_slot{ ramp_id, *graph.get(ramp_id)->slot_index(csg::SlotDirection::INPUT, "ramp") };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(4);
+	out_stream << "Editing one slot every frame, per frame" << std::endl;
+	out_stream << std::left << std::setw(14) << "" << std::right;
+	out_stream << std::setw(12) << "ms" << std::setw(12) << "allocs" << std::endl;
+
+	const auto write_result = [&](const char* const label, const double time, const uint64_t allocations) {
+		out_stream << std::left << std::setw(14) << label << std::right << std::setw(12) << time;
+		if (HeapCounter::active()) {
+			out_stream << std::setw(12) << allocations << std::endl;
+		}
+		else {
+			out_stream << std::setw(12) << "n/a" << std::endl;
+		}
+	};
+
+	// What the parameter editor and main window do each frame while a float is being changed
+	{
+		const uint64_t allocations_begin{ HeapCounter::allocations() };
+		const auto begin{ BenchmarkClock::now() };
+		for (size_t i = 0; i < FRAME_COUNT; i++) {
+			const csg::FloatSlotValue* const float_value{ graph.get_slot_value_as_ptr<csg::FloatSlotValue>(float_slot) };
+			InterfaceEventArray events;
+			events.push(InterfaceEvent{ SetSlotFloatDetails{ float_slot, float_value->get() + 0.01f } });
+			for (const InterfaceEvent& this_event : events) {
+				const boost::optional<SetSlotFloatDetails> details{ this_event.details_as<SetSlotFloatDetails>() };
+				graph.set_float(details->slot_id, details->new_value);
+			}
+		}
+		write_result("float", elapsed_ms(begin) / FRAME_COUNT, (HeapCounter::allocations() - allocations_begin) / FRAME_COUNT);
+	}
+
+	// Dragging a ramp point builds a new ramp each frame, which is then moved into the graph
+	{
+		const uint64_t allocations_begin{ HeapCounter::allocations() };
+		const auto begin{ BenchmarkClock::now() };
+		for (size_t i = 0; i < FRAME_COUNT; i++) {
+			const csg::ColorRampSlotValue* const ramp_value{ graph.get_slot_value_as_ptr<csg::ColorRampSlotValue>(ramp_slot) };
+			csg::ColorRamp new_ramp{ ramp_value->get() };
+			csg::ColorRampPoint new_point{ new_ramp.get(0) };
+			new_point.pos = static_cast<float>(i % 100) / 200.0f;
+			new_ramp.set(0, new_point);
+			graph.set_color_ramp(ramp_slot, std::move(new_ramp));
+		}
+		write_result("ramp", elapsed_ms(begin) / FRAME_COUNT, (HeapCounter::allocations() - allocations_begin) / FRAME_COUNT);
+	}
+
+	// An undo snapshot shares the node, so the next edit has to copy it first
+	{
+		std::vector<csg::Graph> snapshots;
+		snapshots.reserve(FRAME_COUNT);
+		uint64_t allocations{ 0 };
+		double time{ 0.0 };
+		for (size_t i = 0; i < FRAME_COUNT; i++) {
+			snapshots.push_back(graph);
+			const uint64_t allocations_begin{ HeapCounter::allocations() };
+			const auto begin{ BenchmarkClock::now() };
+			graph.set_float(float_slot, static_cast<float>(i % 2));
+			time += elapsed_ms(begin);
+			allocations += HeapCounter::allocations() - allocations_begin;
+		}
+		write_result("after snapshot", time / FRAME_COUNT, allocations / FRAME_COUNT);
+	}
+
+	if (HeapCounter::active() == false) {
+		out_stream << "Allocations are only counted in the editor_alloc_count build." << std::endl;
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::graph_transaction()
+{
+	// Output slot, operation and two float inputs of a math node
+	constexpr size_t SOURCE_INDEX{ 0 };
+	constexpr size_t TYPE_INDEX{ 1 };
+	constexpr size_t DEST_INDEX{ 2 };
+	constexpr size_t VALUE_INDEX{ 3 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Graph edits one at a time and in a transaction, times in ms" << std::endl;
+
+	for (const size_t node_count : { static_cast<size_t>(1000), static_cast<size_t>(10000) }) {
+		out_stream << std::endl << "Nodes: " << node_count << std::endl;
+		out_stream << std::left << std::setw(10) << "" << std::right;
+		out_stream << std::setw(12) << "paste" << std::setw(12) << "connect" << std::setw(12) << "set" << std::setw(12) << "remove" << std::endl;
+
+		// Each edit applied directly to the graph
+		{
+			csg::Graph graph{ csg::GraphType::EMPTY };
+			std::vector<csg::NodeId> ids;
+			ids.reserve(node_count);
+			std::vector<double> times;
+
+			// Pasting creates each node and then restores its values
+			auto begin{ BenchmarkClock::now() };
+			for (size_t i = 0; i < node_count; i++) {
+				ids.push_back(graph.add(csg::NodeType::MATH, csc::Int2{ static_cast<int>(i), 0 }));
+				graph.set_enum(csg::SlotId{ ids.back(), TYPE_INDEX }, 2);
+				graph.set_float(csg::SlotId{ ids.back(), DEST_INDEX }, 1.0f);
+				graph.set_float(csg::SlotId{ ids.back(), VALUE_INDEX }, 2.0f);
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			for (size_t i = 1; i < node_count; i++) {
+				graph.add_connection(csg::SlotId{ ids[i - 1], SOURCE_INDEX }, csg::SlotId{ ids[i], DEST_INDEX });
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			for (size_t i = 0; i < node_count; i++) {
+				graph.set_float(csg::SlotId{ ids[i], VALUE_INDEX }, static_cast<float>(i));
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			for (size_t i = 0; i < node_count; i += 2) {
+				graph.remove(std::set<csg::NodeId>{ ids[i] });
+			}
+			times.push_back(elapsed_ms(begin));
+
+			write_row(out_stream, "single", times);
+		}
+
+		// The same edits queued and committed together
+		{
+			csg::Graph graph{ csg::GraphType::EMPTY };
+			std::vector<csg::NodeId> ids;
+			ids.reserve(node_count);
+			std::vector<double> times;
+
+			auto begin{ BenchmarkClock::now() };
+			{
+				csg::Graph::Transaction transaction{ graph };
+				for (size_t i = 0; i < node_count; i++) {
+					ids.push_back(transaction.add(csg::NodeType::MATH, csc::Int2{ static_cast<int>(i), 0 }));
+					transaction.set_enum(csg::SlotId{ ids.back(), TYPE_INDEX }, 2);
+					transaction.set_float(csg::SlotId{ ids.back(), DEST_INDEX }, 1.0f);
+					transaction.set_float(csg::SlotId{ ids.back(), VALUE_INDEX }, 2.0f);
+				}
+				transaction.commit();
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			{
+				csg::Graph::Transaction transaction{ graph };
+				for (size_t i = 1; i < node_count; i++) {
+					transaction.add_connection(csg::SlotId{ ids[i - 1], SOURCE_INDEX }, csg::SlotId{ ids[i], DEST_INDEX });
+				}
+				transaction.commit();
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			{
+				csg::Graph::Transaction transaction{ graph };
+				for (size_t i = 0; i < node_count; i++) {
+					transaction.set_float(csg::SlotId{ ids[i], VALUE_INDEX }, static_cast<float>(i));
+				}
+				transaction.commit();
+			}
+			times.push_back(elapsed_ms(begin));
+
+			begin = BenchmarkClock::now();
+			{
+				csg::Graph::Transaction transaction{ graph };
+				for (size_t i = 0; i < node_count; i += 2) {
+					transaction.remove(ids[i]);
+				}
+				transaction.commit();
+			}
+			times.push_back(elapsed_ms(begin));
+
+			write_row(out_stream, "batched", times);
+
+			// The last edit removes a node that is already gone, so the whole transaction is rejected
+			csg::Graph::Transaction transaction{ graph };
+			for (size_t i = 1; i < node_count; i += 2) {
+				transaction.set_float(csg::SlotId{ ids[i], VALUE_INDEX }, 0.5f);
+			}
+			transaction.remove(ids[0]);
+			const size_t edit_count{ transaction.size() };
+			begin = BenchmarkClock::now();
+			transaction.commit();
+			out_stream << "Rejecting " << edit_count << " edits: " << elapsed_ms(begin) << std::endl;
+		}
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::graph_journal()
+{
+	constexpr size_t NODE_COUNT{ 1000 };
+	constexpr size_t EDIT_COUNT{ 100000 };
+	constexpr size_t SNAPSHOT_COUNT{ 1000 };
+	constexpr size_t RECENT_COUNT{ 100 };
+	constexpr size_t VALUE_INDEX{ 3 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Graph change journal, times in ms" << std::endl;
+	out_stream << EDIT_COUNT << " edits, then " << SNAPSHOT_COUNT << " undo snapshots each followed by an edit" << std::endl;
+	out_stream << std::left << std::setw(10) << "" << std::right;
+	out_stream << std::setw(12) << "edits" << std::setw(12) << "snapshots" << std::endl;
+
+	for (const bool journal_enabled : { false, true }) {
+		csg::Graph graph{ csg::GraphType::EMPTY };
+		graph.set_journal_enabled(journal_enabled);
+		std::vector<csg::NodeId> ids;
+		ids.reserve(NODE_COUNT);
+		for (size_t i = 0; i < NODE_COUNT; i++) {
+			ids.push_back(graph.add(csg::NodeType::MATH, csc::Int2{ static_cast<int>(i), 0 }));
+		}
+		std::vector<double> times;
+
+		auto begin{ BenchmarkClock::now() };
+		for (size_t i = 0; i < EDIT_COUNT; i++) {
+			graph.set_float(csg::SlotId{ ids[i % NODE_COUNT], VALUE_INDEX }, static_cast<float>(i));
+		}
+		times.push_back(elapsed_ms(begin));
+
+		std::vector<csg::Graph> snapshots;
+		snapshots.reserve(SNAPSHOT_COUNT);
+		begin = BenchmarkClock::now();
+		for (size_t i = 0; i < SNAPSHOT_COUNT; i++) {
+			snapshots.push_back(graph);
+			graph.set_float(csg::SlotId{ ids[i % NODE_COUNT], VALUE_INDEX }, -static_cast<float>(i));
+		}
+		times.push_back(elapsed_ms(begin));
+
+		write_row(out_stream, journal_enabled ? "journal" : "none", times);
+
+		if (journal_enabled) {
+			const csg::GraphJournal& journal{ *graph.journal() };
+			// A consumer that keeps up reads a few changes each frame, one that fell behind reads everything retained
+			const uint64_t recent_version{ (*journal.changes_since(journal.oldest_version()))[journal.size() - RECENT_COUNT - 1].version() };
+			begin = BenchmarkClock::now();
+			const size_t recent_count{ journal.changes_since(recent_version)->size() };
+			const double recent_time{ elapsed_ms(begin) };
+			begin = BenchmarkClock::now();
+			const size_t all_count{ journal.changes_since(journal.oldest_version())->size() };
+			const double all_time{ elapsed_ms(begin) };
+			out_stream << "Read " << recent_count << " recent changes: " << recent_time << std::endl;
+			out_stream << "Read all " << all_count << " retained changes: " << all_time << std::endl;
+		}
+	}
+
+	return out_stream.str();
+}
+
+// A re-creation of the token handling of the previous deserializer, not that code itself
+// Every token is copied into a std::string, and every number is read through a std::stringstream
+static size_t read_tokens_by_stream(const std::string& graph_string)
+{
+	size_t result{ 0 };
+	const boost::char_separator<char> sep{ "|" };
+	const boost::tokenizer<boost::char_separator<char>> tokenizer{ graph_string, sep };
+	for (const std::string& this_token : tokenizer) {
+		const boost::char_separator<char> value_sep{ "," };
+		const boost::tokenizer<boost::char_separator<char>> value_tokenizer{ this_token, value_sep };
+		for (const std::string& this_value : value_tokenizer) {
+			std::stringstream stream{ this_value };
+			float value{ 0.0f };
+			stream >> value;
+			result += (value != 0.0f) ? 1 : 0;
+		}
+	}
+	return result;
+}
+
+// A chain of every node type with randomized positions and float values
+static csg::Graph make_serialize_graph(const size_t node_count, std::mt19937& generator)
+{
+	std::vector<csg::NodeType> node_types;
+	for (const csg::NodeType this_type : csg::NodeTypeList{}) {
+		if (this_type != csg::NodeType::MATERIAL_OUTPUT) {
+			node_types.push_back(this_type);
+		}
+	}
+
+	csg::Graph graph{ csg::GraphType::EMPTY };
+	std::uniform_int_distribution<int> position_dist{ -5000, 5000 };
+	std::uniform_real_distribution<float> value_dist{ 0.0f, 1.0f };
+	boost::optional<csg::NodeId> previous_id;
+	for (size_t i = 0; i < node_count; i++) {
+		const csg::NodeType type{ node_types[i % node_types.size()] };
+		const csg::NodeId id{ graph.add(type, csc::Int2{ position_dist(generator), position_dist(generator) }) };
+		const std::vector<csg::Slot>& slots{ csg::NodeSchema::from(type).slots() };
+		for (size_t slot_index = 0; slot_index < slots.size(); slot_index++) {
+			if (slots[slot_index].type() == csg::SlotType::FLOAT) {
+				graph.set_float(csg::SlotId{ id, slot_index }, value_dist(generator));
+			}
+		}
+		if (previous_id) {
+			graph.add_connection(csg::SlotId{ *previous_id, 0 }, csg::SlotId{ id, 0 });
+		}
+		previous_id = id;
+	}
+	return graph;
+}
+
+// A re-creation of how the previous serializer formatted floats, not that code itself, a new stream for every value
+static size_t write_floats_by_stream(const csg::Graph& graph)
+{
+	size_t result{ 0 };
+	for (const auto& node : graph.nodes()) {
+		for (size_t i = 0; i < node->slot_count(); i++) {
+			if (const csg::FloatSlotValue* const float_value{ node->slot_value_as_ptr<csg::FloatSlotValue>(i) }) {
+				std::stringstream stream;
+				stream << std::fixed << std::setprecision(SERIALIZED_GRAPH_PRECISION) << float_value->get();
+				result += stream.str().size();
+			}
+		}
+	}
+	return result;
+}
+
+std::string cse::Benchmark::serialize()
+{
+	constexpr size_t PASSES{ 5 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Graph serialization, times in ms" << std::endl;
+	out_stream << "floats: a re-creation of the previous float formatting, each value through its own std::stringstream" << std::endl;
+	out_stream << "        It writes no graph, so it is only the part of the previous serializer that was replaced" << std::endl;
+	out_stream << "serialize: serialize_graph, writing the full graph" << std::endl;
+	out_stream << std::left << std::setw(10) << "Nodes" << std::right;
+	out_stream << std::setw(12) << "MB" << std::setw(12) << "floats" << std::setw(12) << "serialize" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	for (const size_t node_count : { static_cast<size_t>(100), static_cast<size_t>(1000), static_cast<size_t>(10000) }) {
+		const csg::Graph graph{ make_serialize_graph(node_count, generator) };
+
+		size_t floats_size{ 0 };
+		size_t output_size{ 0 };
+		const double floats_ms{ best_ms(PASSES, [&]() { floats_size = write_floats_by_stream(graph); }) };
+		const double serialize_ms{ best_ms(PASSES, [&]() { output_size = graph.serialize().size(); }) };
+		output_size += (floats_size == 0) ? 1 : 0;
+
+		out_stream << std::left << std::setw(10) << node_count << std::right;
+		out_stream << std::setw(12) << static_cast<double>(output_size) / 1.0e6;
+		out_stream << std::setw(12) << floats_ms;
+		out_stream << std::setw(12) << serialize_ms << std::endl;
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::deserialize()
+{
+	constexpr size_t PASSES{ 3 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(1);
+	out_stream << "Graph deserialization, throughput in MB/s" << std::endl;
+	out_stream << "tokens: a re-creation of the previous token handling, tokens copied to strings and numbers read by std::stringstream" << std::endl;
+	out_stream << "        It builds no graph, so it is only the part of the previous deserializer that was replaced" << std::endl;
+	out_stream << "parse: deserialize_graph, building the full graph" << std::endl;
+	out_stream << std::left << std::setw(10) << "Nodes" << std::right;
+	out_stream << std::setw(12) << "MB" << std::setw(12) << "tokens" << std::setw(12) << "parse" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	for (const size_t node_count : { static_cast<size_t>(1000), static_cast<size_t>(10000), static_cast<size_t>(50000) }) {
+		const std::string graph_string{ make_serialize_graph(node_count, generator).serialize() };
+		const double megabytes{ static_cast<double>(graph_string.size()) / 1.0e6 };
+
+		size_t check_count{ 0 };
+		const double tokens_ms{ best_ms(PASSES, [&]() { check_count += read_tokens_by_stream(graph_string); }) };
+		const double parse_ms{ best_ms(PASSES, [&]() {
+			const boost::optional<csg::Graph> parsed{ csg::Graph::from(graph_string) };
+			check_count += parsed ? parsed->nodes().size() : 0;
+		}) };
+
+		out_stream << std::left << std::setw(10) << node_count << std::right;
+		out_stream << std::setw(12) << megabytes;
+		out_stream << std::setw(12) << megabytes / (tokens_ms / 1000.0);
+		out_stream << std::setw(12) << megabytes / (parse_ms / 1000.0) << std::endl;
+		if (check_count == 0) {
+			out_stream << "Nothing was parsed" << std::endl;
+		}
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::binary_format()
+{
+	constexpr size_t PASSES{ 3 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Text and binary graph formats, sizes in KB and times in ms" << std::endl;
+	out_stream << std::left << std::setw(10) << "" << std::right;
+	out_stream << std::setw(12) << "size" << std::setw(12) << "save" << std::setw(12) << "load" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	for (const size_t node_count : { static_cast<size_t>(1000), static_cast<size_t>(10000) }) {
+		out_stream << std::endl << "Nodes: " << node_count << std::endl;
+		const csg::Graph graph{ make_serialize_graph(node_count, generator) };
+
+		for (const bool binary : { false, true }) {
+			std::string graph_string;
+			size_t size{ 0 };
+			const double save_ms{ best_ms(PASSES, [&]() { graph_string = binary ? graph.serialize_binary() : graph.serialize(); }) };
+			const double load_ms{ best_ms(PASSES, [&]() {
+				const boost::optional<csg::Graph> parsed{ csg::Graph::from(graph_string) };
+				size = parsed ? graph_string.size() : 0;
+			}) };
+			write_row(out_stream, binary ? "binary" : "text", { static_cast<double>(size) / 1024.0, save_ms, load_ms });
+		}
+	}
+
+	return out_stream.str();
+}
+
+// Discards everything written to it, so writes can be timed without also timing where they end up
+class DiscardBuffer : public std::streambuf {
+public:
+	size_t size() const { return written; }
+
+protected:
+	int_type overflow(const int_type c) override
+	{
+		written++;
+		return traits_type::not_eof(c);
+	}
+
+	std::streamsize xsputn(const char*, const std::streamsize count) override
+	{
+		written += static_cast<size_t>(count);
+		return count;
+	}
+
+private:
+	size_t written{ 0 };
+};
+
+std::string cse::Benchmark::streaming()
+{
+	constexpr size_t PASSES{ 3 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Streamed text graphs, times in ms" << std::endl;
+	out_stream << "string: the whole document is built in or read into one string first" << std::endl;
+	out_stream << "stream: serialize and Graph::from on the stream directly, through a fixed-size buffer" << std::endl;
+	out_stream << std::left << std::setw(10) << "" << std::right;
+	out_stream << std::setw(12) << "MB" << std::setw(12) << "save" << std::setw(12) << "load" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	for (const size_t node_count : { static_cast<size_t>(1000), static_cast<size_t>(10000) }) {
+		out_stream << std::endl << "Nodes: " << node_count << std::endl;
+		const csg::Graph graph{ make_serialize_graph(node_count, generator) };
+		const std::string graph_string{ graph.serialize() };
+
+		for (const bool streamed : { false, true }) {
+			size_t save_size{ 0 };
+			const double save_ms{ best_ms(PASSES, [&]() {
+				DiscardBuffer discard;
+				std::ostream output{ &discard };
+				if (streamed) {
+					graph.serialize(output);
+				}
+				else {
+					output << graph.serialize();
+				}
+				save_size = discard.size();
+			}) };
+
+			std::istringstream input{ graph_string };
+			size_t size{ 0 };
+			const double load_ms{ best_ms(PASSES, [&]() {
+				input.clear();
+				input.seekg(0);
+				boost::optional<csg::Graph> parsed;
+				if (streamed) {
+					parsed = csg::Graph::from(input);
+				}
+				else {
+					const std::string read_string{ std::istreambuf_iterator<char>{ input }, std::istreambuf_iterator<char>{} };
+					parsed = csg::Graph::from(read_string);
+				}
+				size = parsed ? save_size : 0;
+			}) };
+			write_row(out_stream, streamed ? "stream" : "string", { static_cast<double>(size) / 1.0e6, save_ms, load_ms });
+		}
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::graph_library()
+{
+	constexpr size_t MATERIAL_COUNT{ 2000 };
+	constexpr size_t NODES_PER_MATERIAL{ 20 };
+	constexpr size_t LOAD_COUNT{ 100 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(4);
+	out_stream << "Graph library with " << MATERIAL_COUNT << " materials, times in ms" << std::endl;
+	out_stream << "parse all: deserialize every material from its own text string, as with one file per material" << std::endl;
+	out_stream << "open: read the library index" << std::endl;
+	out_stream << "load one: find and deserialize one material by name, average of " << LOAD_COUNT << std::endl;
+
+	std::mt19937 generator{ 1 };
+	std::map<std::string, csg::Graph> graphs;
+	std::vector<std::string> names;
+	std::vector<std::string> graph_strings;
+	for (size_t i = 0; i < MATERIAL_COUNT; i++) {
+		const std::string name{ "material_" + std::to_string(i) };
+		const csg::Graph graph{ make_serialize_graph(NODES_PER_MATERIAL, generator) };
+		graphs.emplace(name, graph);
+		names.push_back(name);
+		graph_strings.push_back(graph.serialize());
+	}
+	const std::string library_bytes{ csg::serialize_library(graphs) };
+
+	auto begin{ BenchmarkClock::now() };
+	size_t check_count{ 0 };
+	for (const std::string& graph_string : graph_strings) {
+		check_count += csg::Graph::from(graph_string) ? 1 : 0;
+	}
+	write_row(out_stream, "parse all", { elapsed_ms(begin) });
+
+	begin = BenchmarkClock::now();
+	const boost::optional<csg::GraphLibrary> library{ csg::GraphLibrary::from(library_bytes) };
+	write_row(out_stream, "open", { elapsed_ms(begin) });
+	if (library.has_value() == false) {
+		out_stream << "The library could not be read" << std::endl;
+		return out_stream.str();
+	}
+
+	std::uniform_int_distribution<size_t> name_dist{ 0, names.size() - 1 };
+	begin = BenchmarkClock::now();
+	for (size_t i = 0; i < LOAD_COUNT; i++) {
+		check_count += library->load(names[name_dist(generator)]) ? 1 : 0;
+	}
+	write_row(out_stream, "load one", { elapsed_ms(begin) / LOAD_COUNT });
+
+	if (check_count != MATERIAL_COUNT + LOAD_COUNT) {
+		out_stream << "Some materials failed to load" << std::endl;
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::graph_patch()
+{
+	constexpr size_t PASSES{ 5 };
+	constexpr size_t NODE_COUNT{ 2000 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Sending one slider change on a " << NODE_COUNT << " node graph to a host, sizes in KB and times in ms" << std::endl;
+	out_stream << "full: serialize the whole graph and parse it again" << std::endl;
+	out_stream << "patch: diff against the last graph sent and apply the patch to the host's copy" << std::endl;
+	out_stream << std::left << std::setw(10) << "" << std::right;
+	out_stream << std::setw(12) << "size" << std::setw(12) << "send" << std::setw(12) << "receive" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	const csg::Graph sent_graph{ make_serialize_graph(NODE_COUNT, generator) };
+	boost::optional<csg::SlotId> float_slot;
+	for (const auto& node : sent_graph.nodes()) {
+		for (size_t i = 0; i < node->slot_count() && float_slot.has_value() == false; i++) {
+			if (node->slot_value_as_ptr<csg::FloatSlotValue>(i)) {
+				float_slot = csg::SlotId{ node->id(), i };
+			}
+		}
+	}
+	csg::Graph edited_graph{ sent_graph };
+	if (float_slot) {
+		edited_graph.set_float(*float_slot, 0.125f);
+	}
+	const boost::optional<csg::Graph> host_graph{ csg::Graph::from(sent_graph.serialize_binary()) };
+	if (host_graph.has_value() == false) {
+		out_stream << "The host graph could not be created" << std::endl;
+		return out_stream.str();
+	}
+
+	for (const bool patch : { false, true }) {
+		std::string message;
+		size_t size{ 0 };
+		const double send_ms{ best_ms(PASSES, [&]() { message = patch ? csg::diff(sent_graph, edited_graph) : edited_graph.serialize(); }) };
+		const double receive_ms{ best_ms(PASSES, [&]() {
+			csg::Graph received_graph{ *host_graph };
+			bool received{ false };
+			if (patch) {
+				received = csg::apply_patch(received_graph, message);
+			}
+			else {
+				const boost::optional<csg::Graph> parsed{ csg::Graph::from(message) };
+				received = parsed.has_value();
+			}
+			size = received ? message.size() : 0;
+		}) };
+		write_row(out_stream, patch ? "patch" : "full", { static_cast<double>(size) / 1024.0, send_ms, receive_ms });
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::serialize_cache()
+{
+	constexpr size_t SAVE_COUNT{ 20 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Saving after each of " << SAVE_COUNT << " slider changes, average ms per save" << std::endl;
+	out_stream << "full: serialize_graph" << std::endl;
+	out_stream << "cached: SerializeCache, only the changed node is formatted again" << std::endl;
+	out_stream << std::left << std::setw(10) << "Nodes" << std::right;
+	out_stream << std::setw(12) << "full" << std::setw(12) << "cached" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	for (const size_t node_count : { static_cast<size_t>(1000), static_cast<size_t>(10000) }) {
+		csg::Graph graph{ make_serialize_graph(node_count, generator) };
+		std::vector<csg::SlotId> float_slots;
+		for (const auto& node : graph.nodes()) {
+			for (size_t i = 0; i < node->slot_count(); i++) {
+				if (node->slot_value_as_ptr<csg::FloatSlotValue>(i)) {
+					float_slots.push_back(csg::SlotId{ node->id(), i });
+				}
+			}
+		}
+		std::uniform_int_distribution<size_t> slot_dist{ 0, float_slots.size() - 1 };
+		std::uniform_real_distribution<float> value_dist{ 0.0f, 1.0f };
+
+		csg::SerializeCache cache;
+		cache.serialize(graph);
+		double full_ms{ 0.0 };
+		double cached_ms{ 0.0 };
+		size_t mismatch_count{ 0 };
+		for (size_t i = 0; i < SAVE_COUNT; i++) {
+			graph.set_float(float_slots[slot_dist(generator)], value_dist(generator));
+
+			auto begin{ BenchmarkClock::now() };
+			const std::string full_string{ graph.serialize() };
+			full_ms += elapsed_ms(begin);
+
+			begin = BenchmarkClock::now();
+			const std::string cached_string{ cache.serialize(graph) };
+			cached_ms += elapsed_ms(begin);
+
+			mismatch_count += (full_string == cached_string) ? 0 : 1;
+		}
+
+		out_stream << std::left << std::setw(10) << node_count << std::right;
+		out_stream << std::setw(12) << full_ms / SAVE_COUNT;
+		out_stream << std::setw(12) << cached_ms / SAVE_COUNT << std::endl;
+		if (mismatch_count > 0) {
+			out_stream << "Cached output differed from serialize_graph" << std::endl;
+		}
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::lazy_load()
+{
+	constexpr size_t PASSES{ 3 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Loading a text graph to list its node types and connections, times in ms" << std::endl;
+	out_stream << "full: deserialize_graph, every value parsed" << std::endl;
+	out_stream << "lazy: LazyGraph, values left unparsed" << std::endl;
+	out_stream << "lazy values: LazyGraph, then reading every slot value" << std::endl;
+	out_stream << std::left << std::setw(10) << "Nodes" << std::right;
+	out_stream << std::setw(12) << "full" << std::setw(12) << "lazy" << std::setw(14) << "lazy values" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	for (const size_t node_count : { static_cast<size_t>(1000), static_cast<size_t>(10000) }) {
+		const std::string graph_string{ make_serialize_graph(node_count, generator).serialize() };
+
+		size_t check_count{ 0 };
+		const double full_ms{ best_ms(PASSES, [&]() {
+			const boost::optional<csg::Graph> full_graph{ csg::deserialize_graph(graph_string) };
+			for (const auto& node : full_graph->nodes()) {
+				check_count += static_cast<size_t>(node->type());
+			}
+			check_count += full_graph->connections().size();
+		}) };
+		const auto load_lazy = [&](const bool read_values) {
+			const boost::optional<csg::LazyGraph> lazy_graph{ csg::LazyGraph::from(graph_string) };
+			for (const csg::LazyGraph::NodeInfo& node : lazy_graph->nodes()) {
+				check_count += static_cast<size_t>(node.type);
+			}
+			check_count += lazy_graph->connections().size();
+			if (read_values == false) {
+				return;
+			}
+			for (const csg::LazyGraph::NodeInfo& node : lazy_graph->nodes()) {
+				const size_t slot_count{ csg::NodeSchema::from(node.type).slots().size() };
+				for (size_t i = 0; i < slot_count; i++) {
+					check_count += (lazy_graph->get_slot_value_ptr(csg::SlotId{ node.id, i }) != nullptr) ? 1 : 0;
+				}
+			}
+		};
+		const double lazy_ms{ best_ms(PASSES, [&]() { load_lazy(false); }) };
+		const double values_ms{ best_ms(PASSES, [&]() { load_lazy(true); }) };
+
+		out_stream << std::left << std::setw(10) << node_count << std::right;
+		out_stream << std::setw(12) << full_ms;
+		out_stream << std::setw(12) << lazy_ms;
+		out_stream << std::setw(14) << values_ms << std::endl;
+		if (check_count == 0) {
+			out_stream << "Nothing was parsed" << std::endl;
+		}
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::parallel_load()
+{
+	constexpr size_t PASSES{ 3 };
+
+	std::vector<size_t> thread_counts{ 2, 4, 8 };
+	const size_t hardware_threads{ std::thread::hardware_concurrency() };
+	if (hardware_threads > thread_counts.back()) {
+		thread_counts.push_back(hardware_threads);
+	}
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Deserializing a text graph split between threads, times in ms" << std::endl;
+	out_stream << "This machine reports " << hardware_threads << " hardware threads" << std::endl;
+	out_stream << std::left << std::setw(10) << "Nodes" << std::right << std::setw(12) << "serial";
+	for (const size_t thread_count : thread_counts) {
+		out_stream << std::setw(12) << (std::to_string(thread_count) + " threads");
+	}
+	out_stream << std::endl;
+
+	std::mt19937 generator{ 1 };
+	for (const size_t node_count : { static_cast<size_t>(10000), static_cast<size_t>(50000) }) {
+		const std::string graph_string{ make_serialize_graph(node_count, generator).serialize() };
+
+		const auto time_load = [&graph_string](const size_t thread_count, bool& matches) {
+			return best_ms(PASSES, [&]() {
+				const boost::optional<csg::Graph> loaded_graph{
+					(thread_count == 1) ? csg::deserialize_graph(graph_string) : csg::deserialize_graph(graph_string, thread_count)
+				};
+				matches = matches && loaded_graph.has_value();
+			});
+		};
+
+		bool matches{ true };
+		out_stream << std::left << std::setw(10) << node_count << std::right << std::setw(12) << time_load(1, matches);
+		for (const size_t thread_count : thread_counts) {
+			out_stream << std::setw(12) << time_load(thread_count, matches);
+		}
+		out_stream << std::endl;
+		if (matches == false || csg::deserialize_graph(graph_string, thread_counts.back()) != csg::deserialize_graph(graph_string)) {
+			out_stream << "The parallel load read a different graph than the serial load" << std::endl;
+		}
+	}
+
+	return out_stream.str();
+}
+
+// Curve::eval_point as it was before curves were compiled, two scans over the points and a new hermite table per call
+static float eval_curve_by_scan(const std::vector<csg::CurvePoint>& points, const float input)
+{
+	const auto do_hermite = [](const float p0, const float p1, const float p2, const float p3, const float t) -> float {
+		const float a{ -p0 / 2.0f + (3.0f * p1) / 2.0f - (3.0f * p2) / 2.0f + p3 / 2.0f };
+		const float b{ p0 - (5.0f * p1) / 2.0f + 2.0f * p2 - p3 / 2.0f };
+		const float c{ -p0 / 2.0f + p2 / 2.0f };
+		const float d{ p1 };
+		return a * t*t*t + b * t*t + c * t + d;
+	};
+
+	boost::optional<size_t> p1_index;
+	boost::optional<size_t> p2_index;
+	for (size_t i = 0; i < points.size(); i++) {
+		if (points[i].pos.x <= input) {
+			p1_index = i;
+		}
+	}
+	for (size_t i = points.size(); i > 0; i--) {
+		if (points[i - 1].pos.x > input) {
+			p2_index = i - 1;
+		}
+	}
+	if (p1_index.has_value() == false) {
+		return points[0].pos.y;
+	}
+	if (p2_index.has_value() == false) {
+		return points[points.size() - 1].pos.y;
+	}
+
+	const csc::Float2 p1{ points[*p1_index].pos };
+	const csc::Float2 p2{ points[*p2_index].pos };
+	const csg::CurveInterp p1_interp{ points[*p1_index].interp };
+	const csg::CurveInterp p2_interp{ points[*p2_index].interp };
+	const float fade{ (input - p1.x) / (p2.x - p1.x) };
+	const float linear_result{ csc::lerp(p1.y, p2.y, fade) };
+	if (p1_interp == csg::CurveInterp::LINEAR && p2_interp == csg::CurveInterp::LINEAR) {
+		return linear_result;
+	}
+
+	const csc::Float2 p0{ (*p1_index == 0) ? p1 - (p2 - p1) : points[*p1_index - 1].pos };
+	const csc::Float2 p3{ (*p2_index >= points.size() - 1) ? p2 + (p2 - p1) : points[*p2_index + 1].pos };
+	std::array<csc::Float2, 32> hermite_curve;
+	for (size_t i = 0; i < hermite_curve.size(); i++) {
+		const float t{ static_cast<float>(i) / (hermite_curve.size() - 1) };
+		hermite_curve[i] = csc::Float2{ do_hermite(p0.x, p1.x, p2.x, p3.x, t), do_hermite(p0.y, p1.y, p2.y, p3.y, t) };
+	}
+	size_t before_index{ SIZE_MAX };
+	for (size_t i = 0; i < hermite_curve.size(); i++) {
+		if (hermite_curve[i].x < input) {
+			before_index = i;
+		}
+	}
+	float hermite_result{ 0.0f };
+	if (before_index == SIZE_MAX) {
+		hermite_result = hermite_curve[0].y;
+	}
+	else if (before_index == hermite_curve.size() - 1) {
+		hermite_result = hermite_curve[hermite_curve.size() - 1].y;
+	}
+	else {
+		const float lerp_t{ (input - hermite_curve[before_index].x) / (hermite_curve[before_index + 1].x - hermite_curve[before_index].x) };
+		hermite_result = csc::lerp(hermite_curve[before_index].y, hermite_curve[before_index + 1].y, lerp_t);
+	}
+
+	float hermite_weight{ 1.0f };
+	if (p1_interp == csg::CurveInterp::CUBIC_HERMITE && p2_interp == csg::CurveInterp::LINEAR) {
+		hermite_weight = 1.0f - fade;
+	}
+	else if (p1_interp == csg::CurveInterp::LINEAR && p2_interp == csg::CurveInterp::CUBIC_HERMITE) {
+		hermite_weight = fade;
+	}
+	return csc::lerp(linear_result, hermite_result, hermite_weight);
+}
+
+// Random points in the unit square with a mix of interpolation types, x is unevenly spaced
+static csg::Curve make_benchmark_curve(const size_t point_count, std::mt19937& generator)
+{
+	std::uniform_real_distribution<float> unit_dist{ 0.0f, 1.0f };
+	std::vector<csg::CurvePoint> points;
+	for (size_t i = 0; i < point_count; i++) {
+		const csg::CurveInterp interp{ (generator() % 4 == 0) ? csg::CurveInterp::LINEAR : csg::CurveInterp::CUBIC_HERMITE };
+		points.push_back(csg::CurvePoint{ csc::Float2{ unit_dist(generator), unit_dist(generator) }, interp });
+	}
+	return csg::Curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f }, points };
+}
+
+std::string cse::Benchmark::curve_eval()
+{
+	constexpr size_t PASSES{ 3 };
+	constexpr size_t CURVE_COUNT{ 20 };
+	constexpr size_t INPUT_COUNT{ 5000 };
+	constexpr size_t EDITOR_SAMPLES{ 256 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Curve evaluation, times in ns per evaluated point" << std::endl;
+	out_stream << "scan: searching every control point and building a hermite table for each point, as before" << std::endl;
+	out_stream << "compiled: Curve::eval_point, binary search over segments prepared when the points change" << std::endl;
+	out_stream << "editor: compiled, one eval_curve<" << EDITOR_SAMPLES << "> call as the curve editor makes" << std::endl;
+	out_stream << "Hermite segments are sampled by scan and solved exactly by compiled, see Curve hermite for how they differ" << std::endl;
+	out_stream << std::left << std::setw(10) << "Points" << std::right;
+	out_stream << std::setw(12) << "scan" << std::setw(12) << "compiled" << std::setw(12) << "editor" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	std::uniform_real_distribution<float> input_dist{ -0.1f, 1.1f };
+	for (const size_t point_count : { static_cast<size_t>(4), static_cast<size_t>(16), static_cast<size_t>(64) }) {
+		std::vector<csg::Curve> curves;
+		for (size_t i = 0; i < CURVE_COUNT; i++) {
+			curves.push_back(make_benchmark_curve(point_count, generator));
+		}
+		std::vector<float> inputs;
+		for (size_t i = 0; i < INPUT_COUNT; i++) {
+			inputs.push_back(input_dist(generator));
+		}
+
+		const size_t eval_count{ CURVE_COUNT * INPUT_COUNT };
+		float check_sum{ 0.0f };
+		const double scan_ns{ best_ms(PASSES, [&]() {
+			for (const csg::Curve& curve : curves) {
+				for (const float input : inputs) {
+					check_sum += eval_curve_by_scan(curve.control_points(), input);
+				}
+			}
+		}) * 1.0e6 / eval_count };
+		const double compiled_ns{ best_ms(PASSES, [&]() {
+			for (const csg::Curve& curve : curves) {
+				for (const float input : inputs) {
+					check_sum += curve.eval_point(input);
+				}
+			}
+		}) * 1.0e6 / eval_count };
+		const double editor_ns{ best_ms(PASSES, [&]() {
+			for (const csg::Curve& curve : curves) {
+				check_sum += curve.eval_curve<EDITOR_SAMPLES>()[EDITOR_SAMPLES / 2];
+			}
+		}) * 1.0e6 / (CURVE_COUNT * EDITOR_SAMPLES) };
+
+		out_stream << std::left << std::setw(10) << point_count << std::right;
+		out_stream << std::setw(12) << scan_ns;
+		out_stream << std::setw(12) << compiled_ns;
+		out_stream << std::setw(12) << editor_ns << std::endl;
+		if (check_sum == 0.0f) {
+			out_stream << "Nothing was evaluated" << std::endl;
+		}
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::curve_batch()
+{
+	constexpr size_t PASSES{ 3 };
+	constexpr size_t VALUE_COUNT{ 1000000 };
+	constexpr size_t COLOR_COUNT{ 250000 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(1);
+	out_stream << "Batch curve evaluation, millions of values per second on one thread" << std::endl;
+#if defined(CSC_SIMD_AVX2)
+	out_stream << "Built with AVX2, " << csc::SimdLanes::WIDTH << " lanes" << std::endl;
+#elif defined(CSC_SIMD_SSE2)
+	out_stream << "Built with SSE2, " << csc::SimdLanes::WIDTH << " lanes" << std::endl;
+#else
+	out_stream << "Built without SIMD, eval_many runs eval_point for each value" << std::endl;
+#endif
+	out_stream << "point: Curve::eval_point for each value" << std::endl;
+	out_stream << "many: Curve::eval_many over all values" << std::endl;
+	out_stream << "RGB rows: RGBCurveSlotValue on r, g, b, a colors, each counted as one value" << std::endl;
+	out_stream << std::left << std::setw(10) << "Points" << std::right;
+	out_stream << std::setw(12) << "point" << std::setw(12) << "many" << std::setw(14) << "mismatches" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	std::uniform_real_distribution<float> input_dist{ -0.1f, 1.1f };
+	std::vector<float> inputs(VALUE_COUNT * 4);
+	for (float& input : inputs) {
+		input = input_dist(generator);
+	}
+	std::vector<float> outputs(inputs.size());
+
+	const auto best_rate = [](const size_t value_count, const auto& run) {
+		return static_cast<double>(value_count) / best_ms(PASSES, run) / 1000.0;
+	};
+
+	for (const size_t point_count : { static_cast<size_t>(4), static_cast<size_t>(16), static_cast<size_t>(64) }) {
+		const csg::Curve curve{ make_benchmark_curve(point_count, generator) };
+		const double point_rate{ best_rate(VALUE_COUNT, [&]() {
+			for (size_t i = 0; i < VALUE_COUNT; i++) {
+				outputs[i] = curve.eval_point(inputs[i]);
+			}
+		}) };
+		const std::vector<float> point_outputs(outputs.begin(), outputs.begin() + VALUE_COUNT);
+		const double many_rate{ best_rate(VALUE_COUNT, [&]() {
+			curve.eval_many(inputs.data(), outputs.data(), VALUE_COUNT);
+		}) };
+		size_t mismatch_count{ 0 };
+		for (size_t i = 0; i < VALUE_COUNT; i++) {
+			mismatch_count += (outputs[i] != point_outputs[i]) ? 1 : 0;
+		}
+
+		out_stream << std::left << std::setw(10) << point_count << std::right;
+		out_stream << std::setw(12) << point_rate << std::setw(12) << many_rate << std::setw(14) << mismatch_count << std::endl;
+	}
+
+	for (const size_t point_count : { static_cast<size_t>(4), static_cast<size_t>(16) }) {
+		csg::RGBCurveSlotValue rgb_curves;
+		rgb_curves.set_all(make_benchmark_curve(point_count, generator));
+		rgb_curves.set_r(make_benchmark_curve(point_count, generator));
+		rgb_curves.set_g(make_benchmark_curve(point_count, generator));
+		rgb_curves.set_b(make_benchmark_curve(point_count, generator));
+		const std::array<const csg::Curve*, 3> channel_curves{ &rgb_curves.get_r(), &rgb_curves.get_g(), &rgb_curves.get_b() };
+
+		const double point_rate{ best_rate(COLOR_COUNT * 4, [&]() {
+			for (size_t i = 0; i < COLOR_COUNT; i++) {
+				for (size_t channel = 0; channel < 3; channel++) {
+					outputs[i * 4 + channel] = channel_curves[channel]->eval_point(rgb_curves.get_all().eval_point(inputs[i * 4 + channel]));
+				}
+				outputs[i * 4 + 3] = inputs[i * 4 + 3];
+			}
+		}) };
+		const std::vector<float> point_outputs(outputs.begin(), outputs.begin() + COLOR_COUNT * 4);
+		const double many_rate{ best_rate(COLOR_COUNT * 4, [&]() {
+			rgb_curves.eval_many(inputs.data(), outputs.data(), COLOR_COUNT);
+		}) };
+		size_t mismatch_count{ 0 };
+		for (size_t i = 0; i < COLOR_COUNT * 4; i++) {
+			mismatch_count += (outputs[i] != point_outputs[i]) ? 1 : 0;
+		}
+
+		out_stream << std::left << std::setw(10) << ("RGB " + std::to_string(point_count)) << std::right;
+		out_stream << std::setw(12) << point_rate << std::setw(12) << many_rate << std::setw(14) << mismatch_count << std::endl;
+	}
+
+	return out_stream.str();
+}
+
+// ColorRamp::eval as it was before it used binary search, a scan over every point copying each one
+static csc::Float4 eval_ramp_by_scan(const std::vector<csg::ColorRampPoint>& points, const float pos)
+{
+	const float pos_begin{ points[0].pos };
+	if (pos <= pos_begin) {
+		return csc::Float4{ points[0].color, points[0].alpha };
+	}
+	const float pos_end{ points[points.size() - 1].pos };
+	if (pos >= pos_end) {
+		return csc::Float4{ points[points.size() - 1].color, points[points.size() - 1].alpha };
+	}
+
+	csg::ColorRampPoint point_before{ points[0] };
+	csg::ColorRampPoint point_after{ points[points.size() - 1] };
+	for (const csg::ColorRampPoint this_point : points) {
+		if (this_point.pos > point_before.pos && this_point.pos < pos) {
+			point_before = this_point;
+		}
+		if (this_point.pos < point_after.pos && this_point.pos > pos) {
+			point_after = this_point;
+		}
+	}
+
+	const float fraction{ (pos - point_before.pos) / (point_after.pos - point_before.pos) };
+	return csc::lerp(csc::Float4{ point_before.color, point_before.alpha }, csc::Float4{ point_after.color, point_after.alpha }, fraction);
+}
+
+static float max_channel_diff(const csc::Float4 a, const csc::Float4 b)
+{
+	return std::max(std::max(std::abs(a.x - b.x), std::abs(a.y - b.y)), std::max(std::abs(a.z - b.z), std::abs(a.w - b.w)));
+}
+
+std::string cse::Benchmark::color_ramp()
+{
+	constexpr size_t PASSES{ 3 };
+	constexpr size_t VALUE_COUNT{ 200000 };
+	constexpr size_t LUT_RAMP_POINTS{ 16 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(2);
+	out_stream << "Color ramp evaluation, times in ns per evaluated position" << std::endl;
+	out_stream << "scan: searching every point, as before" << std::endl;
+	out_stream << "search: ColorRamp::eval, binary search over the points" << std::endl;
+	out_stream << "many: ColorRamp::eval_many over all positions" << std::endl;
+	out_stream << "lut: ColorRamp::eval_lut with a 1024 entry table" << std::endl;
+	out_stream << "Results of search and many that differ from scan are counted in mismatches" << std::endl;
+	out_stream << std::left << std::setw(10) << "Points" << std::right;
+	out_stream << std::setw(10) << "scan" << std::setw(10) << "search" << std::setw(10) << "many" << std::setw(10) << "lut";
+	out_stream << std::setw(14) << "mismatches" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	std::uniform_real_distribution<float> unit_dist{ 0.0f, 1.0f };
+	std::uniform_real_distribution<float> pos_dist{ -0.1f, 1.1f };
+	std::vector<float> positions(VALUE_COUNT);
+	for (float& pos : positions) {
+		pos = pos_dist(generator);
+	}
+	std::vector<csc::Float4> outputs(VALUE_COUNT);
+
+	const auto make_ramp = [&](const size_t point_count) {
+		std::vector<csg::ColorRampPoint> points;
+		for (size_t i = 0; i < point_count; i++) {
+			const csc::Float3 color{ unit_dist(generator), unit_dist(generator), unit_dist(generator) };
+			points.push_back(csg::ColorRampPoint{ unit_dist(generator), color, unit_dist(generator) });
+		}
+		return csg::ColorRamp{ points };
+	};
+	const auto best_ns = [](const size_t value_count, const auto& run) {
+		return best_ms(PASSES, run) * 1.0e6 / value_count;
+	};
+
+	for (const size_t point_count : { static_cast<size_t>(4), static_cast<size_t>(16), static_cast<size_t>(64) }) {
+		csg::ColorRamp ramp{ make_ramp(point_count) };
+		ramp.set_lut_size(1024);
+
+		float check_sum{ 0.0f };
+		const double scan_ns{ best_ns(VALUE_COUNT, [&]() {
+			for (size_t i = 0; i < VALUE_COUNT; i++) {
+				outputs[i] = eval_ramp_by_scan(ramp.get(), positions[i]);
+			}
+		}) };
+		const std::vector<csc::Float4> scan_outputs{ outputs };
+		const double search_ns{ best_ns(VALUE_COUNT, [&]() {
+			for (size_t i = 0; i < VALUE_COUNT; i++) {
+				outputs[i] = ramp.eval(positions[i]);
+			}
+		}) };
+		size_t mismatch_count{ 0 };
+		for (size_t i = 0; i < VALUE_COUNT; i++) {
+			mismatch_count += (outputs[i] != scan_outputs[i]) ? 1 : 0;
+		}
+		const double many_ns{ best_ns(VALUE_COUNT, [&]() {
+			ramp.eval_many(positions.data(), outputs.data(), VALUE_COUNT);
+		}) };
+		for (size_t i = 0; i < VALUE_COUNT; i++) {
+			mismatch_count += (outputs[i] != scan_outputs[i]) ? 1 : 0;
+		}
+		const double lut_ns{ best_ns(VALUE_COUNT, [&]() {
+			for (size_t i = 0; i < VALUE_COUNT; i++) {
+				outputs[i] = ramp.eval_lut(positions[i]);
+			}
+		}) };
+		for (const csc::Float4& output : outputs) {
+			check_sum += output.x;
+		}
+
+		out_stream << std::left << std::setw(10) << point_count << std::right;
+		out_stream << std::setw(10) << scan_ns << std::setw(10) << search_ns << std::setw(10) << many_ns << std::setw(10) << lut_ns;
+		out_stream << std::setw(14) << mismatch_count << std::endl;
+		if (check_sum == 0.0f) {
+			out_stream << "Nothing was evaluated" << std::endl;
+		}
+	}
+
+	out_stream << std::endl;
+	out_stream << "Lookup tables for a " << LUT_RAMP_POINTS << " point ramp" << std::endl;
+	out_stream << "bake: microseconds to rebuild the table after a change to the ramp" << std::endl;
+	out_stream << "error: largest difference in any channel between eval_lut and eval" << std::endl;
+	out_stream << std::left << std::setw(10) << "Entries" << std::right << std::setw(10) << "bake" << std::setw(12) << "error" << std::endl;
+	const csg::ColorRamp lut_ramp{ make_ramp(LUT_RAMP_POINTS) };
+	for (const size_t lut_size : { static_cast<size_t>(256), static_cast<size_t>(1024), static_cast<size_t>(4096) }) {
+		csg::ColorRamp ramp{ lut_ramp };
+		const double bake_us{ best_ms(PASSES, [&]() {
+			ramp.set_lut_size(0);
+			ramp.set_lut_size(lut_size);
+		}) * 1000.0 };
+		float max_error{ 0.0f };
+		for (const float pos : positions) {
+			max_error = std::max(max_error, max_channel_diff(ramp.eval_lut(pos), ramp.eval(pos)));
+		}
+		out_stream << std::left << std::setw(10) << lut_size << std::right << std::setw(10) << bake_us;
+		out_stream << std::setw(12) << std::setprecision(5) << max_error << std::setprecision(2) << std::endl;
+	}
+
+	return out_stream.str();
+}
+
+std::string cse::Benchmark::bake_cache()
+{
+	constexpr size_t PASSES{ 3 };
+	constexpr size_t MATERIAL_COUNT{ 300 };
+	constexpr size_t SYNC_COUNT{ 10 };
+	constexpr size_t LUT_RESOLUTION{ 256 };
+
+	std::stringstream out_stream;
+	out_stream << std::fixed << std::setprecision(3);
+	out_stream << "Baking lookup tables on each sync, " << MATERIAL_COUNT << " materials with an RGB curve, a vector curve and a ramp" << std::endl;
+	out_stream << "Tables have " << LUT_RESOLUTION << " entries, times in ms per sync of every material" << std::endl;
+	out_stream << "bake: bake_lut for every value" << std::endl;
+	out_stream << "cache: BakeCache::bake for every value, the cache is kept between syncs" << std::endl;
+	out_stream << std::left << std::setw(10) << "Distinct" << std::right;
+	out_stream << std::setw(10) << "bake" << std::setw(10) << "cache" << std::setw(10) << "hits" << std::setw(10) << "misses" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	std::uniform_real_distribution<float> unit_dist{ 0.0f, 1.0f };
+	const auto make_ramp = [&]() {
+		std::vector<csg::ColorRampPoint> points;
+		for (size_t i = 0; i < 5; i++) {
+			const csc::Float3 color{ unit_dist(generator), unit_dist(generator), unit_dist(generator) };
+			points.push_back(csg::ColorRampPoint{ unit_dist(generator), color, 1.0f });
+		}
+		return csg::ColorRampSlotValue{ csg::ColorRamp{ points } };
+	};
+
+	for (const size_t distinct_count : { static_cast<size_t>(1), static_cast<size_t>(20), static_cast<size_t>(MATERIAL_COUNT) }) {
+		// Each material gets copies of one of the distinct values, as separate materials would hold
+		std::vector<csg::RGBCurveSlotValue> rgb_curves;
+		std::vector<csg::VectorCurveSlotValue> vector_curves;
+		std::vector<csg::ColorRampSlotValue> ramps;
+		for (size_t i = 0; i < distinct_count; i++) {
+			csg::RGBCurveSlotValue rgb_value;
+			rgb_value.set_all(make_benchmark_curve(6, generator));
+			rgb_value.set_r(make_benchmark_curve(4, generator));
+			rgb_curves.push_back(rgb_value);
+			csg::VectorCurveSlotValue vector_value{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f } };
+			vector_value.set_x(make_benchmark_curve(6, generator));
+			vector_curves.push_back(vector_value);
+			ramps.push_back(make_ramp());
+		}
+		while (rgb_curves.size() < MATERIAL_COUNT) {
+			const size_t source{ rgb_curves.size() % distinct_count };
+			rgb_curves.push_back(rgb_curves[source]);
+			vector_curves.push_back(vector_curves[source]);
+			ramps.push_back(ramps[source]);
+		}
+
+		float check_sum{ 0.0f };
+		const double bake_ms{ best_ms(PASSES, [&]() {
+			for (size_t sync = 0; sync < SYNC_COUNT; sync++) {
+				for (size_t i = 0; i < MATERIAL_COUNT; i++) {
+					check_sum += csg::bake_lut(rgb_curves[i], LUT_RESOLUTION).values[1];
+					check_sum += csg::bake_lut(vector_curves[i], LUT_RESOLUTION).values[1];
+					check_sum += csg::bake_lut(ramps[i], LUT_RESOLUTION).values[1];
+				}
+			}
+		}) / SYNC_COUNT };
+
+		size_t hit_count{ 0 };
+		size_t miss_count{ 0 };
+		const double cache_ms{ best_ms(PASSES, [&]() {
+			csg::BakeCache cache{ 3 * MATERIAL_COUNT };
+			for (size_t sync = 0; sync < SYNC_COUNT; sync++) {
+				for (size_t i = 0; i < MATERIAL_COUNT; i++) {
+					check_sum += cache.bake(rgb_curves[i], LUT_RESOLUTION)->values[1];
+					check_sum += cache.bake(vector_curves[i], LUT_RESOLUTION)->values[1];
+					check_sum += cache.bake(ramps[i], LUT_RESOLUTION)->values[1];
+				}
+			}
+			hit_count = cache.hits();
+			miss_count = cache.misses();
+		}) / SYNC_COUNT };
+
+		out_stream << std::left << std::setw(10) << distinct_count << std::right;
+		out_stream << std::setw(10) << bake_ms << std::setw(10) << cache_ms << std::setw(10) << hit_count << std::setw(10) << miss_count << std::endl;
+		if (check_sum == 0.0f) {
+			out_stream << "Nothing was baked" << std::endl;
+		}
+	}
+
+	return out_stream.str();
+}
+
+// Hermite segments as Curve::eval_point evaluated them before they were solved exactly
+// Each segment keeps 32 points sampled along its spline and interpolates linearly between them
+class SampledCurve {
+public:
+	explicit SampledCurve(const std::vector<csg::CurvePoint>& points) : points{ points }
+	{
+		const auto do_hermite = [](const float p0, const float p1, const float p2, const float p3, const float t) -> float {
+			const float a{ -p0 / 2.0f + (3.0f * p1) / 2.0f - (3.0f * p2) / 2.0f + p3 / 2.0f };
+			const float b{ p0 - (5.0f * p1) / 2.0f + 2.0f * p2 - p3 / 2.0f };
+			const float c{ -p0 / 2.0f + p2 / 2.0f };
+			const float d{ p1 };
+			return a * t*t*t + b * t*t + c * t + d;
+		};
+		for (const csg::CurvePoint& this_point : points) {
+			point_x.push_back(this_point.pos.x);
+		}
+		for (size_t i = 0; i + 1 < points.size(); i++) {
+			const csc::Float2 p1{ points[i].pos };
+			const csc::Float2 p2{ points[i + 1].pos };
+			const csc::Float2 p0{ (i == 0) ? p1 - (p2 - p1) : points[i - 1].pos };
+			const csc::Float2 p3{ (i + 2 >= points.size()) ? p2 + (p2 - p1) : points[i + 2].pos };
+			std::array<csc::Float2, SAMPLE_COUNT> this_samples;
+			for (size_t j = 0; j < SAMPLE_COUNT; j++) {
+				const float t{ static_cast<float>(j) / (SAMPLE_COUNT - 1) };
+				this_samples[j] = csc::Float2{ do_hermite(p0.x, p1.x, p2.x, p3.x, t), do_hermite(p0.y, p1.y, p2.y, p3.y, t) };
+			}
+			// Searched by the lowest x at or after each sample, as x can go backwards
+			std::array<float, SAMPLE_COUNT> this_search_x;
+			float lowest_x{ this_samples[SAMPLE_COUNT - 1].x };
+			for (size_t j = SAMPLE_COUNT; j > 0; j--) {
+				lowest_x = std::min(lowest_x, this_samples[j - 1].x);
+				this_search_x[j - 1] = lowest_x;
+			}
+			samples.push_back(this_samples);
+			search_x.push_back(this_search_x);
+		}
+	}
+
+	float eval(const float input) const
+	{
+		if ((point_x.front() <= input) == false) {
+			return points.front().pos.y;
+		}
+		const size_t after_index{ csc::count_before(point_x.data(), point_x.size(), [input](const float x) { return x <= input; }) };
+		if (after_index == point_x.size()) {
+			return points.back().pos.y;
+		}
+		const size_t segment{ after_index - 1 };
+		const csg::CurvePoint& p1{ points[segment] };
+		const csg::CurvePoint& p2{ points[segment + 1] };
+		const float fade{ (input - p1.pos.x) / (p2.pos.x - p1.pos.x) };
+		const float linear_result{ csc::lerp(p1.pos.y, p2.pos.y, fade) };
+		if (p1.interp == csg::CurveInterp::LINEAR && p2.interp == csg::CurveInterp::LINEAR) {
+			return linear_result;
+		}
+
+		const std::array<csc::Float2, SAMPLE_COUNT>& this_samples{ samples[segment] };
+		const size_t sample_after{ csc::count_before(search_x[segment].data(), SAMPLE_COUNT, [input](const float x) { return x < input; }) };
+		float hermite_result{ 0.0f };
+		if (sample_after == 0) {
+			hermite_result = this_samples[0].y;
+		}
+		else if (sample_after == SAMPLE_COUNT) {
+			hermite_result = this_samples[SAMPLE_COUNT - 1].y;
+		}
+		else {
+			const csc::Float2 before{ this_samples[sample_after - 1] };
+			const csc::Float2 after{ this_samples[sample_after] };
+			hermite_result = csc::lerp(before.y, after.y, (input - before.x) / (after.x - before.x));
+		}
+
+		float hermite_weight{ 1.0f };
+		if (p1.interp == csg::CurveInterp::CUBIC_HERMITE && p2.interp == csg::CurveInterp::LINEAR) {
+			hermite_weight = 1.0f - fade;
+		}
+		else if (p1.interp == csg::CurveInterp::LINEAR && p2.interp == csg::CurveInterp::CUBIC_HERMITE) {
+			hermite_weight = fade;
+		}
+		return csc::lerp(linear_result, hermite_result, hermite_weight);
+	}
+
+private:
+	static constexpr size_t SAMPLE_COUNT{ 32 };
+
+	std::vector<csg::CurvePoint> points;
+	std::vector<float> point_x;
+	std::vector<std::array<csc::Float2, SAMPLE_COUNT>> samples;
+	std::vector<std::array<float, SAMPLE_COUNT>> search_x;
+};
+
+static double eval_cubic(const std::array<double, 4>& coefs, const double t)
+{
+	return ((coefs[0] * t + coefs[1]) * t + coefs[2]) * t + coefs[3];
+}
+
+// The curve's value in double precision, each hermite segment is solved by bisection for the t where x last rises to
+// the input, which is what both the sampled and exact methods approach
+static double eval_curve_reference(const std::vector<csg::CurvePoint>& points, const double input)
+{
+	const auto hermite_coefs = [](const double p0, const double p1, const double p2, const double p3) {
+		return std::array<double, 4>{
+			-p0 / 2.0 + (3.0 * p1) / 2.0 - (3.0 * p2) / 2.0 + p3 / 2.0,
+			p0 - (5.0 * p1) / 2.0 + 2.0 * p2 - p3 / 2.0,
+			-p0 / 2.0 + p2 / 2.0,
+			p1,
+		};
+	};
+
+	size_t after_index{ 0 };
+	while (after_index < points.size() && points[after_index].pos.x <= input) {
+		after_index++;
+	}
+	if (after_index == 0) {
+		return points.front().pos.y;
+	}
+	if (after_index == points.size()) {
+		return points.back().pos.y;
+	}
+	const size_t segment{ after_index - 1 };
+	const csc::Float2 p1{ points[segment].pos };
+	const csc::Float2 p2{ points[segment + 1].pos };
+	const csg::CurveInterp p1_interp{ points[segment].interp };
+	const csg::CurveInterp p2_interp{ points[segment + 1].interp };
+	const double fade{ (input - p1.x) / (static_cast<double>(p2.x) - p1.x) };
+	const double linear_result{ p1.y + (static_cast<double>(p2.y) - p1.y) * fade };
+	if (p1_interp == csg::CurveInterp::LINEAR && p2_interp == csg::CurveInterp::LINEAR) {
+		return linear_result;
+	}
+
+	const csc::Float2 p0{ (segment == 0) ? p1 - (p2 - p1) : points[segment - 1].pos };
+	const csc::Float2 p3{ (segment + 2 >= points.size()) ? p2 + (p2 - p1) : points[segment + 2].pos };
+	const std::array<double, 4> x_coefs{ hermite_coefs(p0.x, p1.x, p2.x, p3.x) };
+	const std::array<double, 4> y_coefs{ hermite_coefs(p0.y, p1.y, p2.y, p3.y) };
+
+	// Split at the turning points of x, then take the last piece that goes below the input
+	std::vector<double> splits{ 0.0 };
+	const double slope_a{ 3.0 * x_coefs[0] };
+	const double slope_b{ 2.0 * x_coefs[1] };
+	const double discriminant{ slope_b * slope_b - 4.0 * slope_a * x_coefs[2] };
+	if (slope_a != 0.0 && discriminant >= 0.0) {
+		for (const double root : { (-slope_b - std::sqrt(discriminant)) / (2.0 * slope_a), (-slope_b + std::sqrt(discriminant)) / (2.0 * slope_a) }) {
+			if (root > 0.0 && root < 1.0) {
+				splits.push_back(root);
+			}
+		}
+	}
+	else if (slope_a == 0.0 && slope_b != 0.0 && -x_coefs[2] / slope_b > 0.0 && -x_coefs[2] / slope_b < 1.0) {
+		splits.push_back(-x_coefs[2] / slope_b);
+	}
+	std::sort(splits.begin(), splits.end());
+	splits.push_back(1.0);
+
+	double t{ 0.0 };
+	for (size_t piece = splits.size() - 1; piece > 0; piece--) {
+		const double lo_t{ splits[piece - 1] };
+		const double hi_t{ splits[piece] };
+		if (eval_cubic(x_coefs, hi_t) < input) {
+			t = hi_t;
+			break;
+		}
+		if (eval_cubic(x_coefs, lo_t) < input) {
+			double bisect_lo{ lo_t };
+			double bisect_hi{ hi_t };
+			for (int step = 0; step < 100; step++) {
+				const double mid{ (bisect_lo + bisect_hi) / 2.0 };
+				if (eval_cubic(x_coefs, mid) < input) {
+					bisect_lo = mid;
+				}
+				else {
+					bisect_hi = mid;
+				}
+			}
+			t = bisect_lo;
+			break;
+		}
+	}
+	const double hermite_result{ eval_cubic(y_coefs, t) };
+
+	double hermite_weight{ 1.0 };
+	if (p1_interp == csg::CurveInterp::CUBIC_HERMITE && p2_interp == csg::CurveInterp::LINEAR) {
+		hermite_weight = 1.0 - fade;
+	}
+	else if (p1_interp == csg::CurveInterp::LINEAR && p2_interp == csg::CurveInterp::CUBIC_HERMITE) {
+		hermite_weight = fade;
+	}
+	return linear_result + (hermite_result - linear_result) * hermite_weight;
+}
+
+std::string cse::Benchmark::curve_hermite()
+{
+	constexpr size_t PASSES{ 3 };
+	constexpr size_t CURVE_COUNT{ 50 };
+	constexpr size_t POINT_COUNT{ 8 };
+	constexpr size_t INPUT_COUNT{ 20000 };
+
+	std::stringstream out_stream;
+	out_stream << "Hermite segments, sampled at 32 points as before against solved exactly for t" << std::endl;
+	out_stream << "Errors are against the same curves evaluated in double precision" << std::endl;
+	out_stream << "Times are ns per value, exact is Curve::eval_point and many is Curve::eval_many" << std::endl;
+	out_stream << CURVE_COUNT << " curves of " << POINT_COUNT << " hermite points for each row" << std::endl;
+	out_stream << "random: points anywhere in the unit square" << std::endl;
+	out_stream << "steep: points in pairs 0.002 apart in x" << std::endl;
+	out_stream << std::left << std::setw(10) << "Curves" << std::right;
+	out_stream << std::setw(12) << "sampled max" << std::setw(12) << "mean" << std::setw(12) << "exact max" << std::setw(12) << "mean";
+	out_stream << std::setw(10) << "sampled" << std::setw(10) << "exact" << std::setw(10) << "many" << std::endl;
+
+	std::mt19937 generator{ 1 };
+	std::uniform_real_distribution<float> unit_dist{ 0.0f, 1.0f };
+	std::uniform_real_distribution<float> input_dist{ -0.1f, 1.1f };
+	std::vector<float> inputs(INPUT_COUNT);
+	for (float& input : inputs) {
+		input = input_dist(generator);
+	}
+	std::vector<float> outputs(INPUT_COUNT);
+
+	for (const bool steep : { false, true }) {
+		std::vector<csg::Curve> curves;
+		for (size_t i = 0; i < CURVE_COUNT; i++) {
+			std::vector<csg::CurvePoint> points;
+			while (points.size() < POINT_COUNT) {
+				const float x{ steep ? unit_dist(generator) * 0.998f : unit_dist(generator) };
+				points.push_back(csg::CurvePoint{ csc::Float2{ x, unit_dist(generator) }, csg::CurveInterp::CUBIC_HERMITE });
+				if (steep) {
+					points.push_back(csg::CurvePoint{ csc::Float2{ x + 0.002f, unit_dist(generator) }, csg::CurveInterp::CUBIC_HERMITE });
+				}
+			}
+			curves.push_back(csg::Curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f }, points });
+		}
+		std::vector<SampledCurve> sampled_curves;
+		for (const csg::Curve& curve : curves) {
+			sampled_curves.push_back(SampledCurve{ curve.control_points() });
+		}
+
+		double sampled_max{ 0.0 };
+		double sampled_sum{ 0.0 };
+		double exact_max{ 0.0 };
+		double exact_sum{ 0.0 };
+		for (size_t i = 0; i < CURVE_COUNT; i++) {
+			for (const float input : inputs) {
+				const double reference{ eval_curve_reference(curves[i].control_points(), input) };
+				const double sampled_error{ std::abs(sampled_curves[i].eval(input) - reference) };
+				const double exact_error{ std::abs(curves[i].eval_point(input) - reference) };
+				sampled_max = std::max(sampled_max, sampled_error);
+				sampled_sum += sampled_error;
+				exact_max = std::max(exact_max, exact_error);
+				exact_sum += exact_error;
+			}
+		}
+
+		const double value_count{ static_cast<double>(CURVE_COUNT * INPUT_COUNT) };
+		float check_sum{ 0.0f };
+		const double sampled_ns{ best_ms(PASSES, [&]() {
+			for (const SampledCurve& curve : sampled_curves) {
+				for (const float input : inputs) {
+					check_sum += curve.eval(input);
+				}
+			}
+		}) * 1.0e6 / value_count };
+		const double exact_ns{ best_ms(PASSES, [&]() {
+			for (const csg::Curve& curve : curves) {
+				for (const float input : inputs) {
+					check_sum += curve.eval_point(input);
+				}
+			}
+		}) * 1.0e6 / value_count };
+		const double many_ns{ best_ms(PASSES, [&]() {
+			for (const csg::Curve& curve : curves) {
+				curve.eval_many(inputs.data(), outputs.data(), INPUT_COUNT);
+				check_sum += outputs[0];
+			}
+		}) * 1.0e6 / value_count };
+
+		out_stream << std::left << std::setw(10) << (steep ? "steep" : "random") << std::right;
+		out_stream << std::scientific << std::setprecision(2);
+		out_stream << std::setw(12) << sampled_max << std::setw(12) << sampled_sum / value_count;
+		out_stream << std::setw(12) << exact_max << std::setw(12) << exact_sum / value_count;
+		out_stream << std::fixed << std::setprecision(2);
+		out_stream << std::setw(10) << sampled_ns << std::setw(10) << exact_ns << std::setw(10) << many_ns << std::endl;
+		if (check_sum == 0.0f) {
+			out_stream << "Nothing was evaluated" << std::endl;
+		}
+	}
+
+	return out_stream.str();
+}
+
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines benchmarks that can be run from the debug window.
+ *
+ * They are only built, and only shown in the debug window, when CSE_BENCHMARKS is defined.
+ */
+
+#include <string>
+
+namespace cse {
+	namespace Benchmark {
+		// Each benchmark returns a human-readable report of its results
+		std::string graph_storage();
+		std::string graph_connections();
+		std::string undo_snapshot();
+		std::string node_creation();
+		std::string slot_access();
+		std::string slot_edit();
+		std::string graph_transaction();
+		std::string graph_journal();
+		std::string serialize();
+		std::string deserialize();
+		std::string binary_format();
+		std::string streaming();
+		std::string graph_library();
+		std::string graph_patch();
+		std::string serialize_cache();
+		std::string lazy_load();
+		std::string parallel_load();
+		std::string curve_eval();
+		std::string curve_batch();
+		std::string color_ramp();
+		std::string bake_cache();
+		std::string curve_hermite();
+	}
+}
@@ -80,6 +80,7 @@ namespace cse {
 		PARAM_EDIT_COLOR_CHANGE,
 		// Debug window
 		VALIDATE_SET_MESSAGE,
+		BENCHMARK_SET_MESSAGE,
 		// Modal curve editor
 		CURVE_EDIT_RESET,
 		CURVE_EDIT_SET_BOUNDS,
@@ -0,0 +1,3 @@
+#include "heap_counter.h"
+
+std::atomic<uint64_t> cse::HeapCounter::count{ 0 };
@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines HeapCounter.
+ */
+
+#include <atomic>
+#include <cstdint>
+
+namespace cse {
+
+	/**
+	 * @brief Counts heap allocations for the debug window.
+	 *
+	 * Nothing here replaces operator new, a program that wants allocations counted must replace it and call
+	 * record_allocation(). extra/main.cpp does this when built with CSE_COUNT_ALLOCATIONS, see the editor_alloc_count
+	 * target in the makefile.
+	 */
+	class HeapCounter {
+	public:
+		static void record_allocation() { count.fetch_add(1, std::memory_order_relaxed); }
+
+		static uint64_t allocations() { return count.load(std::memory_order_relaxed); }
+		// False if operator new has not been replaced to call record_allocation()
+		static bool active() { return allocations() > 0; }
+
+	private:
+		static std::atomic<uint64_t> count;
+	};
+}
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <string>
 #include <thread>
+#include <utility>
 
 #include <boost/optional.hpp>
 #include <GLFW/glfw3.h>
@@ -587,7 +588,7 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 				quit_requested = true;
 				break;
 			case InterfaceEventType::SAVE_TO_MAX:
-				shared_state->set_output_graph(the_graph->serialize());
+				shared_state->set_output_graph(*the_graph);
 				graph_unsaved = false;
 				break;
 			case InterfaceEventType::SAVE_TO_FILE:
@@ -637,8 +638,8 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 				// Fetch the curve from the graph
 				if (selected_slot) {
 					const csg::SlotId slot_id{ *selected_slot };
-					const auto this_slot_rgb{ the_graph->get_slot_value_as<csg::RGBCurveSlotValue>(slot_id) };
-					const auto this_slot_vec{ the_graph->get_slot_value_as<csg::VectorCurveSlotValue>(slot_id) };
+					const csg::RGBCurveSlotValue* const this_slot_rgb{ the_graph->get_slot_value_as_ptr<csg::RGBCurveSlotValue>(slot_id) };
+					const csg::VectorCurveSlotValue* const this_slot_vec{ the_graph->get_slot_value_as_ptr<csg::VectorCurveSlotValue>(slot_id) };
 					if (this_slot_rgb) {
 						modal_curve_editor.set_vector(*this_slot_rgb);
 						modal_window = ModalWindow::CURVE_EDITOR;
@@ -654,9 +655,9 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 			{
 				assert(selected_slot.has_value());
 				const csg::SlotId slot_id{ *selected_slot };
-				const boost::optional<csg::RGBCurveSlotValue> rgb_curve{ modal_curve_editor.take_rgb() };
+				boost::optional<csg::RGBCurveSlotValue> rgb_curve{ modal_curve_editor.take_rgb() };
 				if (rgb_curve) {
-					the_graph->set_curve_rgb(slot_id, *rgb_curve);
+					the_graph->set_curve_rgb(slot_id, std::move(*rgb_curve));
 				}
 				const InterfaceEvent close_event{ InterfaceEventType::MODAL_CURVE_EDITOR_CLOSE };
 				do_event(close_event);
@@ -667,9 +668,9 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 			{
 				assert(selected_slot.has_value());
 				const csg::SlotId slot_id{ *selected_slot };
-				const boost::optional<csg::VectorCurveSlotValue> vector_curve{ modal_curve_editor.take_vector() };
+				boost::optional<csg::VectorCurveSlotValue> vector_curve{ modal_curve_editor.take_vector() };
 				if (vector_curve) {
-					the_graph->set_curve_vec(slot_id, *vector_curve);
+					the_graph->set_curve_vec(slot_id, std::move(*vector_curve));
 				}
 				const InterfaceEvent close_event{ InterfaceEventType::MODAL_CURVE_EDITOR_CLOSE };
 				do_event(close_event);
@@ -685,9 +686,9 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 				assert(event.details_as<ModalRampColorPickShowDetails>().has_value());
 				const ModalRampColorPickShowDetails details{ event.details_as<ModalRampColorPickShowDetails>().get() };
 				// Get the current RGB value from the attached slot and index
-				const auto opt_value{ the_graph->get_slot_value_as<csg::ColorRampSlotValue>(details.slot_id) };
+				const csg::ColorRampSlotValue* const opt_value{ the_graph->get_slot_value_as_ptr<csg::ColorRampSlotValue>(details.slot_id) };
 				if (opt_value) {
-					const csg::ColorRamp ramp{ opt_value->get() };
+					const csg::ColorRamp& ramp{ opt_value->get() };
 					if (details.index < ramp.size()) {
 						const csg::ColorRampPoint point{ ramp.get(details.index) };
 						const csc::Float4 rgba{ point.color, point.alpha };
@@ -764,7 +765,7 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 			{
 				const boost::optional<ModifySlotRampColorDetails> details{ event.details_as<ModifySlotRampColorDetails>() };
 				assert(details.has_value());
-				const boost::optional<csg::ColorRampSlotValue> opt_ramp{ the_graph->get_slot_value_as<csg::ColorRampSlotValue>(details->slot_id) };
+				const csg::ColorRampSlotValue* const opt_ramp{ the_graph->get_slot_value_as_ptr<csg::ColorRampSlotValue>(details->slot_id) };
 				if (opt_ramp) {
 					const boost::optional<csg::ColorRampPoint> opt_point{ opt_ramp->get().get(details->point_index) };
 					if (opt_point) {
@@ -774,7 +775,7 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 						mut_point.alpha = details->new_value.w;
 						csg::ColorRamp mut_ramp{ opt_ramp->get() };
 						mut_ramp.set(details->point_index, mut_point);
-						the_graph->set_color_ramp(details->slot_id, mut_ramp);
+						the_graph->set_color_ramp(details->slot_id, std::move(mut_ramp));
 						should_do_undo_push = true;
 					}
 				}
@@ -784,7 +785,7 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 			{
 				const boost::optional<ModifySlotRampPosDetails> details{ event.details_as<ModifySlotRampPosDetails>() };
 				assert(details.has_value());
-				const boost::optional<csg::ColorRampSlotValue> opt_ramp{ the_graph->get_slot_value_as<csg::ColorRampSlotValue>(details->slot_id) };
+				const csg::ColorRampSlotValue* const opt_ramp{ the_graph->get_slot_value_as_ptr<csg::ColorRampSlotValue>(details->slot_id) };
 				if (opt_ramp) {
 					const boost::optional<csg::ColorRampPoint> opt_point{ opt_ramp->get().get(details->point_index) };
 					if (opt_point) {
@@ -792,7 +793,7 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 						mut_point.pos = details->new_value;
 						csg::ColorRamp mut_ramp{ opt_ramp->get() };
 						mut_ramp.set(details->point_index, mut_point);
-						the_graph->set_color_ramp(details->slot_id, mut_ramp);
+						the_graph->set_color_ramp(details->slot_id, std::move(mut_ramp));
 						should_do_undo_push = true;
 					}
 				}
@@ -802,13 +803,12 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 			{
 				const boost::optional<SlotIdDetails> details{ event.details_as<SlotIdDetails>() };
 				assert(details.has_value());
-				const boost::optional<csg::ColorRampSlotValue> opt_ramp{ the_graph->get_slot_value_as<csg::ColorRampSlotValue>(details->value) };
+				const csg::ColorRampSlotValue* const opt_ramp{ the_graph->get_slot_value_as_ptr<csg::ColorRampSlotValue>(details->value) };
 				if (opt_ramp) {
-					const csg::ColorRamp ramp{ opt_ramp->get() };
-					std::vector<csg::ColorRampPoint> mut_points{ ramp.get() };
+					std::vector<csg::ColorRampPoint> mut_points{ opt_ramp->get().get() };
 					mut_points.push_back(csg::ColorRampPoint{ 1.0f, csc::Float3{ 1.0f, 1.0f, 1.0f }, 1.0f });
-					const csg::ColorRamp new_ramp{ mut_points };
-					the_graph->set_color_ramp(details->value, new_ramp);
+					csg::ColorRamp new_ramp{ std::move(mut_points) };
+					the_graph->set_color_ramp(details->value, std::move(new_ramp));
 					should_do_undo_push = true;
 				}
 				break;
@@ -817,11 +817,11 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 			{
 				const boost::optional<ModifySlotRampDeleteDetails> details{ event.details_as<ModifySlotRampDeleteDetails>() };
 				assert(details.has_value());
-				const boost::optional<csg::ColorRampSlotValue> opt_ramp{ the_graph->get_slot_value_as<csg::ColorRampSlotValue>(details->slot_id) };
+				const csg::ColorRampSlotValue* const opt_ramp{ the_graph->get_slot_value_as_ptr<csg::ColorRampSlotValue>(details->slot_id) };
 				if (opt_ramp) {
 					csg::ColorRamp mut_ramp{ opt_ramp->get() };
 					mut_ramp.remove(details->point_index);
-					the_graph->set_color_ramp(details->slot_id, mut_ramp);
+					the_graph->set_color_ramp(details->slot_id, std::move(mut_ramp));
 					should_do_undo_push = true;
 				}
 				break;
@@ -854,10 +854,11 @@ void cse::MainWindow::do_event(const InterfaceEvent& event)
 				const std::string graph_string{ the_graph->serialize() };
 				const boost::optional<csg::Graph> opt_graph{ csg::Graph::from(graph_string) };
 				assert(opt_graph.has_value());
-				if (*opt_graph != *the_graph) {
+				// Values are rounded when serialized, so compare serialized forms rather than the graphs themselves
+				if (opt_graph->serialize() != graph_string) {
 					std::cout << "Assert failed" << std::endl;
 					std::cout << "original:" << std::endl;
-					std::cout << the_graph->serialize() << std::endl;
+					std::cout << graph_string << std::endl;
 					std::cout << "reloaded:" << std::endl;
 					std::cout << opt_graph->serialize() << std::endl;
 					assert(false);
@@ -10,7 +10,7 @@
 
 cse::NodeGeometry::NodeGeometry(const csg::Node& node) :
 	_pos{ csc::Float2{ node.position } },
-	_size{ NODE_DEFAULT_WIDTH, NODE_HEADER_HEIGHT + NODE_ROW_HEIGHT * node.slots().size() }
+	_size{ NODE_DEFAULT_WIDTH, NODE_HEADER_HEIGHT + NODE_ROW_HEIGHT * node.slot_count() }
 {
 	// Add extra width for some specific nodes
 	switch (node.type()) {
@@ -41,7 +41,7 @@ bool cse::Platform::save_graph_dialog(const std::string graph)
 				wchar_t* wstr_ptr{ wstr_path.data() };
 				const HRESULT hr = save_item->GetDisplayName(SIGDN_FILESYSPATH, &wstr_ptr);
 				if (SUCCEEDED(hr)) {
-					std::ofstream file_stream{ wstr_ptr, std::ofstream::trunc };
+					std::ofstream file_stream{ wstr_ptr, std::ofstream::trunc | std::ofstream::binary };
 					file_stream << graph;
 					file_stream.close();
 					result = true;
@@ -81,18 +81,10 @@ boost::optional<std::string> cse::Platform::load_graph_dialog()
 				hr = shell_item->GetDisplayName(SIGDN_FILESYSPATH, &file_path);
 
 				if (SUCCEEDED(hr)) {
+					// Binary mode so graphs saved in the binary format are not altered by newline translation
 					std::stringstream result_stream;
-					std::ifstream input_file(file_path, std::ifstream::in);
-
-					while (true) {
-						const int c{ input_file.get() };
-						if (c != EOF) {
-							result_stream << static_cast<char>(c);
-						}
-						else {
-							break;
-						}
-					}
+					std::ifstream input_file(file_path, std::ifstream::in | std::ifstream::binary);
+					result_stream << input_file.rdbuf();
 					result = result_stream.str();
 				}
 				shell_item->Release();
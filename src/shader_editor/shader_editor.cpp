@@ -37,11 +37,21 @@ bool cse::ShaderGraphEditor::has_new_data()
 	return impl->has_new_data();
 }
 
+bool cse::ShaderGraphEditor::new_data_layout_only()
+{
+	return impl->new_data_layout_only();
+}
+
 std::string cse::ShaderGraphEditor::get_serialized_graph()
 {
 	return impl->get_serialized_graph();
 }
 
+std::string cse::ShaderGraphEditor::get_graph_patch()
+{
+	return impl->get_graph_patch();
+}
+
 void cse::ShaderGraphEditor::force_close()
 {
 	impl->force_close();
@@ -74,11 +74,21 @@ bool cse::ShaderGraphEditorImpl::has_new_data()
 	return shared_state->output_updated();
 }
 
+bool cse::ShaderGraphEditorImpl::new_data_layout_only()
+{
+	return shared_state->output_layout_only();
+}
+
 std::string cse::ShaderGraphEditorImpl::get_serialized_graph()
 {
 	return shared_state->get_output_graph();
 }
 
+std::string cse::ShaderGraphEditorImpl::get_graph_patch()
+{
+	return shared_state->get_output_patch();
+}
+
 void cse::ShaderGraphEditorImpl::force_close()
 {
 	shared_state->request_stop();
@@ -30,7 +30,12 @@ namespace cse {
 		void wait();
 
 		bool has_new_data();
+		// True if the new data only moves nodes around and renders the same as the last graph retrieved
+		bool new_data_layout_only();
 		std::string get_serialized_graph();
+		// Patch from the graph last retrieved to the new data, apply it with csg::apply_patch
+		// Much smaller than the full graph when only a few values have changed
+		std::string get_graph_patch();
 
 		void force_close();
 
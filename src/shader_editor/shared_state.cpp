@@ -1,5 +1,13 @@
 #include "shared_state.h"
 
+#include <mutex>
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include "shader_graph/graph.h"
+#include "shader_graph/serialize.h"
+
 bool cse::SharedState::input_updated()
 {
 	std::lock_guard<std::mutex> lock(input_mutex);
@@ -14,6 +22,13 @@ bool cse::SharedState::output_updated()
 	return result;
 }
 
+bool cse::SharedState::output_layout_only()
+{
+	std::lock_guard<std::mutex> lock(output_mutex);
+	const bool result{ _output_updated && read_semantic_hash == output_semantic_hash };
+	return result;
+}
+
 std::string cse::SharedState::get_input_graph()
 {
 	std::lock_guard<std::mutex> lock(input_mutex);
@@ -31,15 +46,44 @@ void cse::SharedState::set_input_graph(const std::string& new_graph)
 
 std::string cse::SharedState::get_output_graph()
 {
-	std::lock_guard<std::mutex> lock(output_mutex);
-	const std::string result{ output_graph };
-	_output_updated = false;
-	return result;
+	boost::optional<csg::Graph> graph;
+	{
+		std::lock_guard<std::mutex> lock(output_mutex);
+		graph = output_graph;
+		read_graph = output_graph;
+		_output_updated = false;
+		read_semantic_hash = output_semantic_hash;
+	}
+	// Serialize outside the lock so the window thread is not kept waiting
+	if (graph.has_value() == false) {
+		return std::string{};
+	}
+	// Successive outputs usually differ in only a few nodes, the cache only formats those again
+	std::lock_guard<std::mutex> lock(serialize_mutex);
+	return serialize_cache.serialize(*graph);
+}
+
+std::string cse::SharedState::get_output_patch()
+{
+	boost::optional<csg::Graph> graph;
+	boost::optional<csg::Graph> base_graph;
+	{
+		std::lock_guard<std::mutex> lock(output_mutex);
+		graph = output_graph;
+		base_graph = read_graph;
+		read_graph = output_graph;
+		_output_updated = false;
+		read_semantic_hash = output_semantic_hash;
+	}
+	const csg::Graph empty_graph{ csg::GraphType::EMPTY };
+	return csg::diff(base_graph ? *base_graph : empty_graph, graph ? *graph : empty_graph);
 }
 
-void cse::SharedState::set_output_graph(const std::string& new_graph)
+void cse::SharedState::set_output_graph(const csg::Graph& new_graph)
 {
+	const uint64_t semantic_hash{ new_graph.semantic_hash() };
 	std::lock_guard<std::mutex> lock(output_mutex);
 	output_graph = new_graph;
+	output_semantic_hash = semantic_hash;
 	_output_updated = true;
 }
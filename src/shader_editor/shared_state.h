@@ -6,9 +6,15 @@
  */
 
 #include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <string>
 
+#include <boost/optional.hpp>
+
+#include "shader_graph/graph.h"
+#include "shader_graph/serialize.h"
+
 /**
  * @brief Thread-safe class to allow the main window thread to send out a serialized graph to another thread
  */
@@ -18,12 +24,17 @@ namespace cse {
 
 		bool input_updated();
 		bool output_updated();
+		// True when the pending output differs from the last output read only in layout, such as node positions
+		bool output_layout_only();
 
 		std::string get_input_graph();
 		void set_input_graph(const std::string& new_graph);
 
 		std::string get_output_graph();
-		void set_output_graph(const std::string& new_graph);
+		// Patch from the graph last read by either get function to the pending output, see csg::apply_patch
+		// The first patch read is from an empty graph
+		std::string get_output_patch();
+		void set_output_graph(const csg::Graph& new_graph);
 
 		void request_stop() { return stop.store(true); }
 		bool should_stop() { return stop.load(); }
@@ -35,8 +46,16 @@ namespace cse {
 		bool _input_updated{ false };
 
 		std::mutex output_mutex;
-		std::string output_graph;
+		// Graphs are kept rather than serialized strings, they are cheap to copy and only serialized when read
+		boost::optional<csg::Graph> output_graph;
+		boost::optional<csg::Graph> read_graph;
 		bool _output_updated{ false };
+		uint64_t output_semantic_hash{ 0 };
+		boost::optional<uint64_t> read_semantic_hash;
+
+		// Separate from output_mutex so serializing never blocks the window thread
+		std::mutex serialize_mutex;
+		csg::SerializeCache serialize_cache;
 
 		std::atomic<bool> stop{ false };
 	};
@@ -1,10 +1,16 @@
 #include "subwindow_debug.h"
 
+#include <array>
 #include <atomic>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <boost/optional.hpp>
 #include <imgui.h>
@@ -12,16 +18,25 @@
 #include "shader_core/lerp.h"
 #include "shader_core/util_enum.h"
 #include "shader_core/vector.h"
+#include "shader_graph/bake.h"
+#include "shader_graph/curves.h"
 #include "shader_graph/graph.h"
+#include "shader_graph/library.h"
 #include "shader_graph/node.h"
 #include "shader_graph/node_enums.h"
+#include "shader_graph/node_schema.h"
 #include "shader_graph/node_type.h"
+#include "shader_graph/ramp.h"
+#include "shader_graph/serialize.h"
 #include "shader_graph/slot.h"
+#include "shader_graph/slot_id.h"
 
+#include "benchmark.h"
 #include "enum.h"
 #include "event.h"
+#include "heap_counter.h"
 
-cse::DebugSubwindow::DebugSubwindow() : message("Pres butan to run validation.")
+cse::DebugSubwindow::DebugSubwindow() : message("Pres butan to run validation."), benchmark_message("Select a benchmark to run.")
 {
 
 }
@@ -55,12 +70,80 @@ cse::InterfaceEventArray cse::DebugSubwindow::run() const
 			ImGui::Text("csg::Slot: %ld", sizeof(csg::Slot));
 			ImGui::Text("   ::SlotValue: %ld", sizeof(csg::SlotValue));
 			ImGui::Text("   ::SlotValueUnion: %ld", csg::SlotValue::sizeof_union());
+			ImGui::Text("csg::NodeSchema: %ld", sizeof(csg::NodeSchema));
+			{
+				// Slot storage of one node of each type, before and after slot metadata moved to NodeSchema
+				size_t slot_bytes{ 0 };
+				size_t value_bytes{ 0 };
+				for (const csg::NodeType this_type : csg::NodeTypeList{}) {
+					const csg::NodeSchema& schema{ csg::NodeSchema::from(this_type) };
+					slot_bytes += schema.slots().size() * sizeof(csg::Slot);
+					value_bytes += schema.default_values().size() * sizeof(csg::SlotValue);
+				}
+				const size_t type_count{ static_cast<size_t>(csg::NodeType::COUNT) };
+				ImGui::Text("   ::per node, Slot vector: %ld", slot_bytes / type_count);
+				ImGui::Text("   ::per node, SlotValue vector: %ld", value_bytes / type_count);
+			}
 			ImGui::Text("std::string: %ld", sizeof(std::string));
 			ImGui::EndTabItem();
 		}
 		if (ImGui::BeginTabItem("Runtime")) {
 			ImGui::Text("cse::InterfaceEventArray max size: %ld", cse::InterfaceEventArray::max_used.load());
+			if (HeapCounter::active()) {
+				// This window runs once per frame, so the difference from the last run is one frame of allocations
+				static uint64_t last_allocations{ 0 };
+				const uint64_t allocations{ HeapCounter::allocations() };
+				ImGui::Text("Heap allocations last frame: %llu", static_cast<unsigned long long>(allocations - last_allocations));
+				last_allocations = allocations;
+			}
+			ImGui::EndTabItem();
+		}
+#ifdef CSE_BENCHMARKS
+		if (ImGui::BeginTabItem("Benchmark")) {
+			constexpr size_t BUTTONS_PER_ROW{ 6 };
+			struct BenchmarkButton {
+				const char* label;
+				std::string (*run)();
+			};
+			static const std::vector<BenchmarkButton> BUTTONS{
+				{ "Graph storage", Benchmark::graph_storage },
+				{ "Graph connections", Benchmark::graph_connections },
+				{ "Undo snapshot", Benchmark::undo_snapshot },
+				{ "Node creation", Benchmark::node_creation },
+				{ "Slot access", Benchmark::slot_access },
+				{ "Slot edit", Benchmark::slot_edit },
+				{ "Transaction", Benchmark::graph_transaction },
+				{ "Journal", Benchmark::graph_journal },
+				{ "Serialize", Benchmark::serialize },
+				{ "Deserialize", Benchmark::deserialize },
+				{ "Binary format", Benchmark::binary_format },
+				{ "Streaming", Benchmark::streaming },
+				{ "Library", Benchmark::graph_library },
+				{ "Patch", Benchmark::graph_patch },
+				{ "Serialize cache", Benchmark::serialize_cache },
+				{ "Lazy load", Benchmark::lazy_load },
+				{ "Parallel load", Benchmark::parallel_load },
+				{ "Curve eval", Benchmark::curve_eval },
+				{ "Curve batch", Benchmark::curve_batch },
+				{ "Color ramp", Benchmark::color_ramp },
+				{ "Bake cache", Benchmark::bake_cache },
+				{ "Curve hermite", Benchmark::curve_hermite },
+			};
+
+			ImGui::Text("Benchmarks block the UI until they finish.");
+			for (size_t i = 0; i < BUTTONS.size(); i++) {
+				if (i % BUTTONS_PER_ROW != 0) {
+					ImGui::SameLine();
+				}
+				if (ImGui::Button(BUTTONS[i].label)) {
+					events.push(InterfaceEvent{ InterfaceEventType::BENCHMARK_SET_MESSAGE, SubwindowId::DEBUG, BUTTONS[i].run() });
+				}
+			}
+			ImGui::Separator();
+			ImGui::Text("%s", benchmark_message.c_str());
+			ImGui::EndTabItem();
 		}
+#endif
 		ImGui::EndTabBar();
 	}
 	ImGui::End();
@@ -76,6 +159,9 @@ void cse::DebugSubwindow::do_event(const InterfaceEvent& event)
 	if (event.type() == InterfaceEventType::VALIDATE_SET_MESSAGE && event.message()) {
 		message = event.message().get();
 	}
+	else if (event.type() == InterfaceEventType::BENCHMARK_SET_MESSAGE && event.message()) {
+		benchmark_message = event.message().get();
+	}
 }
 
 std::string cse::DebugSubwindow::run_validation() const
@@ -209,6 +295,321 @@ std::string cse::DebugSubwindow::run_validation() const
 				}
 			}
 
+			{
+				csg::Graph test_graph{ csg::GraphType::EMPTY };
+				const csg::NodeId node_a{ test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				const csg::NodeId node_b{ test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				const csg::NodeId node_c{ test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				test_graph.add_connection(csg::SlotId{ node_a, 0 }, csg::SlotId{ node_b, 2 });
+				test_graph.add_connection(csg::SlotId{ node_b, 0 }, csg::SlotId{ node_c, 2 });
+				test_graph.add_connection(csg::SlotId{ node_a, 0 }, csg::SlotId{ node_c, 2 });
+				const bool valid_replace{ test_graph.connections().size() == 2 && test_graph.output_connections(node_a).size() == 2 };
+				if (!valid_replace) {
+					++error_count;
+					out_stream << "csg::Graph::add_connection did not replace the existing connection to a slot" << std::endl;
+				}
+				test_graph.remove(std::set<csg::NodeId>{ node_a });
+				const bool valid_remove{ test_graph.connections().empty() && test_graph.input_connections(node_b).empty() };
+				if (!valid_remove) {
+					++error_count;
+					out_stream << "csg::Graph::remove did not remove connections to the removed node" << std::endl;
+				}
+			}
+
+			{
+				csg::Graph test_graph{ csg::GraphType::MATERIAL };
+				const csg::NodeId node_a{ test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				const csg::NodeId node_b{ test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				const csg::Graph original_graph{ test_graph };
+				const uint64_t original_hash{ test_graph.content_hash() };
+				test_graph.set_float(csg::SlotId{ node_a, 2 }, 1.0f);
+				const bool valid_hash_change{ test_graph.content_hash() != original_hash && test_graph != original_graph };
+				if (!valid_hash_change) {
+					++error_count;
+					out_stream << "csg::Graph::content_hash did not change after a slot value changed" << std::endl;
+				}
+				test_graph.set_float(csg::SlotId{ node_a, 2 }, 0.0f);
+				test_graph.raise(node_a);
+				const bool valid_hash_restore{ test_graph.content_hash() == original_hash && test_graph == original_graph };
+				if (!valid_hash_restore) {
+					++error_count;
+					out_stream << "csg::Graph::content_hash did not return to its original value after reverting changes" << std::endl;
+				}
+				test_graph.add_connection(csg::SlotId{ node_a, 0 }, csg::SlotId{ node_b, 2 });
+				test_graph.remove_connection(csg::SlotId{ node_b, 2 });
+				if (test_graph.content_hash() != original_hash) {
+					++error_count;
+					out_stream << "csg::Graph::content_hash did not return to its original value after removing a connection" << std::endl;
+				}
+			}
+
+			{
+				// Build the same shader twice, so each copy gets different node ids
+				csg::Graph graph_a{ csg::GraphType::EMPTY };
+				csg::Graph graph_b{ csg::GraphType::EMPTY };
+				csg::NodeId last_math_id{ 0 };
+				for (csg::Graph* const this_graph : { &graph_a, &graph_b }) {
+					const csg::NodeId output_id{ this_graph->add(csg::NodeType::MATERIAL_OUTPUT, csc::Int2{ 0, 0 }) };
+					const csg::NodeId emission_id{ this_graph->add(csg::NodeType::EMISSION, csc::Int2{ 0, 0 }) };
+					const csg::NodeId math_id{ this_graph->add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+					this_graph->add_connection(csg::SlotId{ emission_id, 0 }, csg::SlotId{ output_id, 0 });
+					this_graph->add_connection(csg::SlotId{ math_id, 0 }, csg::SlotId{ emission_id, 2 });
+					last_math_id = math_id;
+				}
+				const bool valid_semantic_equal{ graph_a.semantic_hash() == graph_b.semantic_hash() };
+				if (!valid_semantic_equal) {
+					++error_count;
+					out_stream << "csg::Graph::semantic_hash differs for identical graphs with different ids" << std::endl;
+				}
+				graph_b.move(std::set<csg::NodeId>{ last_math_id }, csc::Float2{ 100.0f, 50.0f });
+				graph_b.add(csg::NodeType::MATH, csc::Int2{ 0, 0 });
+				const bool valid_semantic_layout{ graph_a.semantic_hash() == graph_b.semantic_hash() };
+				if (!valid_semantic_layout) {
+					++error_count;
+					out_stream << "csg::Graph::semantic_hash changed after moving nodes or adding a disconnected node" << std::endl;
+				}
+				graph_b.set_float(csg::SlotId{ last_math_id, 2 }, 1.0f);
+				const bool valid_semantic_value{ graph_a.semantic_hash() != graph_b.semantic_hash() };
+				if (!valid_semantic_value) {
+					++error_count;
+					out_stream << "csg::Graph::semantic_hash did not change after changing a connected node" << std::endl;
+				}
+			}
+
+			{
+				csg::Graph test_graph{ csg::GraphType::MATERIAL };
+				const csg::NodeId node_a{ test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				const csg::Graph original_graph{ test_graph };
+				{
+					csg::Graph::Transaction transaction{ test_graph };
+					const csg::NodeId node_b{ transaction.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+					transaction.add_connection(csg::SlotId{ node_a, 0 }, csg::SlotId{ node_b, 2 });
+					transaction.set_float(csg::SlotId{ node_a, 2 }, 1.0f);
+					// Not a float slot, so the whole transaction must fail
+					transaction.set_float(csg::SlotId{ node_a, 0 }, 1.0f);
+					const bool valid_rollback{ transaction.commit() == false && test_graph == original_graph };
+					if (!valid_rollback) {
+						++error_count;
+						out_stream << "csg::Graph::Transaction::commit did not roll back after a failed edit" << std::endl;
+					}
+				}
+				{
+					csg::Graph::Transaction transaction{ test_graph };
+					const csg::NodeId node_b{ transaction.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+					transaction.add_connection(csg::SlotId{ node_a, 0 }, csg::SlotId{ node_b, 2 });
+					transaction.remove(node_a);
+					const bool valid_commit{ transaction.commit() && test_graph.nodes().size() == 2 && test_graph.connections().empty() };
+					if (!valid_commit) {
+						++error_count;
+						out_stream << "csg::Graph::Transaction::commit did not apply all edits" << std::endl;
+					}
+				}
+			}
+
+			{
+				csg::Graph test_graph{ csg::GraphType::EMPTY };
+				test_graph.set_journal_enabled(true);
+				const uint64_t start_version{ test_graph.journal()->version() };
+				const csg::NodeId node_a{ test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				const csg::NodeId node_b{ test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				test_graph.add_connection(csg::SlotId{ node_a, 0 }, csg::SlotId{ node_b, 2 });
+				test_graph.set_float(csg::SlotId{ node_a, 2 }, 1.0f);
+				test_graph.set_float(csg::SlotId{ node_a, 2 }, 1.0f);
+				const uint64_t middle_version{ test_graph.journal()->version() };
+				test_graph.remove(std::set<csg::NodeId>{ node_a });
+				const std::vector<csg::GraphChangeType> expected_types{
+					csg::GraphChangeType::NODE_ADDED,
+					csg::GraphChangeType::NODE_ADDED,
+					csg::GraphChangeType::CONNECTION_ADDED,
+					csg::GraphChangeType::SLOT_VALUE_CHANGED,
+					csg::GraphChangeType::CONNECTION_REMOVED,
+					csg::GraphChangeType::NODE_REMOVED,
+				};
+				const boost::optional<std::vector<csg::GraphChange>> all_changes{ test_graph.journal()->changes_since(start_version) };
+				bool valid_types{ all_changes.has_value() && all_changes->size() == expected_types.size() };
+				for (size_t i = 0; valid_types && i < expected_types.size(); i++) {
+					valid_types = (*all_changes)[i].type() == expected_types[i];
+				}
+				if (!valid_types) {
+					++error_count;
+					out_stream << "csg::GraphJournal did not record the expected changes" << std::endl;
+				}
+				const boost::optional<std::vector<csg::GraphChange>> recent_changes{ test_graph.journal()->changes_since(middle_version) };
+				const bool valid_recent{ recent_changes.has_value() && recent_changes->size() == 2 };
+				if (!valid_recent) {
+					++error_count;
+					out_stream << "csg::GraphJournal::changes_since returned the wrong changes for a recent version" << std::endl;
+				}
+				csg::Graph copy_graph{ test_graph };
+				test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 });
+				copy_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 });
+				const bool valid_branch{ copy_graph.journal()->changes_since(test_graph.journal()->version()).has_value() == false };
+				if (!valid_branch) {
+					++error_count;
+					out_stream << "csg::GraphJournal::changes_since accepted a version from a diverged copy" << std::endl;
+				}
+			}
+
+			{
+				csg::Graph test_graph{ csg::GraphType::MATERIAL };
+				const csg::NodeId node_a{ test_graph.add(csg::NodeType::MATH, csc::Int2{ -20, 35 }) };
+				const csg::NodeId node_b{ test_graph.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				test_graph.set_float(csg::SlotId{ node_a, 2 }, 0.1234f);
+				test_graph.set_float(csg::SlotId{ node_a, 3 }, -2.5f);
+				test_graph.set_float(csg::SlotId{ node_b, 2 }, 1234.0001f);
+				test_graph.add_connection(csg::SlotId{ node_a, 0 }, csg::SlotId{ node_b, 2 });
+				const boost::optional<csg::Graph> parsed_graph{ csg::Graph::from(test_graph.serialize()) };
+				if (parsed_graph.has_value() == false || *parsed_graph != test_graph) {
+					++error_count;
+					out_stream << "csg::Graph::from did not reproduce a serialized graph" << std::endl;
+				}
+				// Binary graphs keep exact values, so this holds even for values the text format would round
+				test_graph.set_float(csg::SlotId{ node_b, 3 }, 1.0f / 3.0f);
+				const boost::optional<csg::Graph> binary_graph{ csg::Graph::from(test_graph.serialize_binary()) };
+				if (binary_graph.has_value() == false || *binary_graph != test_graph) {
+					++error_count;
+					out_stream << "csg::Graph::from did not reproduce a binary serialized graph" << std::endl;
+				}
+				std::string truncated_binary{ test_graph.serialize_binary() };
+				truncated_binary.pop_back();
+				if (csg::Graph::from(truncated_binary).has_value()) {
+					++error_count;
+					out_stream << "csg::Graph::from accepted a truncated binary graph" << std::endl;
+				}
+				std::stringstream graph_stream;
+				const bool stream_written{ test_graph.serialize(graph_stream) };
+				if (stream_written == false || graph_stream.str() != test_graph.serialize()) {
+					++error_count;
+					out_stream << "csg::Graph::serialize wrote different text to a stream" << std::endl;
+				}
+				const boost::optional<csg::Graph> streamed_graph{ csg::Graph::from(graph_stream) };
+				if (streamed_graph.has_value() == false || streamed_graph->serialize() != test_graph.serialize()) {
+					++error_count;
+					out_stream << "csg::Graph::from did not reproduce a graph read from a stream" << std::endl;
+				}
+			}
+
+			{
+				std::map<std::string, csg::Graph> graphs;
+				graphs.emplace("empty", csg::Graph{ csg::GraphType::EMPTY });
+				csg::Graph mix_graph{ csg::GraphType::MATERIAL };
+				const csg::NodeId mix_id{ mix_graph.add(csg::NodeType::MIX_RGB, csc::Int2{ 10, 20 }) };
+				mix_graph.set_float(csg::SlotId{ mix_id, 3 }, 1.0f / 3.0f);
+				graphs.emplace("mix", mix_graph);
+				graphs.emplace("material", csg::Graph{ csg::GraphType::MATERIAL });
+				const std::string library_bytes{ csg::serialize_library(graphs) };
+				const boost::optional<csg::GraphLibrary> library{ csg::GraphLibrary::from(library_bytes) };
+				if (library.has_value() == false || library->size() != graphs.size()) {
+					++error_count;
+					out_stream << "csg::GraphLibrary::from did not read a library" << std::endl;
+				}
+				else {
+					for (const auto& name_graph : graphs) {
+						const boost::optional<csg::Graph> loaded_graph{ library->load(name_graph.first) };
+						if (loaded_graph.has_value() == false || *loaded_graph != name_graph.second) {
+							++error_count;
+							out_stream << "csg::GraphLibrary::load did not reproduce graph " << name_graph.first << std::endl;
+						}
+					}
+					if (library->find("missing").has_value()) {
+						++error_count;
+						out_stream << "csg::GraphLibrary::find found a name that is not in the library" << std::endl;
+					}
+				}
+				if (csg::GraphLibrary::from(boost::string_view{ library_bytes }.substr(0, library_bytes.size() - 1)).has_value()) {
+					++error_count;
+					out_stream << "csg::GraphLibrary::from accepted a truncated library" << std::endl;
+				}
+			}
+
+			{
+				csg::Graph graph_a{ csg::GraphType::MATERIAL };
+				const csg::NodeId node_a{ graph_a.add(csg::NodeType::MATH, csc::Int2{ 0, 0 }) };
+				const csg::NodeId node_b{ graph_a.add(csg::NodeType::MATH, csc::Int2{ 100, 0 }) };
+				graph_a.add_connection(csg::SlotId{ node_a, 0 }, csg::SlotId{ node_b, 2 });
+				csg::Graph graph_b{ graph_a };
+				graph_b.set_float(csg::SlotId{ node_b, 3 }, 0.75f);
+				graph_b.move(std::set<csg::NodeId>{ node_a }, csc::Float2{ 10.0f, -5.0f });
+				graph_b.remove_connection(csg::SlotId{ node_b, 2 });
+				const csg::NodeId node_c{ graph_b.add(csg::NodeType::MIX_RGB, csc::Int2{ 50, 50 }) };
+				graph_b.add_connection(csg::SlotId{ node_c, 0 }, csg::SlotId{ node_b, 2 });
+				const std::string patch{ csg::diff(graph_a, graph_b) };
+				// Apply to a graph that shares no nodes with graph_a, as a host would have
+				const boost::optional<csg::Graph> host_graph{ csg::Graph::from(graph_a.serialize_binary()) };
+				csg::Graph patched_graph{ host_graph ? *host_graph : csg::Graph{ csg::GraphType::EMPTY } };
+				if (csg::apply_patch(patched_graph, patch) == false || patched_graph != graph_b) {
+					++error_count;
+					out_stream << "csg::apply_patch did not reproduce the patched graph" << std::endl;
+				}
+				csg::Graph unpatched_graph{ graph_a };
+				if (csg::apply_patch(unpatched_graph, patch.substr(0, patch.size() - 1)) || unpatched_graph != graph_a) {
+					++error_count;
+					out_stream << "csg::apply_patch accepted a truncated patch or modified the graph" << std::endl;
+				}
+				csg::SerializeCache serialize_cache;
+				serialize_cache.serialize(graph_a);
+				if (serialize_cache.serialize(graph_b) != graph_b.serialize()) {
+					++error_count;
+					out_stream << "csg::SerializeCache wrote different text than serialize_graph" << std::endl;
+				}
+			}
+
+			{
+				csg::Graph test_graph{ csg::GraphType::MATERIAL };
+				const csg::NodeId ramp_id{ test_graph.add(csg::NodeType::COLOR_RAMP, csc::Int2{ 0, 0 }) };
+				const csg::NodeId curves_id{ test_graph.add(csg::NodeType::RGB_CURVES, csc::Int2{ 100, 0 }) };
+				const std::vector<csg::ColorRampPoint> ramp_points{
+					csg::ColorRampPoint{ 0.0f, csc::Float3{ 0.0f, 0.0f, 0.0f }, 1.0f },
+					csg::ColorRampPoint{ 0.25f, csc::Float3{ 1.0f, 0.5f, 0.0f }, 1.0f },
+					csg::ColorRampPoint{ 1.0f, csc::Float3{ 1.0f, 1.0f, 1.0f }, 0.5f },
+				};
+				test_graph.set_color_ramp(csg::SlotId{ ramp_id, 2 }, csg::ColorRamp{ ramp_points });
+				test_graph.set_float(csg::SlotId{ ramp_id, 3 }, 0.25f);
+				test_graph.add_connection(csg::SlotId{ ramp_id, 0 }, csg::SlotId{ curves_id, 3 });
+				const std::string graph_string{ test_graph.serialize() };
+				const boost::optional<csg::Graph> full_graph{ csg::deserialize_graph(graph_string) };
+				const boost::optional<csg::LazyGraph> lazy_graph{ csg::LazyGraph::from(graph_string) };
+				if (full_graph.has_value() == false || lazy_graph.has_value() == false ||
+					lazy_graph->nodes().size() != full_graph->nodes().size() || lazy_graph->connections().size() != 1)
+				{
+					++error_count;
+					out_stream << "csg::LazyGraph::from did not index a graph" << std::endl;
+				}
+				else {
+					for (const csg::SlotId slot_id : { csg::SlotId{ ramp_id, 2 }, csg::SlotId{ ramp_id, 3 }, csg::SlotId{ curves_id, 1 } }) {
+						const csg::SlotValue* const lazy_value{ lazy_graph->get_slot_value_ptr(slot_id) };
+						if (lazy_value == nullptr || *lazy_value != *full_graph->get_slot_value_ptr(slot_id)) {
+							++error_count;
+							out_stream << "csg::LazyGraph parsed a different slot value than deserialize_graph" << std::endl;
+						}
+					}
+					if (lazy_graph->to_graph() != *full_graph) {
+						++error_count;
+						out_stream << "csg::LazyGraph::to_graph did not reproduce the graph" << std::endl;
+					}
+				}
+			}
+
+			{
+				// Large enough that the node section is split between threads
+				csg::Graph test_graph{ csg::GraphType::MATERIAL };
+				boost::optional<csg::NodeId> previous_id;
+				for (int i = 0; i < 4000; i++) {
+					const csg::NodeId id{ test_graph.add(csg::NodeType::MATH, csc::Int2{ i, -i }) };
+					test_graph.set_float(csg::SlotId{ id, 2 }, static_cast<float>(i));
+					if (previous_id) {
+						test_graph.add_connection(csg::SlotId{ *previous_id, 0 }, csg::SlotId{ id, 3 });
+					}
+					previous_id = id;
+				}
+				const std::string graph_string{ test_graph.serialize() };
+				const boost::optional<csg::Graph> parallel_graph{ csg::deserialize_graph(graph_string, 4) };
+				if (parallel_graph.has_value() == false || *parallel_graph != test_graph) {
+					++error_count;
+					out_stream << "csg::deserialize_graph with threads did not reproduce the graph" << std::endl;
+				}
+			}
+
 			if (error_count == error_count_begin) {
 				out_stream << "graph.h tests passed" << std::endl;
 			}
@@ -216,6 +617,267 @@ std::string cse::DebugSubwindow::run_validation() const
 				out_stream << "graph.h tests failed, see above" << std::endl;
 			}
 		}
+		// curves.h
+		{
+			const size_t error_count_begin{ error_count };
+
+			{
+				const csg::Curve default_curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f } };
+				const bool valid_default{
+					default_curve.eval_point(-1.0f) == 0.0f &&
+					std::abs(default_curve.eval_point(0.3f) - 0.3f) < 0.001f &&
+					default_curve.eval_point(2.0f) == 1.0f
+				};
+				if (!valid_default) {
+					++error_count;
+					out_stream << "csg::Curve default curve is not a straight line from min to max" << std::endl;
+				}
+			}
+
+			{
+				const std::vector<csg::CurvePoint> points{
+					csg::CurvePoint{ csc::Float2{ 0.0f, 0.2f }, csg::CurveInterp::CUBIC_HERMITE },
+					csg::CurvePoint{ csc::Float2{ 0.1f, 0.9f }, csg::CurveInterp::LINEAR },
+					csg::CurvePoint{ csc::Float2{ 0.7f, 0.4f }, csg::CurveInterp::CUBIC_HERMITE },
+					csg::CurvePoint{ csc::Float2{ 1.0f, 0.6f }, csg::CurveInterp::CUBIC_HERMITE },
+				};
+				csg::Curve curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f }, points };
+				for (const csg::CurvePoint& this_point : points) {
+					if (curve.eval_point(this_point.pos.x) != this_point.pos.y) {
+						++error_count;
+						out_stream << "csg::Curve::eval_point did not pass through a control point" << std::endl;
+					}
+				}
+
+				const csg::Curve unmoved_curve{ curve };
+				const size_t moved_index{ curve.move_point(1, csc::Float2{ 0.5f, 0.1f }) };
+				if (curve.eval_point(0.5f) != 0.1f || curve.control_points()[moved_index].pos.y != 0.1f) {
+					++error_count;
+					out_stream << "csg::Curve::eval_point did not follow a moved point" << std::endl;
+				}
+				if (unmoved_curve.eval_point(0.1f) != 0.9f) {
+					++error_count;
+					out_stream << "csg::Curve::move_point changed a copy of the curve" << std::endl;
+				}
+				const float linear_result{ curve.eval_point(0.6f) };
+				curve.set_interp(moved_index, csg::CurveInterp::CUBIC_HERMITE);
+				if (curve.eval_point(0.6f) == linear_result) {
+					++error_count;
+					out_stream << "csg::Curve::set_interp did not change the curve" << std::endl;
+				}
+			}
+
+			{
+				csg::RGBCurveSlotValue rgb_curves;
+				rgb_curves.set_all(csg::Curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f }, std::vector<csg::CurvePoint>{
+					csg::CurvePoint{ csc::Float2{ 0.0f, 0.1f }, csg::CurveInterp::CUBIC_HERMITE },
+					csg::CurvePoint{ csc::Float2{ 0.4f, 0.7f }, csg::CurveInterp::CUBIC_HERMITE },
+					csg::CurvePoint{ csc::Float2{ 1.0f, 0.9f }, csg::CurveInterp::LINEAR },
+				} });
+				rgb_curves.set_g(csg::Curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f }, std::vector<csg::CurvePoint>{
+					csg::CurvePoint{ csc::Float2{ 0.0f, 1.0f }, csg::CurveInterp::LINEAR },
+					csg::CurvePoint{ csc::Float2{ 1.0f, 0.0f }, csg::CurveInterp::LINEAR },
+				} });
+				// Enough colors to use the SIMD path as well as the remainder after it
+				std::vector<float> colors;
+				for (size_t i = 0; i < 37 * 4; i++) {
+					colors.push_back(static_cast<float>(i % 23) / 20.0f - 0.05f);
+				}
+				std::vector<float> curved_colors(colors.size());
+				rgb_curves.eval_many(colors.data(), curved_colors.data(), colors.size() / 4);
+				const std::array<const csg::Curve*, 3> channel_curves{ &rgb_curves.get_r(), &rgb_curves.get_g(), &rgb_curves.get_b() };
+				for (size_t i = 0; i < colors.size(); i++) {
+					const size_t channel{ i % 4 };
+					const float expected{ (channel == 3) ? colors[i] : channel_curves[channel]->eval_point(rgb_curves.get_all().eval_point(colors[i])) };
+					if (curved_colors[i] != expected) {
+						++error_count;
+						out_stream << "csg::RGBCurveSlotValue::eval_many did not match eval_point" << std::endl;
+						break;
+					}
+				}
+			}
+
+			{
+				// The middle segment's x only increases, so each x along its spline should give back that point's y
+				const csg::Curve curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f }, std::vector<csg::CurvePoint>{
+					csg::CurvePoint{ csc::Float2{ 0.0f, 0.0f }, csg::CurveInterp::CUBIC_HERMITE },
+					csg::CurvePoint{ csc::Float2{ 0.4f, 0.1f }, csg::CurveInterp::CUBIC_HERMITE },
+					csg::CurvePoint{ csc::Float2{ 0.6f, 0.9f }, csg::CurveInterp::CUBIC_HERMITE },
+					csg::CurvePoint{ csc::Float2{ 1.0f, 1.0f }, csg::CurveInterp::CUBIC_HERMITE },
+				} };
+				const auto do_hermite = [](const float p0, const float p1, const float p2, const float p3, const float t) -> float {
+					const float a{ -p0 / 2.0f + (3.0f * p1) / 2.0f - (3.0f * p2) / 2.0f + p3 / 2.0f };
+					const float b{ p0 - (5.0f * p1) / 2.0f + 2.0f * p2 - p3 / 2.0f };
+					const float c{ -p0 / 2.0f + p2 / 2.0f };
+					return a * t * t * t + b * t * t + c * t + p1;
+				};
+				for (size_t i = 1; i < 20; i++) {
+					const float t{ static_cast<float>(i) / 20.0f };
+					const float x{ do_hermite(0.0f, 0.4f, 0.6f, 1.0f, t) };
+					const float y{ do_hermite(0.0f, 0.1f, 0.9f, 1.0f, t) };
+					if (std::abs(curve.eval_point(x) - y) > 0.0001f) {
+						++error_count;
+						out_stream << "csg::Curve::eval_point did not follow a hermite segment" << std::endl;
+						break;
+					}
+				}
+			}
+
+			{
+				// A point created between hermite points is hermite, and must evaluate as one
+				csg::Curve curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f }, std::vector<csg::CurvePoint>{
+					csg::CurvePoint{ csc::Float2{ 0.0f, 0.0f }, csg::CurveInterp::CUBIC_HERMITE },
+					csg::CurvePoint{ csc::Float2{ 0.3f, 0.8f }, csg::CurveInterp::CUBIC_HERMITE },
+					csg::CurvePoint{ csc::Float2{ 1.0f, 1.0f }, csg::CurveInterp::CUBIC_HERMITE },
+				} };
+				curve.create_point(0.6f);
+				const csg::Curve rebuilt_curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f }, curve.control_points() };
+				for (const float x : { 0.2f, 0.5f, 0.7f, 0.9f }) {
+					if (curve.eval_point(x) != rebuilt_curve.eval_point(x)) {
+						++error_count;
+						out_stream << "csg::Curve::create_point did not match a curve built from its points" << std::endl;
+						break;
+					}
+				}
+			}
+
+			if (error_count == error_count_begin) {
+				out_stream << "curves.h tests passed" << std::endl;
+			}
+			else {
+				out_stream << "curves.h tests failed, see above" << std::endl;
+			}
+		}
+		// ramp.h
+		{
+			const size_t error_count_begin{ error_count };
+
+			{
+				const csg::ColorRamp default_ramp;
+				const bool valid_default{
+					default_ramp.eval(-1.0f) == csc::Float4(0.0f, 0.0f, 0.0f, 1.0f) &&
+					std::abs(default_ramp.eval(0.3f).y - 0.3f) < 0.001f &&
+					default_ramp.eval(2.0f) == csc::Float4(1.0f, 1.0f, 1.0f, 1.0f)
+				};
+				if (!valid_default) {
+					++error_count;
+					out_stream << "csg::ColorRamp default ramp is not a gradient from black to white" << std::endl;
+				}
+			}
+
+			{
+				csg::ColorRamp ramp{ std::vector<csg::ColorRampPoint>{
+					csg::ColorRampPoint{ 0.8f, csc::Float3{ 0.0f, 0.0f, 1.0f }, 1.0f },
+					csg::ColorRampPoint{ 0.1f, csc::Float3{ 1.0f, 0.0f, 0.0f }, 0.5f },
+					csg::ColorRampPoint{ 0.4f, csc::Float3{ 0.0f, 1.0f, 0.0f }, 1.0f },
+				} };
+				for (const csg::ColorRampPoint& this_point : ramp.get()) {
+					if (ramp.eval(this_point.pos) != csc::Float4(this_point.color, this_point.alpha)) {
+						++error_count;
+						out_stream << "csg::ColorRamp::eval did not pass through a control point" << std::endl;
+					}
+				}
+
+				std::vector<float> positions;
+				for (size_t i = 0; i < 23; i++) {
+					positions.push_back(static_cast<float>(i) / 20.0f - 0.05f);
+				}
+				std::vector<csc::Float4> colors(positions.size());
+				ramp.eval_many(positions.data(), colors.data(), positions.size());
+				for (size_t i = 0; i < positions.size(); i++) {
+					if (colors[i] != ramp.eval(positions[i])) {
+						++error_count;
+						out_stream << "csg::ColorRamp::eval_many did not match eval" << std::endl;
+						break;
+					}
+				}
+
+				ramp.set_lut_size(256);
+				const csg::ColorRamp unchanged_ramp{ ramp };
+				ramp.set(0, csg::ColorRampPoint{ 0.1f, csc::Float3{ 1.0f, 1.0f, 1.0f }, 1.0f });
+				if (ramp.lut_size() != 256 || ramp.eval_lut(0.0f) != csc::Float4(1.0f, 1.0f, 1.0f, 1.0f) || ramp.eval_lut(1.0f) != ramp.eval(1.0f)) {
+					++error_count;
+					out_stream << "csg::ColorRamp lookup table was not rebuilt by set" << std::endl;
+				}
+				if (unchanged_ramp.eval_lut(0.0f) != csc::Float4(1.0f, 0.0f, 0.0f, 0.5f)) {
+					++error_count;
+					out_stream << "csg::ColorRamp::set changed the lookup table of a copy" << std::endl;
+				}
+			}
+
+			if (error_count == error_count_begin) {
+				out_stream << "ramp.h tests passed" << std::endl;
+			}
+			else {
+				out_stream << "ramp.h tests failed, see above" << std::endl;
+			}
+		}
+		// bake.h
+		{
+			const size_t error_count_begin{ error_count };
+
+			csg::RGBCurveSlotValue rgb_curves;
+			rgb_curves.set_all(csg::Curve{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f }, std::vector<csg::CurvePoint>{
+				csg::CurvePoint{ csc::Float2{ 0.0f, 0.2f }, csg::CurveInterp::CUBIC_HERMITE },
+				csg::CurvePoint{ csc::Float2{ 0.6f, 0.3f }, csg::CurveInterp::CUBIC_HERMITE },
+				csg::CurvePoint{ csc::Float2{ 1.0f, 0.9f }, csg::CurveInterp::CUBIC_HERMITE },
+			} });
+			const csg::ColorRampSlotValue ramp{ csg::ColorRamp{ std::vector<csg::ColorRampPoint>{
+				csg::ColorRampPoint{ 0.2f, csc::Float3{ 1.0f, 0.0f, 0.0f }, 1.0f },
+				csg::ColorRampPoint{ 0.7f, csc::Float3{ 0.0f, 0.0f, 1.0f }, 0.5f },
+			} } };
+
+			{
+				const csg::BakedLut rgb_lut{ csg::bake_lut(rgb_curves, 33) };
+				const float x{ 20.0f / 32.0f };
+				const float expected{ rgb_curves.get_r().eval_point(rgb_curves.get_all().eval_point(x)) };
+				if (rgb_lut.resolution() != 33 || rgb_lut.channels != 3 || rgb_lut.values[20 * 3] != expected) {
+					++error_count;
+					out_stream << "csg::bake_lut did not sample the RGB curves" << std::endl;
+				}
+
+				const csg::BakedLut ramp_lut{ csg::bake_lut(ramp, 11) };
+				const csc::Float4 ramp_color{ ramp.get().eval(0.5f) };
+				const bool valid_ramp_lut{
+					ramp_lut.resolution() == 11 && ramp_lut.channels == 4 &&
+					ramp_lut.values[5 * 4 + 0] == ramp_color.x &&
+					ramp_lut.values[5 * 4 + 2] == ramp_color.z &&
+					ramp_lut.values[5 * 4 + 3] == ramp_color.w
+				};
+				if (!valid_ramp_lut) {
+					++error_count;
+					out_stream << "csg::bake_lut did not sample the color ramp" << std::endl;
+				}
+			}
+
+			{
+				csg::BakeCache cache{ 2 };
+				const std::shared_ptr<const csg::BakedLut> rgb_lut{ cache.bake(rgb_curves, 64) };
+				const csg::RGBCurveSlotValue rgb_copy{ rgb_curves };
+				if (cache.bake(rgb_copy, 64) != rgb_lut || cache.bake(rgb_curves, 128) == rgb_lut) {
+					++error_count;
+					out_stream << "csg::BakeCache did not find tables by content and resolution" << std::endl;
+				}
+				// The 128 entry table was used longest ago, so it is dropped for the ramp
+				cache.bake(rgb_curves, 64);
+				cache.bake(ramp, 64);
+				const size_t misses_before{ cache.misses() };
+				cache.bake(rgb_curves, 64);
+				const bool kept_recent{ cache.misses() == misses_before };
+				cache.bake(rgb_curves, 128);
+				if (kept_recent == false || cache.misses() != misses_before + 1 || cache.size() != 2) {
+					++error_count;
+					out_stream << "csg::BakeCache did not drop the table used longest ago" << std::endl;
+				}
+			}
+
+			if (error_count == error_count_begin) {
+				out_stream << "bake.h tests passed" << std::endl;
+			}
+			else {
+				out_stream << "bake.h tests failed, see above" << std::endl;
+			}
+		}
 	}
 	{
 		out_stream << "Checking NodeCategoryInfo for each NodeCategory..." << std::endl;
@@ -22,5 +22,6 @@ namespace cse {
 		std::string run_validation() const;
 
 		std::string message;
+		std::string benchmark_message;
 	};
 }
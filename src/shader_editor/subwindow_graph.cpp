@@ -4,7 +4,6 @@
 #include <cassert>
 #include <cmath>
 #include <cstdio>
-#include <list>
 #include <map>
 #include <set>
 #include <vector>
@@ -280,27 +279,37 @@ bool cse::GraphSubwindow::do_event(const InterfaceEvent& event)
 			{
 				std::map<csg::NodeId, csg::NodeId> old_to_new;
 				const std::set<csg::NodeId> original_selection{ node_selection.selected() };
-				node_selection.clear();
+				// Nodes and connections are applied together so a failure leaves the graph untouched
+				csg::Graph::Transaction transaction{ *the_graph };
 				// Duplicate each node and track the id mapping
 				for (const csg::NodeId original_id : original_selection) {
-					const boost::optional<csg::NodeId> opt_new_id { the_graph->duplicate(original_id) };
+					const boost::optional<csg::NodeId> opt_new_id { transaction.duplicate(original_id) };
 					if (opt_new_id.has_value()) {
 						old_to_new[original_id] = *opt_new_id;
-						node_selection.select(SelectMode::ADD, *opt_new_id);
 					}
 				}
-				// Duplicate connections
-				const std::list<csg::Connection> original_connections{ the_graph->connections() };
-				for (const csg::Connection this_conn : original_connections) {
-					if (old_to_new.count(this_conn.source().node_id()) + old_to_new.count(this_conn.dest().node_id()) < 2) {
-						// Both nodes for this connection were not duplicated, go next
+				// Duplicate connections, only those leaving a duplicated node can qualify
+				std::vector<csg::Connection> original_connections;
+				for (const auto& id_pair : old_to_new) {
+					const std::vector<csg::Connection>& node_connections{ the_graph->output_connections(id_pair.first) };
+					original_connections.insert(original_connections.end(), node_connections.begin(), node_connections.end());
+				}
+				for (const csg::Connection& this_conn : original_connections) {
+					if (old_to_new.count(this_conn.dest().node_id()) == 0) {
+						// The dest node for this connection was not duplicated, go next
 						continue;
 					}
 					const csg::SlotId new_source{ old_to_new[this_conn.source().node_id()],  this_conn.source().index() };
 					const csg::SlotId new_dest{ old_to_new[this_conn.dest().node_id()],  this_conn.dest().index() };
-					the_graph->add_connection(new_source, new_dest);
+					transaction.add_connection(new_source, new_dest);
+				}
+				if (transaction.commit()) {
+					node_selection.clear();
+					for (const auto& id_pair : old_to_new) {
+						node_selection.select(SelectMode::ADD, id_pair.second);
+					}
+					graph_altered = true;
 				}
-				graph_altered = true;
 				break;
 			}
 			case InterfaceEventType::SELECT_ALL:
@@ -413,7 +422,7 @@ cse::InterfaceEventArray cse::GraphSubwindow::process_event(const InputEvent& ev
 						if (slot) {
 							// Check if the slot has a value
 							// Slots with no value are unselectable
-							if (the_graph->get_slot_value(*slot)) {
+							if (the_graph->get_slot_value_ptr(*slot)) {
 								// Select the slot
 								const InterfaceEvent slot_event{ InterfaceEventType::SELECT_SLOT, *slot, boost::none };
 								new_events.push(slot_event);
@@ -614,7 +623,7 @@ void cse::GraphSubwindow::draw_nodes(ImDrawList* const draw_list) const
 		{
 			const csc::Float2 body_begin{ node_geom.pos() + csc::Float2{ 0.0f, NODE_HEADER_HEIGHT} };
 			// Lines between slots
-			for (unsigned int i = 1; i < node->slots().size(); i++) {
+			for (unsigned int i = 1; i < node->slot_count(); i++) {
 				const csc::Float2 p0{ body_begin + csc::Float2{ 0.0f, i * NODE_ROW_HEIGHT } };
 				const csc::Float2 p1{ node_geom.end().x, body_begin.y + NODE_ROW_HEIGHT * i };
 				ImGui::DrawList::AddLine(draw_list, p0, p1, COLOR_NODE_OUTLINE_DEFAULT);
@@ -626,7 +635,8 @@ void cse::GraphSubwindow::draw_nodes(ImDrawList* const draw_list) const
 
 			// Main body of slot
 			size_t slots_drawn{ 0 };
-			for (const auto& slot : node->slots()) {
+			for (const auto& slot : node->schema().slots()) {
+				const csg::SlotValue* const slot_value{ node->slot_value_ptr(slots_drawn) };
 
 				const bool highlight_this_slot = node_has_selected_slot && selected_slot->index() == slots_drawn;
 				if (highlight_this_slot) {
@@ -641,10 +651,10 @@ void cse::GraphSubwindow::draw_nodes(ImDrawList* const draw_list) const
 					const char* const slot_disp_name{ slot_disp_name_view.data() };
 					std::array<char, 96> label_text;
 					label_text.fill('\0');
-					if (slot.value) {
+					if (slot_value) {
 						if (slot.type() == csg::SlotType::BOOL) {
-							const auto bool_value{ slot.value->as<csg::BoolSlotValue>() };
-							assert(bool_value.has_value());
+							const csg::BoolSlotValue* const bool_value{ slot_value->as_ptr<csg::BoolSlotValue>() };
+							assert(bool_value != nullptr);
 							if (bool_value->get()) {
 								snprintf(label_text.data(), label_text.size() - 1, "%s: True", slot_disp_name);
 							}
@@ -653,8 +663,8 @@ void cse::GraphSubwindow::draw_nodes(ImDrawList* const draw_list) const
 							}
 						}
 						else if (slot.type() == csg::SlotType::COLOR) {
-							const auto color_value = slot.value->as<csg::ColorSlotValue>();
-							assert(color_value.has_value());
+							const csg::ColorSlotValue* const color_value{ slot_value->as_ptr<csg::ColorSlotValue>() };
+							assert(color_value != nullptr);
 							snprintf(label_text.data(), label_text.size() - 1, "%s: ", slot_disp_name);
 							const ImVec2 text_size{ ImGui::CalcTextSize(label_text.data()) };
 							const csc::Float2 color_rect_offset{ label_pos + csc::Float2{ text_size.x, 0.0f } };
@@ -671,8 +681,8 @@ void cse::GraphSubwindow::draw_nodes(ImDrawList* const draw_list) const
 							snprintf(label_text.data(), label_text.size() - 1, "%s: [Enum]", slot_disp_name);
 						}
 						else if (slot.type() == csg::SlotType::FLOAT) {
-							const auto float_value = slot.value->as<csg::FloatSlotValue>();
-							assert(float_value.has_value());
+							const csg::FloatSlotValue* const float_value{ slot_value->as_ptr<csg::FloatSlotValue>() };
+							assert(float_value != nullptr);
 							// Use snprintf to generate a pattern for another snprintf to get the label
 							// This is so the precision held by the slot is respected
 							std::array<char, 24> pattern_text;
@@ -682,8 +692,8 @@ void cse::GraphSubwindow::draw_nodes(ImDrawList* const draw_list) const
 							snprintf(label_text.data(), label_text.size() - 1, pattern_text.data(), slot_disp_name, float_value->get());
 						}
 						else if (slot.type() == csg::SlotType::INT) {
-							const auto int_value{ slot.value->as<csg::IntSlotValue>() };
-							assert(int_value.has_value());
+							const csg::IntSlotValue* const int_value{ slot_value->as_ptr<csg::IntSlotValue>() };
+							assert(int_value != nullptr);
 							snprintf(label_text.data(), label_text.size() - 1, "%s: %d", slot_disp_name, int_value->get());
 						}
 						else if (slot.type() == csg::SlotType::VECTOR) {
@@ -723,7 +733,7 @@ void cse::GraphSubwindow::draw_nodes(ImDrawList* const draw_list) const
 	}
 
 	// Draw connections
-	for (const csg::Connection conn : the_graph->connections()) {
+	for (const csg::Connection& conn : the_graph->connections()) {
 		const boost::optional<std::shared_ptr<const csg::Node>> node_src{ the_graph->get(conn.source().node_id()) };
 		if (node_src.has_value() == false || node_src->use_count() == 0) {
 			continue;
@@ -833,7 +843,7 @@ boost::optional<csg::SlotId> cse::GraphSubwindow::get_slot_at_pos(const csc::Flo
 		if (node_geom.rect().contains(world_pos)) {
 			const boost::optional<size_t> slot_id{ node_geom.slot_at_pos(world_pos) };
 			if (slot_id) {
-				const boost::optional<csg::Slot> slot{ node->slot(*slot_id) };
+				const csg::Slot* const slot{ node->slot(*slot_id) };
 				if (slot) {
 					// We have found a real slot, check that the direction matches before returning
 					if (direction) {
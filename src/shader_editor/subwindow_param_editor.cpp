@@ -64,10 +64,11 @@ cse::InterfaceEventArray cse::ParamEditorSubwindow::run() const
 	assert(opt_type_info.has_value());
 	const csg::NodeTypeInfo type_info{ opt_type_info.value() };
 
-	const auto opt_slot{ selected_node->slot(selected_slot->index()) };
-	if (opt_slot.has_value() == false) {
+	const csg::Slot* const opt_slot{ selected_node->slot(selected_slot->index()) };
+	if (opt_slot == nullptr) {
 		return result;
 	}
+	const csg::SlotValue* const slot_value{ selected_node->slot_value_ptr(selected_slot->index()) };
 
 	ImGui::SetNextWindowSizeConstraints(ImVec2{ 0.f, 0.f }, ImVec2{ 1000.f, 600.f });
 	if (ImGui::Begin("Parameter Editor", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
@@ -77,9 +78,9 @@ cse::InterfaceEventArray cse::ParamEditorSubwindow::run() const
 		ImGui::Dummy(ImVec2{ 230.0f, 1.0f });
 		ImGui::Separator();
 		if (opt_slot->dir() == csg::SlotDirection::INPUT) {
-			if (opt_slot->value.has_value()) {
+			if (slot_value) {
 				if (opt_slot->type() == csg::SlotType::BOOL) {
-					const auto opt_bool_val{ opt_slot->value->as<csg::BoolSlotValue>() };
+					const csg::BoolSlotValue* const opt_bool_val{ slot_value->as_ptr<csg::BoolSlotValue>() };
 					if (opt_bool_val) {
 						const InterfaceEventArray bool_event{ run_bool(*selected_slot, *opt_bool_val) };
 						result.push(bool_event);
@@ -89,7 +90,7 @@ cse::InterfaceEventArray cse::ParamEditorSubwindow::run() const
 					}
 				}
 				else if (opt_slot->type() == csg::SlotType::COLOR) {
-					const auto opt_color_val{ opt_slot->value->as<csg::ColorSlotValue>() };
+					const csg::ColorSlotValue* const opt_color_val{ slot_value->as_ptr<csg::ColorSlotValue>() };
 					if (opt_color_val) {
 						const InterfaceEventArray color_event{ run_color(*selected_slot, *opt_color_val) };
 						result.push(color_event);
@@ -99,7 +100,7 @@ cse::InterfaceEventArray cse::ParamEditorSubwindow::run() const
 					}
 				}
 				else if (opt_slot->type() == csg::SlotType::ENUM) {
-					const auto opt_enum_val{ opt_slot->value.value().as<csg::EnumSlotValue>() };
+					const csg::EnumSlotValue* const opt_enum_val{ slot_value->as_ptr<csg::EnumSlotValue>() };
 					if (opt_enum_val) {
 						const InterfaceEventArray enum_event{ run_enum(*selected_slot, *opt_enum_val) };
 						result.push(enum_event);
@@ -109,7 +110,7 @@ cse::InterfaceEventArray cse::ParamEditorSubwindow::run() const
 					}
 				}
 				else if (opt_slot->type() == csg::SlotType::FLOAT) {
-					const auto opt_float_val{ opt_slot->value.value().as<csg::FloatSlotValue>() };
+					const csg::FloatSlotValue* const opt_float_val{ slot_value->as_ptr<csg::FloatSlotValue>() };
 					if (opt_float_val) {
 						const InterfaceEventArray float_event{ run_float(*selected_slot, *opt_float_val) };
 						result.push(float_event);
@@ -119,7 +120,7 @@ cse::InterfaceEventArray cse::ParamEditorSubwindow::run() const
 					}
 				}
 				else if (opt_slot->type() == csg::SlotType::INT) {
-					const auto opt_int_val{ opt_slot->value.value().as<csg::IntSlotValue>() };
+					const csg::IntSlotValue* const opt_int_val{ slot_value->as_ptr<csg::IntSlotValue>() };
 					if (opt_int_val) {
 						const InterfaceEventArray int_event{ run_int(*selected_slot, *opt_int_val) };
 						result.push(int_event);
@@ -129,7 +130,7 @@ cse::InterfaceEventArray cse::ParamEditorSubwindow::run() const
 					}
 				}
 				else if (opt_slot->type() == csg::SlotType::VECTOR) {
-					const auto opt_vec_val{ opt_slot->value.value().as<csg::VectorSlotValue>() };
+					const csg::VectorSlotValue* const opt_vec_val{ slot_value->as_ptr<csg::VectorSlotValue>() };
 					if (opt_vec_val) {
 						const InterfaceEventArray vec_event{ run_vector(*selected_slot, *opt_vec_val) };
 						result.push(vec_event);
@@ -151,7 +152,7 @@ cse::InterfaceEventArray cse::ParamEditorSubwindow::run() const
 					}
 				}
 				else if (opt_slot->type() == csg::SlotType::COLOR_RAMP) {
-					const auto opt_ramp_val{ opt_slot->value.value().as<csg::ColorRampSlotValue>() };
+					const csg::ColorRampSlotValue* const opt_ramp_val{ slot_value->as_ptr<csg::ColorRampSlotValue>() };
 					if (opt_ramp_val) {
 						const InterfaceEventArray enum_events{ run_color_ramp(*selected_slot, *opt_ramp_val) };
 						result.push(enum_events);
@@ -334,13 +335,13 @@ cse::InterfaceEventArray cse::ParamEditorSubwindow::run_vector(const csg::SlotId
 	return result;
 }
 
-cse::InterfaceEventArray cse::ParamEditorSubwindow::run_color_ramp(csg::SlotId slot_id, csg::ColorRampSlotValue slot_value) const
+cse::InterfaceEventArray cse::ParamEditorSubwindow::run_color_ramp(const csg::SlotId slot_id, const csg::ColorRampSlotValue& slot_value) const
 {
 	InterfaceEventArray result;
 
 	const char* const float_format{ "%.3f" };
 
-	const csg::ColorRamp points{ slot_value.get() };
+	const csg::ColorRamp& points{ slot_value.get() };
 	for (size_t i = 0; i < points.size(); i++) {
 		const csg::ColorRampPoint this_point{ points.get(i) };
 
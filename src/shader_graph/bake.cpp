@@ -0,0 +1,176 @@
+#include "bake.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "shader_core/hash.h"
+#include "shader_core/vector.h"
+
+#include "curves.h"
+#include "ramp.h"
+#include "slot.h"
+
+static float lut_x(const float min_x, const float max_x, const size_t index, const size_t resolution)
+{
+	return min_x + (max_x - min_x) * static_cast<float>(index) / static_cast<float>(resolution - 1);
+}
+
+// Bakes slot values that evaluate four-channel arrays, keeping the first three channels
+template <typename T>
+static csg::BakedLut bake_curves(const T& value, const float min_x, const float max_x, const size_t resolution)
+{
+	assert(resolution >= 2);
+	std::vector<float> samples(resolution * 4);
+	for (size_t i = 0; i < resolution; i++) {
+		const float x{ lut_x(min_x, max_x, i, resolution) };
+		samples[i * 4 + 0] = x;
+		samples[i * 4 + 1] = x;
+		samples[i * 4 + 2] = x;
+		samples[i * 4 + 3] = 0.0f;
+	}
+	value.eval_many(samples.data(), samples.data(), resolution);
+
+	csg::BakedLut result{ min_x, max_x, 3, std::vector<float>(resolution * 3) };
+	for (size_t i = 0; i < resolution; i++) {
+		result.values[i * 3 + 0] = samples[i * 4 + 0];
+		result.values[i * 3 + 1] = samples[i * 4 + 1];
+		result.values[i * 3 + 2] = samples[i * 4 + 2];
+	}
+	return result;
+}
+
+csg::BakedLut csg::bake_lut(const RGBCurveSlotValue& value, const size_t resolution)
+{
+	const Curve& curve_all{ value.get_all() };
+	return bake_curves(value, curve_all.min().x, curve_all.max().x, resolution);
+}
+
+csg::BakedLut csg::bake_lut(const VectorCurveSlotValue& value, const size_t resolution)
+{
+	return bake_curves(value, value.get_min().x, value.get_max().x, resolution);
+}
+
+csg::BakedLut csg::bake_lut(const ColorRampSlotValue& value, const size_t resolution)
+{
+	assert(resolution >= 2);
+	std::vector<float> positions(resolution);
+	for (size_t i = 0; i < resolution; i++) {
+		positions[i] = lut_x(0.0f, 1.0f, i, resolution);
+	}
+	std::vector<csc::Float4> colors(resolution);
+	value.get().eval_many(positions.data(), colors.data(), resolution);
+
+	BakedLut result{ 0.0f, 1.0f, 4, std::vector<float>(resolution * 4) };
+	for (size_t i = 0; i < resolution; i++) {
+		result.values[i * 4 + 0] = colors[i].x;
+		result.values[i * 4 + 1] = colors[i].y;
+		result.values[i * 4 + 2] = colors[i].z;
+		result.values[i * 4 + 3] = colors[i].w;
+	}
+	return result;
+}
+
+// Each kind of value is hashed with the SlotType it is stored as, so different kinds never share a key
+static csg::SlotType slot_type(const csg::RGBCurveSlotValue&) { return csg::SlotType::CURVE_RGB; }
+static csg::SlotType slot_type(const csg::VectorCurveSlotValue&) { return csg::SlotType::CURVE_VECTOR; }
+static csg::SlotType slot_type(const csg::ColorRampSlotValue&) { return csg::SlotType::COLOR_RAMP; }
+
+// True if entry was baked from value at resolution, rather than from another value with the same hash
+template <typename TEntry, typename T> static bool entry_matches(const TEntry& entry, const T& value, const size_t resolution)
+{
+	const T* const cached_value{ entry.value.template as_ptr<T>() };
+	return cached_value != nullptr && entry.resolution == resolution && *cached_value == value;
+}
+
+csg::BakeCache::BakeCache(const size_t capacity) : _capacity{ capacity }
+{
+	assert(capacity > 0);
+}
+
+template <typename T>
+std::shared_ptr<const csg::BakedLut> csg::BakeCache::bake_cached(const T& value, const size_t resolution)
+{
+	csc::Hasher hasher;
+	hasher.add(static_cast<int>(slot_type(value)));
+	value.hash(hasher);
+	hasher.add(static_cast<uint64_t>(resolution));
+	const uint64_t key{ hasher.value() };
+
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		const auto found{ entries_by_key.find(key) };
+		if (found != entries_by_key.end() && entry_matches(*found->second, value, resolution)) {
+			_hits++;
+			entries.splice(entries.begin(), entries, found->second);
+			return found->second->lut;
+		}
+		_misses++;
+	}
+
+	// Bake without holding the lock so other threads can use the cache meanwhile
+	// If another thread baked the same table first, that one is kept and this one is returned without being stored
+	std::shared_ptr<const BakedLut> baked{ std::make_shared<const BakedLut>(bake_lut(value, resolution)) };
+
+	std::lock_guard<std::mutex> lock{ mutex };
+	const auto found{ entries_by_key.find(key) };
+	if (found != entries_by_key.end()) {
+		if (entry_matches(*found->second, value, resolution)) {
+			return baked;
+		}
+		// A different value with the same hash, the newer table takes its place
+		entries.erase(found->second);
+		entries_by_key.erase(found);
+	}
+	entries.push_front(Entry{ key, SlotValue{ value }, resolution, baked });
+	entries_by_key[key] = entries.begin();
+	if (entries.size() > _capacity) {
+		entries_by_key.erase(entries.back().key);
+		entries.pop_back();
+	}
+	return baked;
+}
+
+std::shared_ptr<const csg::BakedLut> csg::BakeCache::bake(const RGBCurveSlotValue& value, const size_t resolution)
+{
+	return bake_cached(value, resolution);
+}
+
+std::shared_ptr<const csg::BakedLut> csg::BakeCache::bake(const VectorCurveSlotValue& value, const size_t resolution)
+{
+	return bake_cached(value, resolution);
+}
+
+std::shared_ptr<const csg::BakedLut> csg::BakeCache::bake(const ColorRampSlotValue& value, const size_t resolution)
+{
+	return bake_cached(value, resolution);
+}
+
+size_t csg::BakeCache::size() const
+{
+	std::lock_guard<std::mutex> lock{ mutex };
+	return entries.size();
+}
+
+size_t csg::BakeCache::hits() const
+{
+	std::lock_guard<std::mutex> lock{ mutex };
+	return _hits;
+}
+
+size_t csg::BakeCache::misses() const
+{
+	std::lock_guard<std::mutex> lock{ mutex };
+	return _misses;
+}
+
+void csg::BakeCache::clear()
+{
+	std::lock_guard<std::mutex> lock{ mutex };
+	entries.clear();
+	entries_by_key.clear();
+}
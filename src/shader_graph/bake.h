@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines functions to bake curve and ramp slot values into lookup tables, and BakeCache to reuse them.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "slot.h"
+
+namespace csg {
+
+	/**
+	 * @brief Evenly spaced samples of a curve or ramp slot value, the form Cycles takes them in.
+	 *
+	 * Entry i is the value at min_x + (max_x - min_x) * i / (resolution - 1). Each entry's channels are stored next
+	 * to each other in values.
+	 */
+	struct BakedLut {
+		float min_x;
+		float max_x;
+		size_t channels;
+		std::vector<float> values;
+
+		size_t resolution() const { return (channels == 0) ? 0 : values.size() / channels; }
+	};
+
+	// Each resolution must be at least 2
+	// Red, green and blue, each through the combined curve and then its own, over the x range of the combined curve
+	BakedLut bake_lut(const RGBCurveSlotValue& value, size_t resolution);
+	// The x, y and z curves over the x range of the slot value
+	BakedLut bake_lut(const VectorCurveSlotValue& value, size_t resolution);
+	// Red, green, blue and alpha from 0 to 1
+	BakedLut bake_lut(const ColorRampSlotValue& value, size_t resolution);
+
+	/**
+	 * @brief Remembers the most recently baked lookup tables so identical values are baked once.
+	 *
+	 * Tables are found by a 64-bit hash of the slot value and resolution, the same data SlotValue::hash uses. Each table
+	 * keeps a copy of the value it was baked from, which is compared before the table is returned, so values that only
+	 * share a hash never share a table. When full, the table used longest ago is dropped. Tables are returned as shared
+	 * pointers, so a dropped table stays valid for anyone still holding it. Safe to use from several threads at once.
+	 */
+	class BakeCache {
+	public:
+		explicit BakeCache(size_t capacity);
+
+		std::shared_ptr<const BakedLut> bake(const RGBCurveSlotValue& value, size_t resolution);
+		std::shared_ptr<const BakedLut> bake(const VectorCurveSlotValue& value, size_t resolution);
+		std::shared_ptr<const BakedLut> bake(const ColorRampSlotValue& value, size_t resolution);
+
+		size_t size() const;
+		size_t capacity() const { return _capacity; }
+		// Number of bake calls answered from the cache, and the number that had to bake
+		size_t hits() const;
+		size_t misses() const;
+
+		void clear();
+
+	private:
+		template <typename T> std::shared_ptr<const BakedLut> bake_cached(const T& value, size_t resolution);
+
+		struct Entry {
+			uint64_t key;
+			SlotValue value;
+			size_t resolution;
+			std::shared_ptr<const BakedLut> lut;
+		};
+		// Most recently used first
+		typedef std::list<Entry> EntryList;
+
+		const size_t _capacity;
+		mutable std::mutex mutex;
+		EntryList entries;
+		std::unordered_map<uint64_t, EntryList::iterator> entries_by_key;
+		size_t _hits{ 0 };
+		size_t _misses{ 0 };
+	};
+}
@@ -3,72 +3,374 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <boost/optional.hpp>
 
 #include "shader_core/lerp.h"
 #include "shader_core/rect.h"
+#include "shader_core/search.h"
+#include "shader_core/simd.h"
+
+// Values of CompiledCurve::segment_mode, from the interpolation at each end of the segment
+static constexpr int32_t SEGMENT_LINEAR{ 0 };
+static constexpr int32_t SEGMENT_HERMITE{ 1 };
+static constexpr int32_t SEGMENT_HERMITE_TO_LINEAR{ 2 };
+static constexpr int32_t SEGMENT_LINEAR_TO_HERMITE{ 3 };
+
+// Layout of each segment's block in CompiledCurve::hermite_coefs
+// x(t) = ((a * t + b) * t + c) * t is measured from the segment's first point, its slope is (3a * t + 2b) * t + c
+// x only turns around inside the segment at split_t1 and split_t2, which split it into three pieces where x only
+// increases or only decreases, split_x1, split_x2 and end_x are x at split_t1, split_t2 and t = 1
+static constexpr int32_t HERMITE_X_A{ 0 };
+static constexpr int32_t HERMITE_X_B{ 1 };
+static constexpr int32_t HERMITE_X_C{ 2 };
+static constexpr int32_t HERMITE_SLOPE_A{ 3 };
+static constexpr int32_t HERMITE_SLOPE_B{ 4 };
+static constexpr int32_t HERMITE_Y_A{ 5 };
+static constexpr int32_t HERMITE_Y_B{ 6 };
+static constexpr int32_t HERMITE_Y_C{ 7 };
+static constexpr int32_t HERMITE_Y_D{ 8 };
+static constexpr int32_t HERMITE_SPLIT_T1{ 9 };
+static constexpr int32_t HERMITE_SPLIT_T2{ 10 };
+static constexpr int32_t HERMITE_SPLIT_X1{ 11 };
+static constexpr int32_t HERMITE_SPLIT_X2{ 12 };
+static constexpr int32_t HERMITE_END_X{ 13 };
+static constexpr int32_t HERMITE_COEF_COUNT{ 14 };
+
+// Solving for t stops once a step moves it less than this, rounding in x keeps it from settling exactly
+static constexpr float HERMITE_SOLVE_TOLERANCE{ 1.0e-6f };
+// Newton's method normally settles within a few steps, this only limits how long a badly behaved spline can take
+static constexpr int HERMITE_SOLVE_STEPS_MAX{ 32 };
+
+// Coefficients of a, b, c and d for the catmull-rom spline through p1 and p2 at t = 0 and t = 1
+static std::array<double, 4> hermite_coefficients(const double p0, const double p1, const double p2, const double p3)
+{
+	return std::array<double, 4>{
+		-p0 / 2.0 + (3.0 * p1) / 2.0 - (3.0 * p2) / 2.0 + p3 / 2.0,
+		p0 - (5.0 * p1) / 2.0 + 2.0 * p2 - p3 / 2.0,
+		-p0 / 2.0 + p2 / 2.0,
+		p1,
+	};
+}
 
-static float eval_hermite_interpolation(
-	const csc::Float2 p0,
-	const csc::Float2 p1,
-	const csc::Float2 p2,
-	const csc::Float2 p3,
-	const float input_x )
+static float eval_hermite_x(const float* const coefs, const float t)
 {
-	std::array<csc::Float2, 32> hermite_curve;
+	return ((coefs[HERMITE_X_A] * t + coefs[HERMITE_X_B]) * t + coefs[HERMITE_X_C]) * t;
+}
 
-	const auto do_hermite = [](const float p0, const float p1, const float p2, const float p3, const float t) -> float
-	{
-		const float a{ -p0 / 2.0f + (3.0f * p1) / 2.0f - (3.0f * p2) / 2.0f + p3 / 2.0f };
-		const float b{ p0 - (5.0f * p1) / 2.0f + 2.0f * p2 - p3 / 2.0f };
-		const float c{ -p0 / 2.0f + p2 / 2.0f };
-		const float d{ p1 };
+// Finds the t where the spline's x last rises to target, which is the limit of interpolating between ever more samples
+// If x is never below target that is t = 0, if x is below target at the end it is t = 1
+static float solve_hermite_t(const float* const coefs, const float target)
+{
+	const float split_t1{ coefs[HERMITE_SPLIT_T1] };
+	const float split_t2{ coefs[HERMITE_SPLIT_T2] };
+	const float split_x1{ coefs[HERMITE_SPLIT_X1] };
+	const float split_x2{ coefs[HERMITE_SPLIT_X2] };
+	const float end_x{ coefs[HERMITE_END_X] };
+
+	// Take the last piece that goes below target, x is lowest at one end of a piece
+	float lo_t{ 0.0f };
+	float hi_t{ split_t1 };
+	float lo_x{ 0.0f };
+	float hi_x{ split_x1 };
+	if (split_x2 < target || end_x < target) {
+		lo_t = split_t2;
+		hi_t = 1.0f;
+		lo_x = split_x2;
+		hi_x = end_x;
+	}
+	else if (split_x1 < target || split_x2 < target) {
+		lo_t = split_t1;
+		hi_t = split_t2;
+		lo_x = split_x1;
+		hi_x = split_x2;
+	}
+	else if ((0.0f < target || split_x1 < target) == false) {
+		return 0.0f;
+	}
+	if (hi_x < target) {
+		return hi_t;
+	}
 
-		return a * t*t*t + b * t*t + c * t + d;
-	};
+	// Now x rises from below target to at least target across the piece, start from a straight line between the ends
+	// Newton steps that leave the range known to hold the answer are replaced by bisection
+	float t{ lo_t + (hi_t - lo_t) * ((target - lo_x) / (hi_x - lo_x)) };
+	for (int step = 0; step < HERMITE_SOLVE_STEPS_MAX; step++) {
+		const float error{ eval_hermite_x(coefs, t) - target };
+		if (error < 0.0f) {
+			lo_t = t;
+		}
+		else {
+			hi_t = t;
+		}
+		const float slope{ (coefs[HERMITE_SLOPE_A] * t + coefs[HERMITE_SLOPE_B]) * t + coefs[HERMITE_X_C] };
+		float next_t{ t - error / slope };
+		if ((lo_t <= next_t && next_t <= hi_t) == false) {
+			next_t = lo_t + (hi_t - lo_t) * 0.5f;
+		}
+		const float step_size{ next_t - t };
+		t = next_t;
+		if (step_size < HERMITE_SOLVE_TOLERANCE && -step_size < HERMITE_SOLVE_TOLERANCE) {
+			break;
+		}
+	}
+	return t;
+}
+
+csg::CompiledCurve::CompiledCurve(const std::vector<CurvePoint>& points)
+{
+	point_x.reserve(points.size());
+	point_y.reserve(points.size());
+	for (const CurvePoint& this_point : points) {
+		point_x.push_back(this_point.pos.x);
+		point_y.push_back(this_point.pos.y);
+	}
 
-	// Assert that x values are in strictly ascending order
-	assert(p1.x >= p0.x);
-	assert(p2.x >= p1.x);
-	assert(p3.x >= p2.x);
-
-	// Populate our whole curve with (x, y) pairs
-	for (size_t i = 0; i < hermite_curve.size(); i++) {
-		const float t{ static_cast<float>(i) / (hermite_curve.size() - 1) };
-		const float x{ do_hermite(p0.x, p1.x, p2.x, p3.x, t) };
-		const float y{ do_hermite(p0.y, p1.y, p2.y, p3.y, t) };
-		hermite_curve[i] = csc::Float2{ x, y };
-	}
-
-	// Look for the two (x, y) pairs that surround our x value
-	// The curve is already known to be sorted on x
-	size_t before_index{ SIZE_MAX };
-	for (size_t i = 0; i < hermite_curve.size(); i++) {
-		if (hermite_curve[i].x < input_x) {
-			before_index = i;
+	for (size_t i = 0; i + 1 < points.size(); i++) {
+		const CurveInterp begin_interp{ points[i].interp };
+		const CurveInterp end_interp{ points[i + 1].interp };
+		if (begin_interp == CurveInterp::LINEAR && end_interp == CurveInterp::LINEAR) {
+			segment_mode.push_back(SEGMENT_LINEAR);
+			segment_coefs.push_back(0);
+			continue;
+		}
+		else if (begin_interp == CurveInterp::CUBIC_HERMITE && end_interp == CurveInterp::CUBIC_HERMITE) {
+			segment_mode.push_back(SEGMENT_HERMITE);
+		}
+		else if (begin_interp == CurveInterp::CUBIC_HERMITE) {
+			segment_mode.push_back(SEGMENT_HERMITE_TO_LINEAR);
+		}
+		else {
+			segment_mode.push_back(SEGMENT_LINEAR_TO_HERMITE);
+		}
+		segment_coefs.push_back(static_cast<int32_t>(hermite_coefs.size()));
+
+		// The outer points of the spline, made up by reflection at either end of the curve
+		const csc::Float2 p1{ points[i].pos };
+		const csc::Float2 p2{ points[i + 1].pos };
+		const csc::Float2 p0{ (i == 0) ? p1 - (p2 - p1) : points[i - 1].pos };
+		const csc::Float2 p3{ (i + 2 >= points.size()) ? p2 + (p2 - p1) : points[i + 2].pos };
+		assert(p1.x >= p0.x);
+		assert(p2.x >= p1.x);
+		assert(p3.x >= p2.x);
+
+		// x is measured from p1, which keeps its precision in narrow segments far from 0
+		const std::array<double, 4> x_coefs{ hermite_coefficients(p0.x - p1.x, 0.0, p2.x - p1.x, p3.x - p1.x) };
+		const std::array<double, 4> y_coefs{ hermite_coefficients(p0.y, p1.y, p2.y, p3.y) };
+		std::array<float, HERMITE_COEF_COUNT> coefs;
+		coefs[HERMITE_X_A] = static_cast<float>(x_coefs[0]);
+		coefs[HERMITE_X_B] = static_cast<float>(x_coefs[1]);
+		coefs[HERMITE_X_C] = static_cast<float>(x_coefs[2]);
+		coefs[HERMITE_SLOPE_A] = 3.0f * coefs[HERMITE_X_A];
+		coefs[HERMITE_SLOPE_B] = 2.0f * coefs[HERMITE_X_B];
+		coefs[HERMITE_Y_A] = static_cast<float>(y_coefs[0]);
+		coefs[HERMITE_Y_B] = static_cast<float>(y_coefs[1]);
+		coefs[HERMITE_Y_C] = static_cast<float>(y_coefs[2]);
+		coefs[HERMITE_Y_D] = p1.y;
+
+		// x turns around where its slope is 0, unused splits are placed at t = 1 so their pieces are empty
+		std::vector<double> turns;
+		const double slope_a{ 3.0 * coefs[HERMITE_X_A] };
+		const double slope_b{ 2.0 * coefs[HERMITE_X_B] };
+		const double slope_c{ coefs[HERMITE_X_C] };
+		if (slope_a == 0.0) {
+			if (slope_b != 0.0) {
+				turns.push_back(-slope_c / slope_b);
+			}
+		}
+		else {
+			const double discriminant{ slope_b * slope_b - 4.0 * slope_a * slope_c };
+			if (discriminant >= 0.0) {
+				const double root{ std::sqrt(discriminant) };
+				turns.push_back((-slope_b - root) / (2.0 * slope_a));
+				turns.push_back((-slope_b + root) / (2.0 * slope_a));
+			}
 		}
+		turns.erase(std::remove_if(turns.begin(), turns.end(), [](const double t) { return (t > 0.0 && t < 1.0) == false; }), turns.end());
+		std::sort(turns.begin(), turns.end());
+		coefs[HERMITE_SPLIT_T1] = (turns.size() > 0) ? static_cast<float>(turns[0]) : 1.0f;
+		coefs[HERMITE_SPLIT_T2] = (turns.size() > 1) ? static_cast<float>(turns[1]) : 1.0f;
+		coefs[HERMITE_SPLIT_X1] = eval_hermite_x(coefs.data(), coefs[HERMITE_SPLIT_T1]);
+		coefs[HERMITE_SPLIT_X2] = eval_hermite_x(coefs.data(), coefs[HERMITE_SPLIT_T2]);
+		coefs[HERMITE_END_X] = eval_hermite_x(coefs.data(), 1.0f);
+		hermite_coefs.insert(hermite_coefs.end(), coefs.begin(), coefs.end());
 	}
+}
+
+float csg::CompiledCurve::eval(const float input) const
+{
+	assert(point_x.size() >= 1);
 
-	// In the case where our x input is before the first point, just return the value of the first point
-	// This may happen due to floating point oddities
-	if (before_index == SIZE_MAX) {
-		return hermite_curve[0].y;
+	// Clamp if input is not between two points, written so a NaN input gives the first point
+	if ((point_x.front() <= input) == false) {
+		return point_y.front();
 	}
+	const size_t after_index{ csc::count_before(point_x.data(), point_x.size(), [input](const float x) { return x <= input; }) };
+	if (after_index == point_x.size()) {
+		return point_y.back();
+	}
+	const size_t segment{ after_index - 1 };
 
-	// In the case where our x input is beyond the last point, just return the value of the last point
-	// This may happen due to floating point oddities
-	if (before_index == hermite_curve.size() - 1) {
-		return hermite_curve[hermite_curve.size() - 1].y;
+	const float fade{ (input - point_x[segment]) / (point_x[segment + 1] - point_x[segment]) };
+	const float linear_result{ csc::lerp(point_y[segment], point_y[segment + 1], fade) };
+	const int32_t mode{ segment_mode[segment] };
+	if (mode == SEGMENT_LINEAR) {
+		return linear_result;
 	}
+	const float hermite_result{ eval_hermite(segment, input) };
 
-	const float lerp_t{ (input_x - hermite_curve[before_index].x) / (hermite_curve[before_index + 1].x - hermite_curve[before_index].x) };
-	return csc::lerp(hermite_curve[before_index].y, hermite_curve[before_index + 1].y, lerp_t);
+	// 0 means to use fully linear interp, 1 means fully hermite
+	float hermite_weight{ 1.0f };
+	if (mode == SEGMENT_HERMITE_TO_LINEAR) {
+		hermite_weight = 1.0f - fade;
+	}
+	else if (mode == SEGMENT_LINEAR_TO_HERMITE) {
+		hermite_weight = fade;
+	}
+	return csc::lerp(linear_result, hermite_result, hermite_weight);
 }
 
+void csg::CompiledCurve::eval_many(const float* const input, float* const output, const size_t count) const
+{
+	size_t i{ 0 };
+#ifdef CSC_SIMD
+	// A single point has no segments to load, eval handles it alone
+	if (point_x.size() >= 2) {
+		for (; i + csc::SimdLanes::WIDTH <= count; i += csc::SimdLanes::WIDTH) {
+			eval_lanes(input + i, output + i);
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		output[i] = eval(input[i]);
+	}
+}
+
+float csg::CompiledCurve::eval_hermite(const size_t segment, const float input) const
+{
+	const float* const coefs{ hermite_coefs.data() + segment_coefs[segment] };
+	const float t{ solve_hermite_t(coefs, input - point_x[segment]) };
+	return ((coefs[HERMITE_Y_A] * t + coefs[HERMITE_Y_B]) * t + coefs[HERMITE_Y_C]) * t + coefs[HERMITE_Y_D];
+}
+
+#ifdef CSC_SIMD
+// Curves with up to this many points are searched by counting every point
+static constexpr size_t LANES_COUNT_POINTS_MAX{ 16 };
+
+// The same steps as eval and eval_hermite with every branch replaced by a select, so results match exactly
+void csg::CompiledCurve::eval_lanes(const float* const input, float* const output) const
+{
+	typedef csc::SimdLanes L;
+	const L::Float x{ L::load(input) };
+	const int32_t point_count{ static_cast<int32_t>(point_x.size()) };
+
+	// Find the same point eval does, the count of points at or before x
+	L::Int after_index{ L::set_int(0) };
+	if (point_x.size() <= LANES_COUNT_POINTS_MAX) {
+		// Counting every point needs no loads that depend on each other, which is faster than searching for few points
+		for (const float this_x : point_x) {
+			after_index = L::increment(L::less_equal(L::set(this_x), x), after_index);
+		}
+	}
+	else {
+		// Search every lane at once as count_before does, the step count only depends on the point count
+		for (size_t remaining = point_x.size(); remaining > 1; ) {
+			const size_t half{ remaining / 2 };
+			const L::Int half_index{ L::add_int(after_index, L::set_int(static_cast<int32_t>(half))) };
+			after_index = L::select_int(L::less_equal(L::gather(point_x.data(), half_index), x), half_index, after_index);
+			remaining -= half;
+		}
+		after_index = L::increment(L::less_equal(L::gather(point_x.data(), after_index), x), after_index);
+	}
+
+	// Lanes that clamp to either end still load a real segment, their result is replaced at the end
+	const L::Mask before_first{ L::mask_not(L::less_equal(L::set(point_x.front()), x)) };
+	const L::Mask after_last{ L::equal_int(after_index, L::set_int(point_count)) };
+	L::Int segment{ L::sub_int(after_index, L::set_int(1)) };
+	segment = L::select_int(L::equal_int(after_index, L::set_int(0)), L::set_int(0), segment);
+	segment = L::select_int(after_last, L::set_int(point_count - 2), segment);
+	const L::Int next_point{ L::add_int(segment, L::set_int(1)) };
+
+	const L::Float begin_x{ L::gather(point_x.data(), segment) };
+	const L::Float begin_y{ L::gather(point_y.data(), segment) };
+	const L::Float end_x{ L::gather(point_x.data(), next_point) };
+	const L::Float end_y{ L::gather(point_y.data(), next_point) };
+	const L::Float fade{ L::div(L::sub(x, begin_x), L::sub(end_x, begin_x)) };
+	const L::Float linear_result{ L::add(begin_y, L::mul(L::sub(end_y, begin_y), fade)) };
+
+	const L::Int mode{ L::gather_int(segment_mode.data(), segment) };
+	const L::Mask linear_lanes{ L::mask_or(L::equal_int(mode, L::set_int(SEGMENT_LINEAR)), L::mask_or(before_first, after_last)) };
+
+	L::Float result{ linear_result };
+	if (L::mask_bits(L::mask_not(linear_lanes)) != 0) {
+		// At least one lane has a hermite segment, so there are coefficients for every lane to load from
+		const L::Int coefs_begin{ L::gather_int(segment_coefs.data(), segment) };
+		const auto coef = [this, coefs_begin](const int32_t offset) {
+			return L::gather(hermite_coefs.data(), L::add_int(coefs_begin, L::set_int(offset)));
+		};
+		const L::Float target{ L::sub(x, begin_x) };
+		const L::Float zero{ L::set(0.0f) };
+		const L::Float one{ L::set(1.0f) };
+
+		// Pick the piece as solve_hermite_t does
+		const L::Float split_t1{ coef(HERMITE_SPLIT_T1) };
+		const L::Float split_t2{ coef(HERMITE_SPLIT_T2) };
+		const L::Float split_x1{ coef(HERMITE_SPLIT_X1) };
+		const L::Float split_x2{ coef(HERMITE_SPLIT_X2) };
+		const L::Float end_piece_x{ coef(HERMITE_END_X) };
+		const L::Mask in_last{ L::mask_or(L::less(split_x2, target), L::less(end_piece_x, target)) };
+		const L::Mask in_middle{ L::mask_and(L::mask_not(in_last), L::mask_or(L::less(split_x1, target), L::less(split_x2, target))) };
+		const L::Mask in_any{ L::mask_or(in_last, L::mask_or(in_middle, L::mask_or(L::less(zero, target), L::less(split_x1, target)))) };
+		L::Float lo_t{ L::select(in_last, split_t2, L::select(in_middle, split_t1, zero)) };
+		L::Float hi_t{ L::select(in_last, one, L::select(in_middle, split_t2, split_t1)) };
+		const L::Float lo_x{ L::select(in_last, split_x2, L::select(in_middle, split_x1, zero)) };
+		const L::Float hi_x{ L::select(in_last, end_piece_x, L::select(in_middle, split_x2, split_x1)) };
+		const L::Mask at_piece_end{ L::less(hi_x, target) };
+
+		const L::Float line_t{ L::add(lo_t, L::mul(L::sub(hi_t, lo_t), L::div(L::sub(target, lo_x), L::sub(hi_x, lo_x)))) };
+		L::Float t{ L::select(at_piece_end, hi_t, line_t) };
+		t = L::select(in_any, t, zero);
+
+		// Step the lanes that still need solving, each stops where solve_hermite_t would
+		L::Mask solving{ L::mask_and(L::mask_not(linear_lanes), L::mask_and(in_any, L::mask_not(at_piece_end))) };
+		const L::Float x_a{ coef(HERMITE_X_A) };
+		const L::Float x_b{ coef(HERMITE_X_B) };
+		const L::Float x_c{ coef(HERMITE_X_C) };
+		const L::Float slope_a{ coef(HERMITE_SLOPE_A) };
+		const L::Float slope_b{ coef(HERMITE_SLOPE_B) };
+		const L::Float half{ L::set(0.5f) };
+		const L::Float tolerance{ L::set(HERMITE_SOLVE_TOLERANCE) };
+		for (int step = 0; step < HERMITE_SOLVE_STEPS_MAX && L::mask_bits(solving) != 0; step++) {
+			const L::Float error{ L::sub(L::mul(L::add(L::mul(L::add(L::mul(x_a, t), x_b), t), x_c), t), target) };
+			const L::Mask below{ L::less(error, zero) };
+			lo_t = L::select(below, t, lo_t);
+			hi_t = L::select(below, hi_t, t);
+			const L::Float slope{ L::add(L::mul(L::add(L::mul(slope_a, t), slope_b), t), x_c) };
+			L::Float next_t{ L::sub(t, L::div(error, slope)) };
+			next_t = L::select(L::mask_and(L::less_equal(lo_t, next_t), L::less_equal(next_t, hi_t)), next_t, L::add(lo_t, L::mul(L::sub(hi_t, lo_t), half)));
+			const L::Mask settled{ L::mask_and(L::less(L::sub(next_t, t), tolerance), L::less(L::sub(t, next_t), tolerance)) };
+			t = L::select(solving, next_t, t);
+			solving = L::mask_and(solving, L::mask_not(settled));
+		}
+
+		const L::Float hermite_result{ L::add(L::mul(L::add(L::mul(L::add(L::mul(coef(HERMITE_Y_A), t), coef(HERMITE_Y_B)), t), coef(HERMITE_Y_C)), t), coef(HERMITE_Y_D)) };
+
+		L::Float hermite_weight{ L::select(L::equal_int(mode, L::set_int(SEGMENT_HERMITE_TO_LINEAR)), L::sub(one, fade), one) };
+		hermite_weight = L::select(L::equal_int(mode, L::set_int(SEGMENT_LINEAR_TO_HERMITE)), fade, hermite_weight);
+		const L::Float mixed_result{ L::add(linear_result, L::mul(L::sub(hermite_result, linear_result), hermite_weight)) };
+		result = L::select(linear_lanes, linear_result, mixed_result);
+	}
+	result = L::select(before_first, L::set(point_y.front()), result);
+	result = L::select(after_last, L::set(point_y.back()), result);
+	L::store(output, result);
+}
+#endif
+
 bool csg::CurvePoint::operator==(const CurvePoint& other) const
 {
 	return pos == other.pos && interp == other.interp;
@@ -94,108 +396,12 @@ csg::Curve::Curve(const csc::Float2 min, const csc::Float2 max, const boost::opt
 
 float csg::Curve::eval_point(const float input) const
 {
-	// For speed, this function assumes the control point vector is sorted already
-	assert(points.size() >= 1);
-
-	// Variable naming convention for points:
-	// p1 is the point immediately before input
-	// p2 is the point immediately after input
-	// In the case of spline interpolation, we need 2 more
-	// p0 is the point before p1
-	// p3 is the point after p2
-	// Any one of the points might not be real, but at least one of p1 or p2 must be real
-
-	boost::optional<size_t> p1_index;
-	boost::optional<size_t> p2_index;
-	for (size_t i = 0; i < points.size(); i++) {
-		// Find the point before input
-		if (points[i].pos.x <= input) {
-			p1_index = i;
-		}
-	}
-	for (size_t i = points.size(); i > 0; i--) {
-		// Find the point after input
-		if (points[i-1].pos.x > input) {
-			p2_index = i-1;
-		}
-	}
-
-	// Clamp if input is not between two points
-	if (p1_index.has_value() == false) {
-		return points[0].pos.y;
-	}
-	if (p2_index.has_value() == false) {
-		return points[points.size() - 1].pos.y;
-	}
-
-	const csc::Float2 p1{ points[*p1_index].pos };
-	const csc::Float2 p2{ points[*p2_index].pos };
-	const csg::CurveInterp p1_interp{ points[*p1_index].interp };
-	const csg::CurveInterp p2_interp{ points[*p2_index].interp };
-
-	const float delta_x{ p2.x - p1.x };
-	const float fade{ (input - p1.x) / delta_x };
-
-	const float linear_result{ csc::lerp(p1.y, p2.y, fade) };
-	if (p1_interp == csg::CurveInterp::LINEAR && p2_interp == csg::CurveInterp::LINEAR) {
-		// End early if possible to avoid doing unnecessary spline math
-		return linear_result;
-	}
-
-	// Lambdas to generate p0 and p3 for our interp
-	const auto gen_p0_pos = [](const std::vector<CurvePoint>& points, const size_t p1_index, const size_t p2_index) -> csc::Float2
-	{
-		if (p1_index == 0) {
-			const csc::Float2 p1{ points[p1_index].pos };
-			const csc::Float2 p2{ points[p2_index].pos };
-			return p1 - (p2 - p1);
-		}
-		else {
-			return points[p1_index - 1].pos;
-		}
-	};
-	const auto gen_p3_pos = [](const std::vector<CurvePoint>& points, const size_t p1_index, const size_t p2_index) -> csc::Float2
-	{
-		if (p2_index >= points.size() - 1) {
-			const csc::Float2 p1{ points[p1_index].pos };
-			const csc::Float2 p2{ points[p2_index].pos };
-			return p2 + (p2 - p1);
-		}
-		else {
-			return points[p2_index + 1].pos;
-		}
-	};
-	const csc::Float2 p0{ gen_p0_pos(points, *p1_index, *p2_index) };
-	const csc::Float2 p3{ gen_p3_pos(points, *p1_index, *p2_index) };
-
-	// Hermite spline interpolation
-
-	const float hermite_result{ eval_hermite_interpolation(p0, p1, p2, p3, input) };
-
-	// 0 means to use fully linear interp, 1 means fully hermite
-	const auto calc_interp_lerp = [](const csg::CurveInterp p1_interp, const csg::CurveInterp p2_interp, const float t) -> float
-	{
-		if (p1_interp == csg::CurveInterp::LINEAR && p2_interp == csg::CurveInterp::LINEAR) {
-			return 0.0f;
-		}
-		else if (p1_interp == csg::CurveInterp::CUBIC_HERMITE && p2_interp == csg::CurveInterp::CUBIC_HERMITE) {
-			return 1.0f;
-		}
-		else if (p1_interp == csg::CurveInterp::CUBIC_HERMITE && p2_interp == csg::CurveInterp::LINEAR) {
-			return 1.0f - t;
-		}
-		else if (p1_interp == csg::CurveInterp::LINEAR && p2_interp == csg::CurveInterp::CUBIC_HERMITE) {
-			return t;
-		}
-		else {
-			assert(false);
-			// To suppress a compiler warning
-			return 0.0f;
-		}
-	};
+	return compiled->eval(input);
+}
 
-	const float interp_t{ (input - p1.x) / (p2.x - p1.x) };
-	return csc::lerp(linear_result, hermite_result, calc_interp_lerp(p1_interp, p2_interp, interp_t));
+void csg::Curve::eval_many(const float* const input, float* const output, const size_t count) const
+{
+	compiled->eval_many(input, output, count);
 }
 
 void csg::Curve::delete_point(const size_t index)
@@ -236,7 +442,11 @@ size_t csg::Curve::create_point(const float x)
 			if (i + 1 < points.size() && points[i + 1].interp == csg::CurveInterp::CUBIC_HERMITE) {
 				interp = csg::CurveInterp::CUBIC_HERMITE;
 			}
-			points[i].interp = interp;
+			if (interp != new_point.interp) {
+				// sort_points() compiled the new point as linear
+				points[i].interp = interp;
+				compile();
+			}
 			return i;
 		}
 	}
@@ -271,6 +481,7 @@ void csg::Curve::set_interp(const size_t index, const CurveInterp new_interp)
 		return;
 	}
 	points[index].interp = new_interp;
+	compile();
 }
 
 void csg::Curve::set_bounds(const csc::FloatRect bounds_rect)
@@ -341,4 +552,10 @@ void csg::Curve::sort_points()
 		return a.pos.x < b.pos.x;
 	};
 	std::sort(points.begin(), points.end(), lt_x);
+	compile();
+}
+
+void csg::Curve::compile()
+{
+	compiled = std::make_shared<const CompiledCurve>(points);
 }
@@ -2,6 +2,8 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include <boost/optional.hpp>
@@ -29,6 +31,39 @@ namespace csg {
 		CurveInterp interp;
 	};
 
+	/**
+	 * @brief Evaluator for a fixed set of curve control points.
+	 *
+	 * Built once when a curve's points change. Each segment keeps how its ends are interpolated and, if either end uses
+	 * hermite interpolation, the cubic coefficients of its spline along with where x turns around. Segments are found by
+	 * binary search and the spline is solved for the t that gives the input x, so evaluating is O(log n) and exact to
+	 * float precision. Everything is stored as flat arrays so eval_many can load the data for several inputs at once.
+	 */
+	class CompiledCurve {
+	public:
+		// Points must be sorted by x
+		explicit CompiledCurve(const std::vector<CurvePoint>& points);
+
+		float eval(float input) const;
+		// Gives the same result as eval for each value, input and output may be the same array
+		void eval_many(const float* input, float* output, size_t count) const;
+
+	private:
+		float eval_hermite(size_t segment, float input) const;
+		// Evaluates SimdLanes::WIDTH values, only defined when built with SIMD support
+		void eval_lanes(const float* input, float* output) const;
+
+		// Point i is (point_x[i], point_y[i]), segment i runs from point i to point i + 1
+		std::vector<float> point_x;
+		std::vector<float> point_y;
+		// How each segment mixes its linear and hermite results, see the constants in curves.cpp
+		std::vector<int32_t> segment_mode;
+		// Index of each segment's first value in hermite_coefs, 0 if both ends are linear
+		std::vector<int32_t> segment_coefs;
+		// A block of values for each segment with a hermite end, laid out as the HERMITE_ constants in curves.cpp
+		std::vector<float> hermite_coefs;
+	};
+
 	class Curve {
 	public:
 		Curve(csc::Float2 min, csc::Float2 max, boost::optional<std::vector<CurvePoint>> points = boost::none);
@@ -39,6 +74,8 @@ namespace csg {
 		csc::Float2 max() const { return _max; }
 
 		float eval_point(float input) const;
+		// Gives the same result as eval_point for each value, input and output may be the same array
+		void eval_many(const float* input, float* output, size_t count) const;
 
 		void delete_point(size_t index);
 		size_t create_point(float x);
@@ -66,10 +103,14 @@ namespace csg {
 			return result;
 		}
 	private:
+		// Must be called after any change to points
 		void sort_points();
+		void compile();
 
 		csc::Float2 _min;
 		csc::Float2 _max;
 		std::vector<CurvePoint> points;
+		// Shared between copies, it is replaced rather than modified when points change
+		std::shared_ptr<const CompiledCurve> compiled;
 	};
 }
@@ -1,11 +1,22 @@
 #include "graph.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <list>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <memory>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <boost/optional.hpp>
 
+#include "shader_core/hash.h"
+#include "shader_core/shared_ptr.h"
 #include "shader_core/vector.h"
 
 #include "node.h"
@@ -13,46 +24,107 @@
 #include "serialize.h"
 #include "slot.h"
 
-template <typename TSlot, typename TRaw> bool set_graph_value(
-	const std::map<csg::NodeId, std::shared_ptr<csg::Node>>& nodes_by_id,
-	const csg::SlotId slot_id,
-	const TRaw new_value)
+static void erase_connection(std::vector<csg::Connection>& connections, const csg::Connection& connection)
 {
-	if (nodes_by_id.count(slot_id.node_id()) == 0) {
-		return false;
+	const auto iter{ std::find(connections.begin(), connections.end(), connection) };
+	assert(iter != connections.end());
+	if (iter != connections.end()) {
+		// Order does not matter, swap with the back so nothing has to shift
+		*iter = connections.back();
+		connections.pop_back();
 	}
+}
 
-	const std::shared_ptr<csg::Node> node{ nodes_by_id.at(slot_id.node_id()) };
-	if (node.use_count() == 0) {
-		return false;
-	}
+static std::shared_ptr<csg::NodeBlock> make_node_block()
+{
+	const std::shared_ptr<csg::NodeBlock> result{ std::make_shared<csg::NodeBlock>() };
+	result->ids.reserve(csg::NodeBlock::CAPACITY);
+	result->keys.reserve(csg::NodeBlock::CAPACITY);
+	result->nodes.reserve(csg::NodeBlock::CAPACITY);
+	result->hashes.reserve(csg::NodeBlock::CAPACITY);
+	return result;
+}
 
-	const auto opt_slot{ node->slot(slot_id.index()) };
-	if (opt_slot.has_value() == false) {
-		return false;
-	}
+static uint64_t connection_hash(const csg::Connection& connection)
+{
+	// Seeded so a connection can never hash the same as a node
+	csc::Hasher hasher{ 1 };
+	hasher.add(connection.source().node_id());
+	hasher.add(static_cast<uint64_t>(connection.source().index()));
+	hasher.add(connection.dest().node_id());
+	hasher.add(static_cast<uint64_t>(connection.dest().index()));
+	return hasher.value();
+}
 
-	csg::Slot& slot = node->slot_ref(slot_id.index());
-	if (slot.value.has_value() == false) {
-		return false;
+// Versions come from one counter shared by every journal, see GraphJournal
+static uint64_t next_journal_version()
+{
+	static std::atomic<uint64_t> last_version{ 0 };
+	return ++last_version;
+}
+
+csg::GraphJournal::GraphJournal() : base_version{ next_journal_version() } {}
+
+size_t csg::GraphJournal::size() const
+{
+	return chunks.empty() ? 0 : (chunks.size() - 1) * CHUNK_CAPACITY + chunks.back()->size();
+}
+
+boost::optional<std::vector<csg::GraphChange>> csg::GraphJournal::changes_since(const uint64_t version) const
+{
+	std::vector<GraphChange> result;
+	if (version == base_version) {
+		result.reserve(size());
+		for (const std::shared_ptr<Chunk>& this_chunk : chunks) {
+			result.insert(result.end(), this_chunk->begin(), this_chunk->end());
+		}
+		return result;
 	}
 
-	const boost::optional<TSlot> opt_old_value = slot.value->as<TSlot>();
-	if (opt_old_value.has_value() == false) {
-		return false;
+	// Records are in version order, find the chunk and then the record with exactly this version
+	const auto chunk_iter{ std::upper_bound(chunks.begin(), chunks.end(), version,
+		[](const uint64_t version, const std::shared_ptr<Chunk>& chunk) {
+			return version < chunk->front().version();
+		}
+	) };
+	if (chunk_iter == chunks.begin()) {
+		return boost::none;
+	}
+	const Chunk& chunk{ **(chunk_iter - 1) };
+	const auto record_iter{ std::lower_bound(chunk.begin(), chunk.end(), version,
+		[](const GraphChange& change, const uint64_t version) {
+			return change.version() < version;
+		}
+	) };
+	if (record_iter == chunk.end() || record_iter->version() != version) {
+		return boost::none;
 	}
 
-	const TSlot old_value = opt_old_value.value();
-	TSlot maybe_new_value{ old_value };
-	maybe_new_value.set(new_value);
+	result.insert(result.end(), record_iter + 1, chunk.end());
+	for (auto iter{ chunk_iter }; iter != chunks.end(); iter++) {
+		result.insert(result.end(), (*iter)->begin(), (*iter)->end());
+	}
+	return result;
+}
 
-	if (maybe_new_value != old_value) {
-		slot.value = maybe_new_value;
-		return true;
+void csg::GraphJournal::record(const GraphChangeType type, const SlotId slot_id, const SlotId source)
+{
+	if (chunks.empty() || chunks.back()->size() >= CHUNK_CAPACITY) {
+		if (chunks.size() >= CAPACITY / CHUNK_CAPACITY) {
+			base_version = chunks.front()->back().version();
+			chunks.erase(chunks.begin());
+		}
+		chunks.push_back(std::make_shared<Chunk>());
+		chunks.back()->reserve(CHUNK_CAPACITY);
 	}
-	else {
-		return false;
+	else if (csc::is_sole_owner(chunks.back()) == false) {
+		// Shared with a copy of the graph, give this journal its own copy of the chunk being appended to
+		std::shared_ptr<Chunk> new_chunk{ std::make_shared<Chunk>() };
+		new_chunk->reserve(CHUNK_CAPACITY);
+		new_chunk->insert(new_chunk->end(), chunks.back()->begin(), chunks.back()->end());
+		chunks.back() = new_chunk;
 	}
+	chunks.back()->push_back(GraphChange{ type, next_journal_version(), slot_id, source });
 }
 
 bool csg::Connection::operator<(const Connection& other) const
@@ -68,42 +140,36 @@ bool csg::Connection::operator<(const Connection& other) const
 
 boost::optional<csg::Graph> csg::Graph::from(const std::string& graph_string)
 {
+	if (is_binary_graph(graph_string)) {
+		return deserialize_graph_binary(graph_string);
+	}
 	return deserialize_graph(graph_string);
 }
 
-csg::Graph::Graph(const GraphType type)
+boost::optional<csg::Graph> csg::Graph::from(std::istream& input)
 {
-	if (type == GraphType::MATERIAL) {
-		add(NodeType::MATERIAL_OUTPUT, csc::Int2{});
+	if (is_binary_graph(input)) {
+		// The binary format is compact enough that it is read whole rather than streamed
+		const std::string graph_string{ std::istreambuf_iterator<char>{ input }, std::istreambuf_iterator<char>{} };
+		return deserialize_graph_binary(graph_string);
 	}
+	return deserialize_graph(input);
 }
 
-csg::Graph& csg::Graph::operator=(const Graph& other)
+csg::Graph::Graph(const GraphType type)
 {
-	// Destroy all shared_ptrs, the objects they point to do not belong to the this graph anymore
-	_nodes.clear();
-	nodes_by_id.clear();
-
-	for (const std::shared_ptr<Node>& node : other.nodes()) {
-		// Make a new shared_ptr with an equivalent but distinct object
-		const std::shared_ptr<Node> new_node{ std::make_shared<Node>(*node) };
-		_nodes.push_back(new_node);
-		nodes_by_id[new_node->id()] = new_node;
+	if (type == GraphType::MATERIAL) {
+		add(NodeType::MATERIAL_OUTPUT, csc::Int2{});
 	}
-
-	_connections = other._connections;
-
-	return *this;
 }
 
 std::shared_ptr<const csg::Node> csg::Graph::get(const NodeId id) const
 {
-	if (nodes_by_id.count(id)) {
-		return std::const_pointer_cast<const Node>(nodes_by_id.at(id));
-	}
-	else {
-		return std::shared_ptr<const csg::Node>{};
+	const boost::optional<NodeLocation> location{ locate(id) };
+	if (location.has_value() == false) {
+		return std::shared_ptr<const Node>{};
 	}
+	return node_blocks[location->block]->nodes[location->index];
 }
 
 boost::optional<csg::SlotValue> csg::Graph::get_slot_value(SlotId slot_id) const
@@ -115,13 +181,22 @@ boost::optional<csg::SlotValue> csg::Graph::get_slot_value(SlotId slot_id) const
 	return boost::none;
 }
 
+const csg::SlotValue* csg::Graph::get_slot_value_ptr(const SlotId slot_id) const
+{
+	// Skips the shared_ptr copy that get() would make
+	const boost::optional<NodeLocation> location{ locate(slot_id.node_id()) };
+	if (location.has_value() == false) {
+		return nullptr;
+	}
+	return node_blocks[location->block]->nodes[location->index]->slot_value_ptr(slot_id.index());
+}
+
 csg::NodeId csg::Graph::add(const NodeType type, const csc::Int2 pos)
 {
 	while (true) {
-		const std::shared_ptr<Node> new_node{ std::make_shared<Node>(type, pos) };
-		if (contains(new_node->id()) == false) {
-			_nodes.push_front(new_node);
-			nodes_by_id[new_node->id()] = new_node;
+		const std::shared_ptr<const Node> new_node{ std::make_shared<Node>(type, pos) };
+		if (append_node(new_node, new_node->content_hash())) {
+			record_change(GraphChangeType::NODE_ADDED, new_node->id());
 			return new_node->id();
 		}
 	}
@@ -129,10 +204,9 @@ csg::NodeId csg::Graph::add(const NodeType type, const csc::Int2 pos)
 
 bool csg::Graph::add(const NodeType type, const csc::Int2 pos, const NodeId node_id)
 {
-	const std::shared_ptr<Node> new_node{ std::make_shared<Node>(type, pos, node_id) };
-	if (contains(new_node->id()) == false) {
-		_nodes.push_front(new_node);
-		nodes_by_id[new_node->id()] = new_node;
+	const std::shared_ptr<const Node> new_node{ std::make_shared<Node>(type, pos, node_id) };
+	if (append_node(new_node, new_node->content_hash())) {
+		record_change(GraphChangeType::NODE_ADDED, new_node->id());
 		return true;
 	}
 	else {
@@ -140,31 +214,51 @@ bool csg::Graph::add(const NodeType type, const csc::Int2 pos, const NodeId node
 	}
 }
 
+bool csg::Graph::add_nodes(const Graph& other)
+{
+	for (const std::shared_ptr<NodeBlock>& this_block : other.node_blocks) {
+		for (const NodeId this_id : this_block->ids) {
+			if (contains(this_id)) {
+				return false;
+			}
+		}
+	}
+	// Blocks are in draw order from the bottom, so other's nodes keep their order
+	for (const std::shared_ptr<NodeBlock>& this_block : other.node_blocks) {
+		for (size_t i = 0; i < this_block->nodes.size(); i++) {
+			append_node(this_block->nodes[i], this_block->hashes[i]);
+			record_change(GraphChangeType::NODE_ADDED, this_block->ids[i]);
+		}
+	}
+	return true;
+}
+
 void csg::Graph::remove(const std::set<NodeId>& ids)
 {
-	for (auto iter{ _nodes.begin() }; iter != _nodes.end(); ) {
-		const auto this_node{ *iter };
-		const bool is_deletable{ csg::NodeTypeInfo::from(this_node->type())->category() != csg::NodeCategory::OUTPUT };
-		if (is_deletable && ids.count(this_node->id())) {
-			nodes_by_id.erase(this_node->id());
-			iter = _nodes.erase(iter);
+	for (const NodeId this_id : ids) {
+		const boost::optional<NodeLocation> location{ locate(this_id) };
+		if (location.has_value() == false) {
+			continue;
 		}
-		else {
-			++iter;
+		const std::shared_ptr<const Node>& this_node{ node_blocks[location->block]->nodes[location->index] };
+		const bool is_deletable{ csg::NodeTypeInfo::from(this_node->type())->category() != csg::NodeCategory::OUTPUT };
+		if (is_deletable) {
+			remove_node(*location);
 		}
 	}
+	compact_blocks();
 }
 
 boost::optional<csg::NodeId> csg::Graph::duplicate(const NodeId node_id)
 {
 	const csc::Int2 duplicate_offset{ 20, 20 };
 
-	if (nodes_by_id.count(node_id) == 0) {
+	const std::shared_ptr<const Node> old_node{ get(node_id) };
+	if (old_node.use_count() == 0) {
 		// node_id is invalid, do nothing
 		return boost::none;
 	}
 
-	const std::shared_ptr<Node> old_node{ nodes_by_id[node_id] };
 	const boost::optional<NodeTypeInfo> old_type_info{ NodeTypeInfo::from(old_node->type()) };
 	assert(old_type_info.has_value());
 	if (old_type_info->allow_creation() == false) {
@@ -173,8 +267,8 @@ boost::optional<csg::NodeId> csg::Graph::duplicate(const NodeId node_id)
 	}
 
 	const NodeId new_node_id{ add(old_node->type(), old_node->position + duplicate_offset) };
-	const std::shared_ptr<Node> new_node{ nodes_by_id[new_node_id] };
-	new_node->copy_from(*old_node);
+	get_mutable(new_node_id)->copy_from(*old_node);
+	refresh_hash(new_node_id);
 	return new_node_id;
 }
 
@@ -195,104 +289,151 @@ bool csg::Graph::add_connection(const SlotId source, const SlotId dest)
 		return false;
 	}
 
-	// Add new connection
-	boost::optional<Connection> removed_connection{ remove_connection(dest) };
-	_connections.push_back(Connection{ source, dest });
-
+	insert_connection(Connection{ source, dest });
 	return true;
 }
 
 boost::optional<csg::Connection> csg::Graph::remove_connection(const SlotId dest)
 {
-	for (auto conn_iter{ _connections.begin() }; conn_iter != _connections.end(); conn_iter++) {
-		if (conn_iter->dest() == dest) {
-			Connection result = *conn_iter;
-			_connections.erase(conn_iter);
-			return result;
-		}
+	const Connection* const connection_ptr{ connections_by_dest.find(dest) };
+	if (connection_ptr == nullptr) {
+		return boost::none;
 	}
-	return boost::none;
+	const Connection result{ *connection_ptr };
+	connections_by_dest.erase(dest);
+	_content_hash -= connection_hash(result);
+
+	NodeConnections* const source_connections{ connections_by_node.find_mutable(result.source().node_id()) };
+	assert(source_connections != nullptr);
+	erase_connection(source_connections->output, result);
+	if (source_connections->input.empty() && source_connections->output.empty()) {
+		connections_by_node.erase(result.source().node_id());
+	}
+	NodeConnections* const dest_connections{ connections_by_node.find_mutable(result.dest().node_id()) };
+	assert(dest_connections != nullptr);
+	erase_connection(dest_connections->input, result);
+	if (dest_connections->input.empty() && dest_connections->output.empty()) {
+		connections_by_node.erase(result.dest().node_id());
+	}
+	record_change(GraphChangeType::CONNECTION_REMOVED, result);
+
+	return result;
+}
+
+boost::optional<csg::Connection> csg::Graph::connection_to(const SlotId dest) const
+{
+	const Connection* const connection_ptr{ connections_by_dest.find(dest) };
+	if (connection_ptr == nullptr) {
+		return boost::none;
+	}
+	return *connection_ptr;
+}
+
+const std::vector<csg::Connection>& csg::Graph::input_connections(const NodeId id) const
+{
+	static const std::vector<Connection> NO_CONNECTIONS;
+	const NodeConnections* const node_connections{ connections_by_node.find(id) };
+	return (node_connections == nullptr) ? NO_CONNECTIONS : node_connections->input;
+}
+
+const std::vector<csg::Connection>& csg::Graph::output_connections(const NodeId id) const
+{
+	static const std::vector<Connection> NO_CONNECTIONS;
+	const NodeConnections* const node_connections{ connections_by_node.find(id) };
+	return (node_connections == nullptr) ? NO_CONNECTIONS : node_connections->output;
 }
 
 bool csg::Graph::set_bool(const SlotId slot_id, const bool new_value)
 {
-	return set_graph_value<BoolSlotValue>(nodes_by_id, slot_id, new_value);
+	return update_slot_value<BoolSlotValue>(slot_id, new_value);
 }
 
 bool csg::Graph::set_color(const SlotId slot_id, const csc::Float3 new_value)
 {
-	return set_graph_value<ColorSlotValue>(nodes_by_id, slot_id, new_value);
+	return update_slot_value<ColorSlotValue>(slot_id, new_value);
 }
 
 bool csg::Graph::set_enum(const SlotId slot_id, const size_t new_value)
 {
-	return set_graph_value<EnumSlotValue>(nodes_by_id, slot_id, new_value);
+	return update_slot_value<EnumSlotValue>(slot_id, new_value);
 }
 
 bool csg::Graph::set_float(const SlotId slot_id, const float new_value)
 {
-	return set_graph_value<FloatSlotValue>(nodes_by_id, slot_id, new_value);
+	return update_slot_value<FloatSlotValue>(slot_id, new_value);
 }
 
 bool csg::Graph::set_int(const SlotId slot_id, const int new_value)
 {
-	return set_graph_value<IntSlotValue>(nodes_by_id, slot_id, new_value);
+	return update_slot_value<IntSlotValue>(slot_id, new_value);
 }
 
 bool csg::Graph::set_vector(const SlotId slot_id, const csc::Float3 new_value)
 {
-	return set_graph_value<VectorSlotValue>(nodes_by_id, slot_id, new_value);
+	return update_slot_value<VectorSlotValue>(slot_id, new_value);
 }
 
-bool csg::Graph::set_color_ramp(const SlotId slot_id, const ColorRampSlotValue& new_value)
+bool csg::Graph::set_color_ramp(const SlotId slot_id, ColorRampSlotValue new_value)
 {
-	return set_graph_value<ColorRampSlotValue>(nodes_by_id, slot_id, new_value);
+	return replace_slot_value<ColorRampSlotValue>(slot_id, std::move(new_value));
 }
 
-bool csg::Graph::set_curve_rgb(const SlotId slot_id, const RGBCurveSlotValue& new_value)
+bool csg::Graph::set_curve_rgb(const SlotId slot_id, RGBCurveSlotValue new_value)
 {
-	return set_graph_value<RGBCurveSlotValue>(nodes_by_id, slot_id, new_value);
+	return replace_slot_value<RGBCurveSlotValue>(slot_id, std::move(new_value));
 }
 
-bool csg::Graph::set_curve_vec(const SlotId slot_id, const VectorCurveSlotValue& new_value)
+bool csg::Graph::set_curve_vec(const SlotId slot_id, VectorCurveSlotValue new_value)
 {
-	return set_graph_value<VectorCurveSlotValue>(nodes_by_id, slot_id, new_value);
+	return replace_slot_value<VectorCurveSlotValue>(slot_id, std::move(new_value));
 }
 
 void csg::Graph::move(const std::set<NodeId>& ids, const csc::Float2 delta)
 {
 	for (const NodeId id : ids) {
-		if (nodes_by_id.count(id)) {
-			const auto ptr{ nodes_by_id[id] };
+		const std::shared_ptr<Node> ptr{ get_mutable(id) };
+		if (ptr) {
 			const csc::Float2 current_pos{ ptr->position };
 			const csc::Float2 new_pos{ current_pos + delta };
 			ptr->position = csc::Int2{ new_pos };
+			refresh_hash(id);
+			record_change(GraphChangeType::NODE_MOVED, id);
 		}
 	}
 }
 
 void csg::Graph::raise(const NodeId id)
 {
-	if (contains(id) == false) {
+	const boost::optional<NodeLocation> location{ locate(id) };
+	if (location.has_value() == false) {
 		return;
 	}
-	std::shared_ptr<Node> the_node;
-	for (auto iter{ _nodes.begin() }; iter != _nodes.end(); iter++) {
-		const NodeId this_id{ (*iter)->id() };
-		if (this_id == id) {
-			the_node = *iter;
-			_nodes.erase(iter);
-			break;
-		}
-	}
-	if (the_node) {
-		_nodes.push_front(the_node);
+	const bool is_top{ location->block == node_blocks.size() - 1 && location->index == node_blocks.back()->nodes.size() - 1 };
+	if (is_top) {
+		return;
 	}
+	// The back of the last block is the top of the draw order
+	const std::shared_ptr<const Node> node{ node_blocks[location->block]->nodes[location->index] };
+	const uint64_t hash{ node_blocks[location->block]->hashes[location->index] };
+	erase_node(*location);
+	append_node(node, hash);
+	compact_blocks();
+	record_change(GraphChangeType::NODE_RAISED, id);
 }
 
 bool csg::Graph::contains(const NodeId id) const
 {
-	return (nodes_by_id.count(id) > 0);
+	return keys_by_id.contains(id);
+}
+
+void csg::Graph::set_journal_enabled(const bool enabled)
+{
+	if (enabled && _journal.has_value() == false) {
+		_journal = GraphJournal{};
+	}
+	else if (enabled == false) {
+		_journal = boost::none;
+	}
 }
 
 std::string csg::Graph::serialize() const
@@ -300,37 +441,771 @@ std::string csg::Graph::serialize() const
 	return csg::serialize_graph(*this);
 }
 
+bool csg::Graph::serialize(std::ostream& output) const
+{
+	return csg::serialize_graph(*this, output);
+}
+
+std::string csg::Graph::serialize_binary() const
+{
+	return csg::serialize_graph_binary(*this);
+}
+
+uint64_t csg::Graph::semantic_hash() const
+{
+	// Stands in for a node that is upstream of itself, cycles cannot be rendered but should still hash consistently
+	constexpr uint64_t CYCLE_HASH{ 0x5a5a5a5a5a5a5a5aULL };
+
+	// Each node hash covers everything upstream of it, so node ids never need to be part of the hash
+	std::unordered_map<NodeId, uint64_t> node_hashes;
+	std::unordered_set<NodeId> visiting;
+	// Depth-first walk upstream, a node is hashed on its second visit after all of its inputs are hashed
+	std::vector<std::pair<NodeId, bool>> stack;
+
+	uint64_t result{ 0 };
+	for (const std::shared_ptr<const Node>& output_node : nodes()) {
+		if (output_node->type() != NodeType::MATERIAL_OUTPUT) {
+			continue;
+		}
+		stack.push_back(std::make_pair(output_node->id(), false));
+		while (stack.empty() == false) {
+			const NodeId this_id{ stack.back().first };
+			const bool inputs_done{ stack.back().second };
+			stack.pop_back();
+			if (node_hashes.count(this_id)) {
+				continue;
+			}
+			const std::vector<Connection>& inputs{ input_connections(this_id) };
+			if (inputs_done == false) {
+				if (visiting.count(this_id)) {
+					continue;
+				}
+				visiting.insert(this_id);
+				stack.push_back(std::make_pair(this_id, true));
+				for (const Connection& this_conn : inputs) {
+					stack.push_back(std::make_pair(this_conn.source().node_id(), false));
+				}
+				continue;
+			}
+
+			const std::shared_ptr<const Node> this_node{ get(this_id) };
+			csc::Hasher hasher{ 2 };
+			hasher.add(static_cast<int>(this_node->type()));
+			for (size_t i = 0; i < this_node->slot_count(); i++) {
+				const SlotValue* const this_value{ this_node->slot_value_ptr(i) };
+				// A connected input ignores its own value
+				if (this_value && connections_by_dest.contains(SlotId{ this_id, i }) == false) {
+					hasher.add(static_cast<uint64_t>(i));
+					this_value->hash(hasher);
+				}
+			}
+			std::vector<Connection> sorted_inputs{ inputs };
+			std::sort(sorted_inputs.begin(), sorted_inputs.end(), [](const Connection& lhs, const Connection& rhs) {
+				return lhs.dest().index() < rhs.dest().index();
+			});
+			for (const Connection& this_conn : sorted_inputs) {
+				const auto source_iter{ node_hashes.find(this_conn.source().node_id()) };
+				hasher.add(static_cast<uint64_t>(this_conn.dest().index()));
+				hasher.add(static_cast<uint64_t>(this_conn.source().index()));
+				hasher.add((source_iter == node_hashes.end()) ? CYCLE_HASH : source_iter->second);
+			}
+			node_hashes[this_id] = hasher.value();
+		}
+		// Sum so the order of multiple outputs does not matter
+		result += node_hashes[output_node->id()];
+	}
+	return result;
+}
+
 bool csg::Graph::operator==(const Graph& other) const
 {
-	const bool size_match_nodes{ _nodes.size() == other._nodes.size() };
-	const bool size_match_conns{ _connections.size() == other._connections.size() };
+	if (_content_hash != other._content_hash) {
+		return false;
+	}
+
+	const bool size_match_nodes{ node_count == other.node_count };
+	const bool size_match_conns{ connections_by_dest.size() == other.connections_by_dest.size() };
 	if (!size_match_nodes || !size_match_conns) {
 		return false;
 	}
 
 	// Check that all connections match (order does not matter)
-	{
-		const std::set<Connection> source_connections{ _connections.cbegin(), _connections.cend() };
-		// For each connection in other, make sure it exists in the source set
-		for (const Connection this_conn : other._connections) {
-			if (source_connections.count(this_conn) == 0) {
-				return false;
+	if (connections_by_dest != other.connections_by_dest) {
+		return false;
+	}
+
+	// Graphs copied from each other usually share most blocks, only blocks that differ need their nodes compared
+	if (node_blocks.size() == other.node_blocks.size()) {
+		bool same_layout{ true };
+		for (size_t i = 0; i < node_blocks.size() && same_layout; i++) {
+			const NodeBlock& this_block{ *node_blocks[i] };
+			const NodeBlock& other_block{ *other.node_blocks[i] };
+			if (&this_block == &other_block) {
+				continue;
+			}
+			if (this_block.ids != other_block.ids) {
+				same_layout = false;
+				break;
+			}
+			for (size_t j = 0; j < this_block.nodes.size(); j++) {
+				if (this_block.nodes[j] != other_block.nodes[j] && *this_block.nodes[j] != *other_block.nodes[j]) {
+					return false;
+				}
 			}
 		}
+		if (same_layout) {
+			return true;
+		}
 	}
 
 	// Check that all nodes match (order does not matter)
 	{
-		for (const std::shared_ptr<Node>& this_node : _nodes) {
-			const std::shared_ptr<const Node> other_node{ other.get(this_node->id()) };
-			if (other_node.use_count() == 0) {
+		for (const std::shared_ptr<NodeBlock>& this_block : node_blocks) {
+			for (const std::shared_ptr<const Node>& this_node : this_block->nodes) {
+				const std::shared_ptr<const Node> other_node{ other.get(this_node->id()) };
+				if (other_node.use_count() == 0) {
+					return false;
+				}
+				if (this_node != other_node && *this_node != *other_node) {
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+boost::optional<csg::Graph::NodeLocation> csg::Graph::locate(const NodeId id) const
+{
+	const csc::SlotMapKey* const key{ keys_by_id.find(id) };
+	if (key == nullptr) {
+		return boost::none;
+	}
+	const NodeLocation* const location{ node_locations.get(*key) };
+	assert(location != nullptr);
+	return *location;
+}
+
+std::shared_ptr<csg::Node> csg::Graph::get_mutable(const NodeId id)
+{
+	const boost::optional<NodeLocation> location{ locate(id) };
+	if (location.has_value() == false) {
+		return std::shared_ptr<Node>{};
+	}
+	return get_mutable(*location);
+}
+
+std::shared_ptr<csg::Node> csg::Graph::get_mutable(const NodeLocation location)
+{
+	std::shared_ptr<const Node>& node{ mutable_block(location.block).nodes[location.index] };
+	if (csc::is_sole_owner(node) == false) {
+		// Shared with another graph or held by a caller of get(), give this graph its own copy
+		node = std::make_shared<Node>(*node);
+	}
+	// Every node is created non-const by this class, so casting away const here is safe
+	return std::const_pointer_cast<Node>(node);
+}
+
+csg::NodeBlock& csg::Graph::mutable_block(const size_t block)
+{
+	std::shared_ptr<NodeBlock>& block_ptr{ node_blocks[block] };
+	if (csc::is_sole_owner(block_ptr) == false) {
+		block_ptr = std::make_shared<NodeBlock>(*block_ptr);
+	}
+	return *block_ptr;
+}
+
+bool csg::Graph::append_node(const std::shared_ptr<const Node>& node, const uint64_t hash)
+{
+	// Inserting a placeholder key and checking whether the map grew looks the id up once instead of twice
+	const size_t old_size{ keys_by_id.size() };
+	csc::SlotMapKey& key{ keys_by_id[node->id()] };
+	if (keys_by_id.size() == old_size) {
+		return false;
+	}
+	if (node_blocks.empty() || node_blocks.back()->nodes.size() >= NodeBlock::CAPACITY) {
+		node_blocks.push_back(make_node_block());
+	}
+	NodeBlock& block{ mutable_block(node_blocks.size() - 1) };
+	key = node_locations.insert(NodeLocation{ node_blocks.size() - 1, block.nodes.size() });
+	block.ids.push_back(node->id());
+	block.keys.push_back(key);
+	block.nodes.push_back(node);
+	block.hashes.push_back(hash);
+	_content_hash += hash;
+	node_count++;
+	return true;
+}
+
+void csg::Graph::erase_node(const NodeLocation location)
+{
+	NodeBlock& block{ mutable_block(location.block) };
+	keys_by_id.erase(block.ids[location.index]);
+	node_locations.erase(block.keys[location.index]);
+	block.ids.erase(block.ids.begin() + location.index);
+	block.keys.erase(block.keys.begin() + location.index);
+	block.nodes.erase(block.nodes.begin() + location.index);
+	_content_hash -= block.hashes[location.index];
+	block.hashes.erase(block.hashes.begin() + location.index);
+	node_count--;
+	// Only the nodes after this one in the same block move
+	for (size_t i = location.index; i < block.keys.size(); i++) {
+		node_locations.get_mutable(block.keys[i])->index = i;
+	}
+	// Dropping empty blocks from the end moves nothing, and keeps the top of the draw order in the last block
+	while (node_blocks.empty() == false && node_blocks.back()->nodes.empty()) {
+		node_blocks.pop_back();
+	}
+}
+
+void csg::Graph::compact_blocks()
+{
+	// Removing and raising nodes leaves partially filled blocks behind, repack them once they average under a quarter full
+	const size_t max_blocks{ node_count / (NodeBlock::CAPACITY / 4) + 1 };
+	if (node_blocks.size() <= max_blocks) {
+		return;
+	}
+	const NodeRange::BlockVector old_blocks{ std::move(node_blocks) };
+	node_blocks.clear();
+	// Nodes keep their keys, so only their locations are updated
+	for (const std::shared_ptr<NodeBlock>& this_block : old_blocks) {
+		for (size_t i = 0; i < this_block->nodes.size(); i++) {
+			if (node_blocks.empty() || node_blocks.back()->nodes.size() >= NodeBlock::CAPACITY) {
+				node_blocks.push_back(make_node_block());
+			}
+			NodeBlock& block{ *node_blocks.back() };
+			*node_locations.get_mutable(this_block->keys[i]) = NodeLocation{ node_blocks.size() - 1, block.nodes.size() };
+			block.ids.push_back(this_block->ids[i]);
+			block.keys.push_back(this_block->keys[i]);
+			block.nodes.push_back(this_block->nodes[i]);
+			block.hashes.push_back(this_block->hashes[i]);
+		}
+	}
+}
+
+void csg::Graph::refresh_hash(const NodeId id)
+{
+	const boost::optional<NodeLocation> location{ locate(id) };
+	assert(location.has_value());
+	refresh_hash(*location);
+}
+
+void csg::Graph::refresh_hash(const NodeLocation location)
+{
+	NodeBlock& block{ mutable_block(location.block) };
+	const uint64_t new_hash{ block.nodes[location.index]->content_hash() };
+	_content_hash += new_hash - block.hashes[location.index];
+	block.hashes[location.index] = new_hash;
+}
+
+template <typename TSlot, typename TRaw> bool csg::Graph::update_slot_value(const SlotId slot_id, const TRaw new_value)
+{
+	// Locate once and reuse the location for reading, writing and rehashing
+	const boost::optional<NodeLocation> location{ locate(slot_id.node_id()) };
+	if (location.has_value() == false || update_slot_value<TSlot>(*location, slot_id.index(), new_value) == false) {
+		return false;
+	}
+	refresh_hash(*location);
+	return true;
+}
+
+template <typename TSlot> bool csg::Graph::replace_slot_value(const SlotId slot_id, TSlot&& new_value)
+{
+	const boost::optional<NodeLocation> location{ locate(slot_id.node_id()) };
+	if (location.has_value() == false || replace_slot_value<TSlot>(*location, slot_id.index(), std::move(new_value)) == false) {
+		return false;
+	}
+	refresh_hash(*location);
+	return true;
+}
+
+template <typename TSlot, typename TRaw> bool csg::Graph::update_slot_value(const NodeLocation location, const size_t index, const TRaw new_value)
+{
+	const TSlot* const old_value{ node_blocks[location.block]->nodes[location.index]->slot_value_as_ptr<TSlot>(index) };
+	if (old_value == nullptr) {
+		return false;
+	}
+
+	TSlot maybe_new_value{ *old_value };
+	maybe_new_value.set(new_value);
+	if (maybe_new_value == *old_value) {
+		return false;
+	}
+
+	*get_mutable(location)->slot_value_as_mutable_ptr<TSlot>(index) = maybe_new_value;
+	record_change(GraphChangeType::SLOT_VALUE_CHANGED, SlotId{ node_blocks[location.block]->ids[location.index], index });
+	return true;
+}
+
+template <typename TSlot> bool csg::Graph::replace_slot_value(const NodeLocation location, const size_t index, TSlot&& new_value)
+{
+	const TSlot* const old_value{ node_blocks[location.block]->nodes[location.index]->slot_value_as_ptr<TSlot>(index) };
+	if (old_value == nullptr || new_value == *old_value) {
+		return false;
+	}
+
+	*get_mutable(location)->slot_value_as_mutable_ptr<TSlot>(index) = std::move(new_value);
+	record_change(GraphChangeType::SLOT_VALUE_CHANGED, SlotId{ node_blocks[location.block]->ids[location.index], index });
+	return true;
+}
+
+void csg::Graph::remove_node(const NodeLocation location)
+{
+	const NodeId id{ node_blocks[location.block]->ids[location.index] };
+	// Connections go first so the journal never has a connection outliving one of its nodes
+	remove_node_connections(id);
+	erase_node(location);
+	record_change(GraphChangeType::NODE_REMOVED, id);
+}
+
+void csg::Graph::insert_connection(const Connection& connection)
+{
+	// Replaces any existing connection to dest
+	remove_connection(connection.dest());
+	connections_by_dest.insert_or_assign(connection.dest(), connection);
+	_content_hash += connection_hash(connection);
+	connections_by_node[connection.source().node_id()].output.push_back(connection);
+	connections_by_node[connection.dest().node_id()].input.push_back(connection);
+	record_change(GraphChangeType::CONNECTION_ADDED, connection);
+}
+
+void csg::Graph::remove_node_connections(const NodeId id)
+{
+	const NodeConnections* const node_connections{ connections_by_node.find(id) };
+	if (node_connections == nullptr) {
+		return;
+	}
+	// Copy the dest slots first, remove_connection modifies the lists being read here
+	std::vector<SlotId> dests;
+	dests.reserve(node_connections->input.size() + node_connections->output.size());
+	for (const Connection& this_conn : node_connections->input) {
+		dests.push_back(this_conn.dest());
+	}
+	for (const Connection& this_conn : node_connections->output) {
+		dests.push_back(this_conn.dest());
+	}
+	for (const SlotId this_dest : dests) {
+		remove_connection(this_dest);
+	}
+}
+
+void csg::Graph::record_change(const GraphChangeType type, const NodeId id)
+{
+	record_change(type, SlotId{ id, 0 });
+}
+
+void csg::Graph::record_change(const GraphChangeType type, const SlotId slot_id)
+{
+	if (_journal) {
+		_journal->record(type, slot_id, slot_id);
+	}
+}
+
+void csg::Graph::record_change(const GraphChangeType type, const Connection& connection)
+{
+	if (_journal) {
+		_journal->record(type, connection.dest(), connection.source());
+	}
+}
+
+csg::NodeId csg::Graph::Transaction::add(const NodeType type, const csc::Int2 pos)
+{
+	while (true) {
+		const std::shared_ptr<const Node> new_node{ std::make_shared<Node>(type, pos) };
+		if (new_nodes.count(new_node->id()) == 0 && graph.contains(new_node->id()) == false) {
+			queue_node(new_node);
+			return new_node->id();
+		}
+	}
+}
+
+void csg::Graph::Transaction::add(const NodeType type, const csc::Int2 pos, const NodeId id)
+{
+	// A duplicate id is rejected by validate(), so commit() fails before any edit is applied
+	queue_node(std::make_shared<Node>(type, pos, id));
+}
+
+boost::optional<csg::NodeId> csg::Graph::Transaction::duplicate(const NodeId node_id)
+{
+	const csc::Int2 duplicate_offset{ 20, 20 };
+
+	const std::shared_ptr<const Node> old_node{ find_node(node_id) };
+	if (old_node == nullptr) {
+		return boost::none;
+	}
+
+	const boost::optional<NodeTypeInfo> old_type_info{ NodeTypeInfo::from(old_node->type()) };
+	assert(old_type_info.has_value());
+	if (old_type_info->allow_creation() == false) {
+		return boost::none;
+	}
+
+	while (true) {
+		const std::shared_ptr<Node> new_node{ std::make_shared<Node>(old_node->type(), old_node->position + duplicate_offset) };
+		if (find_node(new_node->id()) == nullptr) {
+			new_node->copy_from(*old_node);
+			queue_node(new_node);
+			return new_node->id();
+		}
+	}
+}
+
+void csg::Graph::Transaction::remove(const NodeId id)
+{
+	edits.push_back(Edit{ EditType::REMOVE_NODE, SlotId{ id, 0 } });
+}
+
+void csg::Graph::Transaction::add_connection(const SlotId source, const SlotId dest)
+{
+	Edit new_edit{ EditType::ADD_CONNECTION, dest };
+	new_edit.value.source = source;
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::remove_connection(const SlotId dest)
+{
+	edits.push_back(Edit{ EditType::REMOVE_CONNECTION, dest });
+}
+
+void csg::Graph::Transaction::set_bool(const SlotId slot_id, const bool new_value)
+{
+	Edit new_edit{ EditType::SET_BOOL, slot_id };
+	new_edit.value.bool_value = new_value;
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::set_color(const SlotId slot_id, const csc::Float3 new_value)
+{
+	Edit new_edit{ EditType::SET_COLOR, slot_id };
+	new_edit.value.float3_value = new_value;
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::set_enum(const SlotId slot_id, const size_t new_value)
+{
+	Edit new_edit{ EditType::SET_ENUM, slot_id };
+	new_edit.value.size_value = new_value;
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::set_float(const SlotId slot_id, const float new_value)
+{
+	Edit new_edit{ EditType::SET_FLOAT, slot_id };
+	new_edit.value.float_value = new_value;
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::set_int(const SlotId slot_id, const int new_value)
+{
+	Edit new_edit{ EditType::SET_INT, slot_id };
+	new_edit.value.int_value = new_value;
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::set_vector(const SlotId slot_id, const csc::Float3 new_value)
+{
+	Edit new_edit{ EditType::SET_VECTOR, slot_id };
+	new_edit.value.float3_value = new_value;
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::set_color_ramp(const SlotId slot_id, ColorRampSlotValue new_value)
+{
+	Edit new_edit{ EditType::SET_LARGE_VALUE, slot_id };
+	new_edit.value.payload_index = large_values.size();
+	large_values.push_back(std::make_unique<SlotValue>(std::move(new_value)));
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::set_curve_rgb(const SlotId slot_id, RGBCurveSlotValue new_value)
+{
+	Edit new_edit{ EditType::SET_LARGE_VALUE, slot_id };
+	new_edit.value.payload_index = large_values.size();
+	large_values.push_back(std::make_unique<SlotValue>(std::move(new_value)));
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::set_curve_vec(const SlotId slot_id, VectorCurveSlotValue new_value)
+{
+	Edit new_edit{ EditType::SET_LARGE_VALUE, slot_id };
+	new_edit.value.payload_index = large_values.size();
+	large_values.push_back(std::make_unique<SlotValue>(std::move(new_value)));
+	edits.push_back(std::move(new_edit));
+}
+
+void csg::Graph::Transaction::move(const NodeId id, const csc::Float2 delta)
+{
+	Edit new_edit{ EditType::MOVE_NODE, SlotId{ id, 0 } };
+	new_edit.value.delta = delta;
+	edits.push_back(std::move(new_edit));
+}
+
+bool csg::Graph::Transaction::commit()
+{
+	// Everything is checked before the graph is touched, so a failed commit has nothing to roll back
+	const bool success{ validate() };
+	if (success) {
+		// A node's hash is refreshed once the edits after it move on to another node, so a run of edits to the
+		// same node only hashes it once. Keys stay valid as other nodes are removed, unlike locations.
+		boost::optional<NodeId> stale_id;
+		csc::SlotMapKey stale_key;
+		for (Edit& this_edit : edits) {
+			const NodeId this_id{ this_edit.slot_id.node_id() };
+			if (stale_id.has_value() && (*stale_id != this_id || this_edit.type == EditType::REMOVE_NODE)) {
+				graph.refresh_hash(*graph.node_locations.get(stale_key));
+				stale_id = boost::none;
+			}
+			if (stale_id == this_id) {
+				// Covers nodes added earlier in this transaction, which validate() could not find a key for
+				this_edit.key = stale_key;
+			}
+			const boost::optional<csc::SlotMapKey> edited_key{ apply(this_edit) };
+			if (edited_key.has_value()) {
+				stale_id = this_id;
+				stale_key = *edited_key;
+			}
+		}
+		if (stale_id.has_value()) {
+			graph.refresh_hash(*graph.node_locations.get(stale_key));
+		}
+		// Removals leave partially filled blocks, these are repacked once instead of after every removal
+		graph.compact_blocks();
+	}
+	edits.clear();
+	added_nodes.clear();
+	large_values.clear();
+	new_nodes.clear();
+	return success;
+}
+
+bool csg::Graph::Transaction::validate()
+{
+	// Tracks which nodes exist at each point in the queue without modifying the graph
+	// Nodes added by this transaction are looked up here first, a node removed after being added maps to nullptr
+	std::unordered_map<NodeId, const Node*> queued_nodes;
+	queued_nodes.reserve(new_nodes.size());
+	// Nodes of the graph removed so far, indexed by key so removing them needs no hashing
+	std::vector<bool> removed_keys;
+	csc::SlotMapKey graph_key;
+	// Runs of edits to the same node are common, so the last lookup is kept
+	boost::optional<NodeId> cached_id;
+	const Node* cached_node{ nullptr };
+	csc::SlotMapKey cached_key;
+	const auto find_live_node = [&](const NodeId id) -> const Node* {
+		if (cached_id == id) {
+			graph_key = cached_key;
+			return cached_node;
+		}
+		graph_key = csc::SlotMapKey{};
+		cached_id = id;
+		const auto iter{ queued_nodes.empty() ? queued_nodes.end() : queued_nodes.find(id) };
+		if (iter != queued_nodes.end()) {
+			cached_node = iter->second;
+		}
+		else {
+			const csc::SlotMapKey* const key{ graph.keys_by_id.find(id) };
+			if (key != nullptr && (key->index() >= removed_keys.size() || removed_keys[key->index()] == false)) {
+				graph_key = *key;
+				const NodeLocation location{ *graph.node_locations.get(*key) };
+				cached_node = graph.node_blocks[location.block]->nodes[location.index].get();
+			}
+			else {
+				cached_node = nullptr;
+			}
+		}
+		cached_key = graph_key;
+		return cached_node;
+	};
+
+	for (Edit& this_edit : edits) {
+		const NodeId node_id{ this_edit.slot_id.node_id() };
+		const size_t slot_index{ this_edit.slot_id.index() };
+		const Node* const node{ find_live_node(node_id) };
+		this_edit.key = graph_key;
+		switch (this_edit.type) {
+		case EditType::ADD_NODE:
+			if (node != nullptr) {
+				return false;
+			}
+			queued_nodes[node_id] = added_nodes[this_edit.value.payload_index].get();
+			cached_id = node_id;
+			cached_node = added_nodes[this_edit.value.payload_index].get();
+			cached_key = csc::SlotMapKey{};
+			break;
+		case EditType::REMOVE_NODE:
+			if (node == nullptr || NodeTypeInfo::from(node->type())->category() == NodeCategory::OUTPUT) {
+				return false;
+			}
+			if (graph.node_locations.contains(this_edit.key)) {
+				if (this_edit.key.index() >= removed_keys.size()) {
+					removed_keys.resize(this_edit.key.index() + 1);
+				}
+				removed_keys[this_edit.key.index()] = true;
+			}
+			else {
+				queued_nodes[node_id] = nullptr;
+			}
+			cached_id = node_id;
+			cached_node = nullptr;
+			cached_key = csc::SlotMapKey{};
+			break;
+		case EditType::ADD_CONNECTION:
+		{
+			const Node* const source_node{ find_live_node(this_edit.value.source.node_id()) };
+			if (node == nullptr || source_node == nullptr || node == source_node) {
+				return false;
+			}
+			if (source_node->has_pin(this_edit.value.source.index(), SlotDirection::OUTPUT) == false) {
+				return false;
+			}
+			if (node->has_pin(slot_index, SlotDirection::INPUT) == false) {
+				return false;
+			}
+			break;
+		}
+		case EditType::REMOVE_CONNECTION:
+			// Matches Graph::remove_connection, removing a connection that does not exist is allowed
+			break;
+		case EditType::SET_BOOL:
+			if (node == nullptr || node->slot_value_as_ptr<BoolSlotValue>(slot_index) == nullptr) {
+				return false;
+			}
+			break;
+		case EditType::SET_COLOR:
+			if (node == nullptr || node->slot_value_as_ptr<ColorSlotValue>(slot_index) == nullptr) {
+				return false;
+			}
+			break;
+		case EditType::SET_ENUM:
+			if (node == nullptr || node->slot_value_as_ptr<EnumSlotValue>(slot_index) == nullptr) {
+				return false;
+			}
+			break;
+		case EditType::SET_FLOAT:
+			if (node == nullptr || node->slot_value_as_ptr<FloatSlotValue>(slot_index) == nullptr) {
 				return false;
 			}
-			if (*this_node != *other_node) {
+			break;
+		case EditType::SET_INT:
+			if (node == nullptr || node->slot_value_as_ptr<IntSlotValue>(slot_index) == nullptr) {
 				return false;
 			}
+			break;
+		case EditType::SET_VECTOR:
+			if (node == nullptr || node->slot_value_as_ptr<VectorSlotValue>(slot_index) == nullptr) {
+				return false;
+			}
+			break;
+		case EditType::SET_LARGE_VALUE:
+		{
+			const SlotValue* const old_value{ node ? node->slot_value_ptr(slot_index) : nullptr };
+			if (old_value == nullptr || old_value->type() != large_values[this_edit.value.payload_index]->type()) {
+				return false;
+			}
+			break;
+		}
+		case EditType::MOVE_NODE:
+			if (node == nullptr) {
+				return false;
+			}
+			break;
 		}
 	}
-
 	return true;
 }
+
+boost::optional<csc::SlotMapKey> csg::Graph::Transaction::apply(Edit& edit)
+{
+	// Edits have already been validated, so none of these can fail and none are checked again
+	const SlotId slot_id{ edit.slot_id };
+	const auto edited_key = [&]() -> csc::SlotMapKey {
+		return graph.node_locations.contains(edit.key) ? edit.key : *graph.keys_by_id.find(slot_id.node_id());
+	};
+	const auto if_changed = [](const bool changed, const csc::SlotMapKey key) -> boost::optional<csc::SlotMapKey> {
+		return changed ? boost::make_optional(key) : boost::none;
+	};
+	switch (edit.type) {
+	case EditType::ADD_NODE:
+	{
+		// Giving up the queued reference means the node is not shared and later edits can modify it in place
+		// The real hash is filled in when the node is refreshed
+		const std::shared_ptr<const Node> new_node{ std::move(added_nodes[edit.value.payload_index]) };
+		graph.append_node(new_node, 0);
+		graph.record_change(GraphChangeType::NODE_ADDED, new_node->id());
+		return graph.node_blocks.back()->keys.back();
+	}
+	case EditType::REMOVE_NODE:
+		graph.remove_node(*graph.node_locations.get(edited_key()));
+		return boost::none;
+	case EditType::ADD_CONNECTION:
+		graph.insert_connection(Connection{ edit.value.source, slot_id });
+		return boost::none;
+	case EditType::REMOVE_CONNECTION:
+		graph.remove_connection(slot_id);
+		return boost::none;
+	default:
+		break;
+	}
+
+	const csc::SlotMapKey key{ edited_key() };
+	const NodeLocation location{ *graph.node_locations.get(key) };
+	switch (edit.type) {
+	case EditType::SET_BOOL:
+		return if_changed(graph.update_slot_value<BoolSlotValue>(location, slot_id.index(), edit.value.bool_value), key);
+	case EditType::SET_COLOR:
+		return if_changed(graph.update_slot_value<ColorSlotValue>(location, slot_id.index(), edit.value.float3_value), key);
+	case EditType::SET_ENUM:
+		return if_changed(graph.update_slot_value<EnumSlotValue>(location, slot_id.index(), edit.value.size_value), key);
+	case EditType::SET_FLOAT:
+		return if_changed(graph.update_slot_value<FloatSlotValue>(location, slot_id.index(), edit.value.float_value), key);
+	case EditType::SET_INT:
+		return if_changed(graph.update_slot_value<IntSlotValue>(location, slot_id.index(), edit.value.int_value), key);
+	case EditType::SET_VECTOR:
+		return if_changed(graph.update_slot_value<VectorSlotValue>(location, slot_id.index(), edit.value.float3_value), key);
+	case EditType::SET_LARGE_VALUE:
+		// The edit is discarded after commit, so its payload can be moved into the graph
+		switch (large_values[edit.value.payload_index]->type()) {
+		case SlotType::COLOR_RAMP:
+			return if_changed(graph.replace_slot_value<ColorRampSlotValue>(location, slot_id.index(),
+				std::move(*large_values[edit.value.payload_index]->as_ptr<ColorRampSlotValue>())), key);
+		case SlotType::CURVE_RGB:
+			return if_changed(graph.replace_slot_value<RGBCurveSlotValue>(location, slot_id.index(),
+				std::move(*large_values[edit.value.payload_index]->as_ptr<RGBCurveSlotValue>())), key);
+		case SlotType::CURVE_VECTOR:
+			return if_changed(graph.replace_slot_value<VectorCurveSlotValue>(location, slot_id.index(),
+				std::move(*large_values[edit.value.payload_index]->as_ptr<VectorCurveSlotValue>())), key);
+		default:
+			assert(false);
+			return boost::none;
+		}
+	case EditType::MOVE_NODE:
+	{
+		const std::shared_ptr<Node> node{ graph.get_mutable(location) };
+		node->position = csc::Int2{ csc::Float2{ node->position } + edit.value.delta };
+		graph.record_change(GraphChangeType::NODE_MOVED, slot_id.node_id());
+		return key;
+	}
+	default:
+		break;
+	}
+	return boost::none;
+}
+
+std::shared_ptr<const csg::Node> csg::Graph::Transaction::find_node(const NodeId id) const
+{
+	const auto iter{ new_nodes.find(id) };
+	if (iter != new_nodes.end()) {
+		return added_nodes[iter->second];
+	}
+	return graph.get(id);
+}
+
+void csg::Graph::Transaction::queue_node(const std::shared_ptr<const Node>& node)
+{
+	new_nodes[node->id()] = added_nodes.size();
+	Edit new_edit{ EditType::ADD_NODE, SlotId{ node->id(), 0 } };
+	new_edit.value.payload_index = added_nodes.size();
+	added_nodes.push_back(node);
+	edits.push_back(std::move(new_edit));
+}
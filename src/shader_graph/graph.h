@@ -2,29 +2,33 @@
 
 /**
  * @file
- * @brief Defines Connection and Graph.
+ * @brief Defines Connection, Graph, and related types.
  */
 
 #include <cstddef>
-#include <list>
-#include <map>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/transform_iterator.hpp>
 #include <boost/optional.hpp>
 
+#include "shader_core/persistent_map.h"
+#include "shader_core/slot_map.h"
+#include "shader_core/vector.h"
+
 #include "node_id.h"
 #include "node_type.h"
 #include "slot.h"
 #include "slot_id.h"
 
-namespace csc {
-	class Float2;
-	class Float3;
-	class Int2;
-}
-
 namespace csg {
 	class Node;
 
@@ -43,6 +47,9 @@ namespace csg {
 		SlotId source() const { return _source; }
 		SlotId dest() const { return _dest; }
 
+		bool operator==(const Connection& other) const { return _source == other._source && _dest == other._dest; }
+		bool operator!=(const Connection& other) const { return operator==(other) == false; }
+
 		bool operator<(const Connection& other) const;
 
 	private:
@@ -50,35 +57,238 @@ namespace csg {
 		SlotId _dest;
 	};
 
+	enum class GraphChangeType {
+		NODE_ADDED,
+		NODE_REMOVED,
+		NODE_MOVED,
+		NODE_RAISED,
+		SLOT_VALUE_CHANGED,
+		CONNECTION_ADDED,
+		CONNECTION_REMOVED,
+	};
+
+	/**
+	 * @brief Record of a single edit made to a Graph.
+	 */
+	class GraphChange {
+	public:
+		GraphChange(GraphChangeType type, uint64_t version, SlotId slot_id, SlotId source) :
+			_type{ type }, _version{ version }, _slot_id{ slot_id }, _source{ source } {}
+
+		GraphChangeType type() const { return _type; }
+		// Version of the graph after this change was made
+		uint64_t version() const { return _version; }
+
+		NodeId node_id() const { return _slot_id.node_id(); }
+		// The changed slot, or the dest of a changed connection
+		SlotId slot_id() const { return _slot_id; }
+		// Only meaningful for connection changes
+		Connection connection() const { return Connection{ _source, _slot_id }; }
+
+	private:
+		GraphChangeType _type;
+		uint64_t _version;
+		SlotId _slot_id;
+		SlotId _source;
+	};
+
+	/**
+	 * @brief Append-only log of the changes made to a Graph.
+	 *
+	 * Records are stored in fixed-size chunks shared between copies of a Graph, like node blocks. Versions are unique
+	 * across every journal in the process, so a version taken from one graph is never mistaken for a point in the
+	 * history of another, including an older copy of the same graph restored by undo.
+	 */
+	class GraphJournal {
+	public:
+		// Once this many records are stored the oldest are discarded
+		static constexpr size_t CAPACITY{ 65536 };
+
+		GraphJournal();
+
+		// Version of the latest change, or of the point the journal was started if nothing has changed since
+		uint64_t version() const { return chunks.empty() ? base_version : chunks.back()->back().version(); }
+		// Oldest version changes can still be read from
+		uint64_t oldest_version() const { return base_version; }
+		size_t size() const;
+
+		// Changes made after version, oldest first
+		// Returns none if version is not in this journal, or is so old its records were discarded, the caller must
+		// then rebuild whatever it derives from the graph
+		boost::optional<std::vector<GraphChange>> changes_since(uint64_t version) const;
+
+		void record(GraphChangeType type, SlotId slot_id, SlotId source);
+
+	private:
+		static constexpr size_t CHUNK_CAPACITY{ 256 };
+		typedef std::vector<GraphChange> Chunk;
+
+		std::vector<std::shared_ptr<Chunk>> chunks;
+		// Version before the oldest stored record
+		uint64_t base_version;
+	};
+
+	/**
+	 * @brief Fixed-capacity run of nodes in draw order. Blocks are shared between copies of a Graph and copied on write.
+	 */
+	class NodeBlock {
+	public:
+		static constexpr size_t CAPACITY{ 64 };
+
+		// Kept alongside nodes so comparing blocks does not touch every node
+		std::vector<NodeId> ids;
+		// Key of each node's location in its Graph, so the locations of nodes that shift can be updated
+		std::vector<csc::SlotMapKey> keys;
+		std::vector<std::shared_ptr<const Node>> nodes;
+		// Cached Node::content_hash for each node
+		std::vector<uint64_t> hashes;
+	};
+
+	/**
+	 * @brief Read-only view of the nodes in a Graph, ordered from the top of the draw order to the bottom.
+	 */
+	class NodeRange {
+	public:
+		typedef std::vector<std::shared_ptr<NodeBlock>> BlockVector;
+
+		class const_iterator : public boost::iterator_facade<const_iterator, const std::shared_ptr<const Node>, boost::bidirectional_traversal_tag> {
+		public:
+			const_iterator() : blocks{ nullptr }, block_count{ 0 }, node_count{ 0 } {}
+			// Counts are one past the position, so { 0, 0 } is the end of the range
+			const_iterator(const BlockVector& blocks, const size_t block_count, const size_t node_count) :
+				blocks{ &blocks }, block_count{ block_count }, node_count{ node_count }
+			{
+				skip_empty_blocks();
+			}
+
+		private:
+			friend class boost::iterator_core_access;
+
+			// Blocks emptied by removing nodes are kept until the graph repacks its blocks
+			void skip_empty_blocks()
+			{
+				while (node_count == 0 && block_count > 0) {
+					block_count--;
+					node_count = (block_count > 0) ? (*blocks)[block_count - 1]->nodes.size() : 0;
+				}
+			}
+
+			void increment()
+			{
+				node_count--;
+				skip_empty_blocks();
+			}
+
+			void decrement()
+			{
+				if (block_count == 0 || node_count == (*blocks)[block_count - 1]->nodes.size()) {
+					do {
+						block_count++;
+					} while ((*blocks)[block_count - 1]->nodes.empty());
+					node_count = 1;
+				}
+				else {
+					node_count++;
+				}
+			}
+
+			bool equal(const const_iterator& other) const { return block_count == other.block_count && node_count == other.node_count; }
+
+			const std::shared_ptr<const Node>& dereference() const { return (*blocks)[block_count - 1]->nodes[node_count - 1]; }
+
+			const BlockVector* blocks;
+			size_t block_count;
+			size_t node_count;
+		};
+		typedef const_iterator iterator;
+
+		NodeRange(const BlockVector& blocks, const size_t node_count) : blocks{ blocks }, node_count{ node_count } {}
+
+		const_iterator begin() const
+		{
+			if (blocks.empty()) {
+				return end();
+			}
+			return const_iterator{ blocks, blocks.size(), blocks.back()->nodes.size() };
+		}
+		const_iterator end() const { return const_iterator{ blocks, 0, 0 }; }
+
+		size_t size() const { return node_count; }
+		bool empty() const { return node_count == 0; }
+
+	private:
+		const BlockVector& blocks;
+		size_t node_count;
+	};
+
+	/**
+	 * @brief Read-only view of the connections in a Graph, in no particular order.
+	 */
+	class ConnectionRange {
+	public:
+		typedef csc::PersistentMap<SlotId, Connection> ConnectionMap;
+
+		struct GetConnection {
+			const Connection& operator()(const std::pair<const SlotId, Connection>& entry) const { return entry.second; }
+		};
+		typedef boost::transform_iterator<GetConnection, ConnectionMap::const_iterator> const_iterator;
+		typedef const_iterator iterator;
+
+		ConnectionRange(const ConnectionMap& storage) : storage{ storage } {}
+
+		const_iterator begin() const { return const_iterator{ storage.begin(), GetConnection{} }; }
+		const_iterator end() const { return const_iterator{ storage.end(), GetConnection{} }; }
+
+		size_t size() const { return storage.size(); }
+		bool empty() const { return storage.empty(); }
+
+	private:
+		const ConnectionMap& storage;
+	};
+
 	/**
 	 * @brief Class to manage and operate on a shader graph.
 	 */
 	class Graph {
 	public:
-		// Deserialize a graph
+		class Transaction;
+
+		// Deserialize a graph from either the text or binary format, the format is detected from the header
 		static boost::optional<Graph> from(const std::string& graph_string);
+		static boost::optional<Graph> from(std::istream& input);
 
 		Graph(GraphType type);
 
-		// Copy constructor and copy assignment operator, constructor defers to assignment
-		Graph(const Graph& other) { this->operator=(other); }
-		Graph& operator=(const Graph& other);
+		// Copies share all nodes with the original, a node is only copied when one of the graphs modifies it
+		Graph(const Graph& other) = default;
+		Graph& operator=(const Graph& other) = default;
 
 		std::shared_ptr<const Node> get(NodeId id) const;
 		boost::optional<SlotValue> get_slot_value(SlotId slot_id) const;
 		template <typename T> boost::optional<T> get_slot_value_as(SlotId slot_id) const
 		{
-			const boost::optional<SlotValue> opt_value{ get_slot_value(slot_id) };
-			if (opt_value) {
-				return opt_value->as<T>();
+			const T* const value_ptr{ get_slot_value_as_ptr<T>(slot_id) };
+			if (value_ptr) {
+				return *value_ptr;
 			}
 			else {
 				return boost::none;
 			}
 		}
+		// Returns nullptr if the slot does not exist or does not have a value
+		// The pointer is only valid until this graph is next modified
+		const SlotValue* get_slot_value_ptr(SlotId slot_id) const;
+		template <typename T> const T* get_slot_value_as_ptr(SlotId slot_id) const
+		{
+			const SlotValue* const value_ptr{ get_slot_value_ptr(slot_id) };
+			return value_ptr ? value_ptr->as_ptr<T>() : nullptr;
+		}
 
 		NodeId add(NodeType type, csc::Int2 pos);
 		bool add(NodeType type, csc::Int2 pos, NodeId id);
+		// Adds every node of other above this graph's nodes, sharing them with other rather than copying
+		// Connections are not added, returns false and adds nothing if any of the ids are already in this graph
+		bool add_nodes(const Graph& other);
 		void remove(const std::set<NodeId>& ids);
 		boost::optional<NodeId> duplicate(NodeId node_id);
 
@@ -91,27 +301,196 @@ namespace csg {
 		bool set_float(SlotId slot_id, float new_value);
 		bool set_int(SlotId slot_id, int new_value);
 		bool set_vector(SlotId slot_id, csc::Float3 new_value);
-		bool set_color_ramp(SlotId slot_id, const ColorRampSlotValue& new_value);
-		bool set_curve_rgb(SlotId slot_id, const RGBCurveSlotValue& new_value);
-		bool set_curve_vec(SlotId slot_id, const VectorCurveSlotValue& new_value);
+		// Large values are taken by value, pass an rvalue to move it into the graph without a copy
+		bool set_color_ramp(SlotId slot_id, ColorRampSlotValue new_value);
+		bool set_curve_rgb(SlotId slot_id, RGBCurveSlotValue new_value);
+		bool set_curve_vec(SlotId slot_id, VectorCurveSlotValue new_value);
 
 		void move(const std::set<NodeId>& ids, csc::Float2 delta);
 		void raise(NodeId id);
 
 		bool contains(NodeId id) const;
 
-		const std::list<std::shared_ptr<Node>>& nodes() const { return _nodes; }
-		const std::list<Connection> connections() const { return _connections; }
+		NodeRange nodes() const { return NodeRange{ node_blocks, node_count }; }
+		ConnectionRange connections() const { return ConnectionRange{ connections_by_dest }; }
+		boost::optional<Connection> connection_to(SlotId dest) const;
+		// Connections that end at (input) or begin at (output) any slot of the given node
+		const std::vector<Connection>& input_connections(NodeId id) const;
+		const std::vector<Connection>& output_connections(NodeId id) const;
 
 		std::string serialize() const;
+		bool serialize(std::ostream& output) const;
+		std::string serialize_binary() const;
 
+		// Order-independent hash of all nodes and connections, updated incrementally as the graph is edited
+		uint64_t content_hash() const { return _content_hash; }
+		// Hash of what affects the rendered shader: node types, slot values and connections reachable from the material output
+		// Positions, draw order and node ids are not included, so two graphs that render the same hash the same
+		uint64_t semantic_hash() const;
+
+		// The journal is off by default, enabling it starts a new empty journal and disabling it discards the journal
+		void set_journal_enabled(bool enabled);
+		// Returns nullptr if the journal is not enabled
+		const GraphJournal* journal() const { return _journal.get_ptr(); }
+
+		// Graphs with different content hashes are rejected without comparing any nodes
+		// The journal is not compared
 		bool operator==(const Graph& other) const;
 		bool operator!=(const Graph& other) const { return (operator==(other) == false); }
 
 	private:
-		std::list<std::shared_ptr<Node>> _nodes;
-		std::list<Connection> _connections;
+		// Location of a node within node_blocks, changes when nodes before it in its block are removed or blocks are repacked
+		struct NodeLocation {
+			size_t block;
+			size_t index;
+		};
+
+		struct NodeConnections {
+			std::vector<Connection> input;
+			std::vector<Connection> output;
+		};
+
+		boost::optional<NodeLocation> locate(NodeId id) const;
+		std::shared_ptr<Node> get_mutable(NodeId id);
+		std::shared_ptr<Node> get_mutable(NodeLocation location);
+		NodeBlock& mutable_block(size_t block);
+		// Returns false and adds nothing if a node with the same id is already in the graph
+		bool append_node(const std::shared_ptr<const Node>& node, uint64_t hash);
+		void refresh_hash(NodeId id);
+		void refresh_hash(NodeLocation location);
+		void erase_node(NodeLocation location);
+		void compact_blocks();
+		// Setters return true only if the stored value changed, nothing is copied or allocated when it does not
+		// Values cheap to copy are set on a copy first so clamping is applied before comparing
+		template <typename TSlot, typename TRaw> bool update_slot_value(SlotId slot_id, TRaw new_value);
+		// Moves new_value into the slot if it differs from the current value
+		template <typename TSlot> bool replace_slot_value(SlotId slot_id, TSlot&& new_value);
+		// Same as above for a node that is already located, refreshing the node's hash is left to the caller
+		template <typename TSlot, typename TRaw> bool update_slot_value(NodeLocation location, size_t index, TRaw new_value);
+		template <typename TSlot> bool replace_slot_value(NodeLocation location, size_t index, TSlot&& new_value);
+		// Unchecked parts of remove() and add_connection(), for edits that have already been validated
+		void remove_node(NodeLocation location);
+		void insert_connection(const Connection& connection);
+		void remove_node_connections(NodeId id);
+		void record_change(GraphChangeType type, NodeId id);
+		void record_change(GraphChangeType type, SlotId slot_id);
+		void record_change(GraphChangeType type, const Connection& connection);
+
+		// Nodes are stored from the bottom of the draw order to the top
+		// A block emptied by removals stays in place until compact_blocks(), so the blocks after it keep their index
+		NodeRange::BlockVector node_blocks;
+		size_t node_count{ 0 };
+		// A node's key is fixed while it is in the graph, only the location it maps to is updated when the node shifts
+		// Finding a node is then a hash lookup and two array indexes, however large the graph
+		csc::PersistentMap<NodeId, csc::SlotMapKey> keys_by_id;
+		csc::SlotMap<NodeLocation> node_locations;
+
+		// Connections are indexed by their dest slot, a slot may only have one incoming connection
+		csc::PersistentMap<SlotId, Connection> connections_by_dest;
+		csc::PersistentMap<NodeId, NodeConnections> connections_by_node;
+
+		// Sum of the hashes of every node and connection, addition keeps it independent of order
+		uint64_t _content_hash{ 0 };
+
+		boost::optional<GraphJournal> _journal;
+	};
+
+	/**
+	 * @brief Queues edits to a Graph so they can be applied together.
+	 *
+	 * Nothing in the graph changes until commit() is called. The whole queue is validated before the first edit is
+	 * applied, so a transaction containing any invalid edit leaves the graph untouched.
+	 */
+	class Graph::Transaction {
+	public:
+		Transaction(Graph& graph) : graph{ graph } {}
+
+		// New nodes are created when queued, so their ids can be used by later edits in the same transaction
+		NodeId add(NodeType type, csc::Int2 pos);
+		void add(NodeType type, csc::Int2 pos, NodeId id);
+		// Returns none if node_id is not in the graph or this transaction, or if its type cannot be created
+		boost::optional<NodeId> duplicate(NodeId node_id);
+		void remove(NodeId id);
+
+		void add_connection(SlotId source, SlotId dest);
+		void remove_connection(SlotId dest);
+
+		void set_bool(SlotId slot_id, bool new_value);
+		void set_color(SlotId slot_id, csc::Float3 new_value);
+		void set_enum(SlotId slot_id, size_t new_value);
+		void set_float(SlotId slot_id, float new_value);
+		void set_int(SlotId slot_id, int new_value);
+		void set_vector(SlotId slot_id, csc::Float3 new_value);
+		void set_color_ramp(SlotId slot_id, ColorRampSlotValue new_value);
+		void set_curve_rgb(SlotId slot_id, RGBCurveSlotValue new_value);
+		void set_curve_vec(SlotId slot_id, VectorCurveSlotValue new_value);
+
+		void move(NodeId id, csc::Float2 delta);
+
+		size_t size() const { return edits.size(); }
+
+		// Applies every queued edit and clears the queue
+		// Returns false and leaves the graph unchanged if any edit is invalid
+		bool commit();
+
+	private:
+		enum class EditType {
+			ADD_NODE,
+			REMOVE_NODE,
+			ADD_CONNECTION,
+			REMOVE_CONNECTION,
+			SET_BOOL,
+			SET_COLOR,
+			SET_ENUM,
+			SET_FLOAT,
+			SET_INT,
+			SET_VECTOR,
+			SET_LARGE_VALUE,
+			MOVE_NODE,
+		};
+
+		// Each edit only uses one of these, sharing the space keeps the queue small
+		union EditValue {
+		public:
+			EditValue() : size_value{ 0 } {}
+
+			bool bool_value;
+			size_t size_value;
+			float float_value;
+			int int_value;
+			csc::Float3 float3_value;
+			csc::Float2 delta;
+			SlotId source;
+			// Index into added_nodes or large_values
+			size_t payload_index;
+		};
+
+		struct Edit {
+			Edit(EditType type, SlotId slot_id) : type{ type }, slot_id{ slot_id } {}
+
+			EditType type;
+			// Node edits only use the node id, connection edits use slot_id as the dest
+			SlotId slot_id;
+			// Key of the edited node, invalid until known, see validate()
+			csc::SlotMapKey key;
+			EditValue value;
+		};
+
+		// Also records the key of each edited node already in the graph, so apply() does not look it up again
+		bool validate();
+		// Applies an edit that has passed validate() without checking it again
+		// Returns the key of the edited node if its hash must be refreshed
+		boost::optional<csc::SlotMapKey> apply(Edit& edit);
+		std::shared_ptr<const Node> find_node(NodeId id) const;
+		void queue_node(const std::shared_ptr<const Node>& node);
 
-		std::map<NodeId, std::shared_ptr<Node>> nodes_by_id;
+		Graph& graph;
+		// Only appended to and walked in order, a deque grows without moving the edits already queued
+		std::deque<Edit> edits;
+		// Nodes and large values are kept out of the edits themselves, most edits only need a few bytes
+		std::vector<std::shared_ptr<const Node>> added_nodes;
+		std::vector<std::unique_ptr<SlotValue>> large_values;
+		// Index in added_nodes of the nodes created by queued edits, by id
+		std::unordered_map<NodeId, size_t> new_nodes;
 	};
 }
@@ -0,0 +1,224 @@
+#include "library.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "graph.h"
+#include "serialize.h"
+
+// Layout of a library file, all values are little-endian and fixed width so any entry can be read in place:
+//   magic "\x89CSL", u32 format version, u64 entry count
+//   index: for each entry, u64 data offset, u64 data length, u64 semantic hash, u32 name offset, u32 name length
+//   names, then the data of each graph in the binary graph format
+// Offsets are from the start of the file, entries are sorted by name
+
+static const char LIBRARY_MAGIC[]{ '\x89', 'C', 'S', 'L' };
+static const uint32_t LIBRARY_VERSION{ 1 };
+
+static constexpr size_t HEADER_SIZE{ sizeof(LIBRARY_MAGIC) + 4 + 8 };
+static constexpr size_t ENTRY_SIZE{ 8 + 8 + 8 + 4 + 4 };
+
+static void append_u32(std::string& output, const uint32_t value)
+{
+	for (size_t i = 0; i < 4; i++) {
+		output.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+	}
+}
+
+static void append_u64(std::string& output, const uint64_t value)
+{
+	for (size_t i = 0; i < 8; i++) {
+		output.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+	}
+}
+
+static uint64_t read_uint(const char* const data, const size_t size)
+{
+	uint64_t result{ 0 };
+	for (size_t i = 0; i < size; i++) {
+		result |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (i * 8);
+	}
+	return result;
+}
+
+// Reads fields of the entry at index, the caller has already checked the index is within the file
+struct RawEntry {
+	uint64_t data_offset;
+	uint64_t data_length;
+	uint64_t semantic_hash;
+	uint64_t name_offset;
+	uint64_t name_length;
+
+	RawEntry(const boost::string_view bytes, const size_t index)
+	{
+		const char* const entry{ bytes.data() + HEADER_SIZE + index * ENTRY_SIZE };
+		data_offset = read_uint(entry, 8);
+		data_length = read_uint(entry + 8, 8);
+		semantic_hash = read_uint(entry + 16, 8);
+		name_offset = read_uint(entry + 24, 4);
+		name_length = read_uint(entry + 28, 4);
+	}
+};
+
+static bool in_bounds(const boost::string_view bytes, const uint64_t offset, const uint64_t length)
+{
+	return offset <= bytes.size() && length <= bytes.size() - offset;
+}
+
+std::string csg::serialize_library(const std::map<std::string, Graph>& graphs)
+{
+	std::vector<std::string> graph_data;
+	graph_data.reserve(graphs.size());
+	size_t names_size{ 0 };
+	size_t data_size{ 0 };
+	for (const auto& name_graph : graphs) {
+		graph_data.push_back(name_graph.second.serialize_binary());
+		names_size += name_graph.first.size();
+		data_size += graph_data.back().size();
+	}
+
+	const size_t names_begin{ HEADER_SIZE + graphs.size() * ENTRY_SIZE };
+	std::string result;
+	result.reserve(names_begin + names_size + data_size);
+	result.append(LIBRARY_MAGIC, sizeof(LIBRARY_MAGIC));
+	append_u32(result, LIBRARY_VERSION);
+	append_u64(result, graphs.size());
+
+	// std::map is already sorted by name, which is the order the index needs
+	size_t name_offset{ names_begin };
+	size_t data_offset{ names_begin + names_size };
+	size_t index{ 0 };
+	for (const auto& name_graph : graphs) {
+		append_u64(result, data_offset);
+		append_u64(result, graph_data[index].size());
+		append_u64(result, name_graph.second.semantic_hash());
+		append_u32(result, static_cast<uint32_t>(name_offset));
+		append_u32(result, static_cast<uint32_t>(name_graph.first.size()));
+		name_offset += name_graph.first.size();
+		data_offset += graph_data[index].size();
+		index++;
+	}
+	for (const auto& name_graph : graphs) {
+		result.append(name_graph.first);
+	}
+	for (const std::string& data : graph_data) {
+		result.append(data);
+	}
+
+	return result;
+}
+
+boost::optional<csg::GraphLibrary> csg::GraphLibrary::open(const std::string& path)
+{
+	namespace bip = boost::interprocess;
+
+	// Boost.Interprocess reports failure by throwing, keep that from escaping
+	try {
+		const bip::file_mapping file{ path.c_str(), bip::read_only };
+		const auto region{ std::make_shared<const bip::mapped_region>(file, bip::read_only) };
+		const boost::string_view bytes{ static_cast<const char*>(region->get_address()), region->get_size() };
+		boost::optional<GraphLibrary> result{ from(bytes) };
+		if (result) {
+			result->region = region;
+		}
+		return result;
+	}
+	catch (const bip::interprocess_exception&) {
+		return boost::none;
+	}
+}
+
+boost::optional<csg::GraphLibrary> csg::GraphLibrary::from(const boost::string_view library_bytes)
+{
+	if (library_bytes.size() < HEADER_SIZE || std::memcmp(library_bytes.data(), LIBRARY_MAGIC, sizeof(LIBRARY_MAGIC)) != 0) {
+		return boost::none;
+	}
+	if (read_uint(library_bytes.data() + sizeof(LIBRARY_MAGIC), 4) != LIBRARY_VERSION) {
+		return boost::none;
+	}
+	const uint64_t entry_count{ read_uint(library_bytes.data() + sizeof(LIBRARY_MAGIC) + 4, 8) };
+	if (entry_count > (library_bytes.size() - HEADER_SIZE) / ENTRY_SIZE) {
+		return boost::none;
+	}
+
+	// Check every entry once here so the accessors never need to
+	boost::string_view previous_name;
+	for (size_t i = 0; i < entry_count; i++) {
+		const RawEntry raw{ library_bytes, i };
+		if (in_bounds(library_bytes, raw.data_offset, raw.data_length) == false ||
+			in_bounds(library_bytes, raw.name_offset, raw.name_length) == false)
+		{
+			return boost::none;
+		}
+		const boost::string_view name{ library_bytes.substr(raw.name_offset, raw.name_length) };
+		if (i > 0 && previous_name >= name) {
+			// Lookups rely on names being sorted and unique
+			return boost::none;
+		}
+		previous_name = name;
+	}
+
+	return GraphLibrary{ library_bytes, static_cast<size_t>(entry_count) };
+}
+
+csg::LibraryEntry csg::GraphLibrary::entry(const size_t index) const
+{
+	assert(index < entry_count);
+	const RawEntry raw{ bytes, index };
+	LibraryEntry result;
+	result.name = bytes.substr(raw.name_offset, raw.name_length);
+	result.semantic_hash = raw.semantic_hash;
+	result.data = bytes.substr(raw.data_offset, raw.data_length);
+	return result;
+}
+
+boost::optional<size_t> csg::GraphLibrary::find(const boost::string_view name) const
+{
+	// Binary search over the index in place
+	size_t begin{ 0 };
+	size_t end{ entry_count };
+	while (begin < end) {
+		const size_t middle{ begin + (end - begin) / 2 };
+		const RawEntry raw{ bytes, middle };
+		const boost::string_view middle_name{ bytes.substr(raw.name_offset, raw.name_length) };
+		if (middle_name < name) {
+			begin = middle + 1;
+		}
+		else {
+			end = middle;
+		}
+	}
+	if (begin < entry_count && entry(begin).name == name) {
+		return begin;
+	}
+	return boost::none;
+}
+
+boost::optional<csg::Graph> csg::GraphLibrary::load(const size_t index) const
+{
+	if (index >= entry_count) {
+		return boost::none;
+	}
+	return deserialize_graph_binary(entry(index).data);
+}
+
+boost::optional<csg::Graph> csg::GraphLibrary::load(const boost::string_view name) const
+{
+	const boost::optional<size_t> index{ find(name) };
+	if (index.has_value() == false) {
+		return boost::none;
+	}
+	return load(index.value());
+}
+
+csg::GraphLibrary::GraphLibrary(const boost::string_view bytes, const size_t entry_count) : bytes{ bytes }, entry_count{ entry_count } {}
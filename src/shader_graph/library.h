@@ -0,0 +1,64 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines GraphLibrary.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+
+namespace boost {
+	namespace interprocess {
+		class mapped_region;
+	}
+}
+
+namespace csg {
+	class Graph;
+
+	struct LibraryEntry {
+		boost::string_view name;
+		uint64_t semantic_hash;
+		// The serialized graph, in the binary format
+		boost::string_view data;
+	};
+
+	// Builds a library file holding every graph under its name
+	std::string serialize_library(const std::map<std::string, Graph>& graphs);
+
+	/**
+	 * @brief Read-only view of many serialized graphs stored in one file.
+	 *
+	 * Opening a library only checks its index, each graph is deserialized straight from the library bytes when it is
+	 * loaded. Entries are sorted by name so a lookup never reads more of the file than the index and the one graph.
+	 */
+	class GraphLibrary {
+	public:
+		// Maps the file into memory rather than reading it
+		static boost::optional<GraphLibrary> open(const std::string& path);
+		// Reads a library held in memory, the bytes must outlive the returned library and all copies of it
+		static boost::optional<GraphLibrary> from(boost::string_view library_bytes);
+
+		size_t size() const { return entry_count; }
+		LibraryEntry entry(size_t index) const;
+		boost::optional<size_t> find(boost::string_view name) const;
+
+		boost::optional<Graph> load(size_t index) const;
+		boost::optional<Graph> load(boost::string_view name) const;
+
+	private:
+		GraphLibrary(boost::string_view bytes, size_t entry_count);
+
+		// Keeps the file mapped while any copy of this library exists, null when reading bytes owned by the caller
+		std::shared_ptr<const boost::interprocess::mapped_region> region;
+		boost::string_view bytes;
+		size_t entry_count;
+	};
+}
@@ -6,6 +6,7 @@
  */
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,6 +17,7 @@
 #include "shader_core/vector.h"
 
 #include "node_id.h"
+#include "node_schema.h"
 #include "node_type.h"
 #include "slot.h"
 
@@ -30,41 +32,70 @@ namespace csg {
 		Node(NodeType type, csc::Int2 position, NodeId id);
 
 		NodeId id() const { return _id; }
-		NodeType type() const { return _type; }
-		const std::vector<Slot>& slots() const { return _slots; }
-		
+		NodeType type() const { return _schema->type(); }
+		const NodeSchema& schema() const { return *_schema; }
+		size_t slot_count() const { return _schema->slots().size(); }
+
 		boost::optional<size_t> slot_index(SlotDirection dir, const boost::string_view& slot_name) const;
-		boost::optional<Slot> slot(size_t index) const;
-		boost::optional<Slot> slot(SlotDirection dir, const boost::string_view& slot_name) const;
+		// Slot metadata shared by all nodes of this type, the value of the returned slot is always empty
+		// Returns nullptr if the slot does not exist
+		const Slot* slot(size_t index) const;
+		const Slot* slot(SlotDirection dir, const boost::string_view& slot_name) const;
 		boost::optional<SlotValue> slot_value(size_t index) const;
 		boost::optional<SlotValue> slot_value(const boost::string_view& slot_name) const;
-		Slot& slot_ref(size_t index) { return _slots[index]; }
+		// Returns nullptr if the slot does not exist or does not have a value
+		// The pointer is valid until this node is modified or destroyed
+		const SlotValue* slot_value_ptr(size_t index) const;
+		SlotValue* slot_value_ptr(size_t index);
+		const SlotValue* slot_value_ptr(const boost::string_view& slot_name) const;
 
 		template <typename T> boost::optional<T> slot_value_as(size_t index) const
 		{
-			const boost::optional<SlotValue> opt_value{ slot_value(index) };
-			if (opt_value) {
-				return opt_value->as<T>();
+			const T* const value_ptr{ slot_value_as_ptr<T>(index) };
+			if (value_ptr) {
+				return *value_ptr;
 			}
 			else {
 				return boost::none;
 			}
 		}
 
-		template <typename T> boost::optional<T> slot_value_as(const std::string& slot_name) const
+		template <typename T> boost::optional<T> slot_value_as(const boost::string_view& slot_name) const
 		{
-			const boost::optional<SlotValue> opt_value{ slot_value(slot_name) };
-			if (opt_value) {
-				return opt_value->as<T>();
+			const T* const value_ptr{ slot_value_as_ptr<T>(slot_name) };
+			if (value_ptr) {
+				return *value_ptr;
 			}
 			else {
 				return boost::none;
 			}
 		}
 
+		template <typename T> const T* slot_value_as_ptr(size_t index) const
+		{
+			const SlotValue* const value_ptr{ slot_value_ptr(index) };
+			return value_ptr ? value_ptr->as_ptr<T>() : nullptr;
+		}
+
+		template <typename T> const T* slot_value_as_ptr(const boost::string_view& slot_name) const
+		{
+			const SlotValue* const value_ptr{ slot_value_ptr(slot_name) };
+			return value_ptr ? value_ptr->as_ptr<T>() : nullptr;
+		}
+
+		// For editing a value in place, returns nullptr if the slot does not have a value of type T
+		template <typename T> T* slot_value_as_mutable_ptr(size_t index)
+		{
+			SlotValue* const value_ptr{ slot_value_ptr(index) };
+			return value_ptr ? value_ptr->as_ptr<T>() : nullptr;
+		}
+
 		void copy_from(const Node& other);
 
-		bool has_pin(size_t index, SlotDirection direction) const { return index < _slots.size() && _slots[index].dir() == direction; }
+		bool has_pin(size_t index, SlotDirection direction) const { return index < slot_count() && _schema->slots()[index].dir() == direction; }
+
+		// Hash of everything operator== compares, computed from scratch on each call
+		uint64_t content_hash() const;
 
 		bool operator==(const Node& other) const;
 		bool operator!=(const Node& other) const { return operator==(other) == false; }
@@ -75,7 +106,8 @@ namespace csg {
 		NodeId roll_id();
 
 		NodeId _id;
-		NodeType _type;
-		std::vector<Slot> _slots;
+		const NodeSchema* _schema;
+		// One entry for each slot with a value, see NodeSchema::value_index
+		std::vector<SlotValue> values;
 	};
 }
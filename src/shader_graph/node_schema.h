@@ -0,0 +1,47 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Defines NodeSchema.
+ */
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+
+#include "node_type.h"
+#include "slot.h"
+
+namespace csg {
+
+	/**
+	 * @brief The slot layout and default values shared by every node of one type.
+	 */
+	class NodeSchema {
+	public:
+		// Schemas are built once on first use and never modified
+		static const NodeSchema& from(NodeType type);
+
+		NodeType type() const { return _type; }
+		// Slot names, directions, and types, the value of each slot is always empty
+		const std::vector<Slot>& slots() const { return _slots; }
+		// Default values for only the slots that have a value, in slot order
+		const std::vector<SlotValue>& default_values() const { return _default_values; }
+
+		boost::optional<size_t> slot_index(SlotDirection dir, const boost::string_view& slot_name) const;
+		// Index into default_values() for the given slot, none if the slot has no value
+		boost::optional<size_t> value_index(size_t slot_index) const;
+
+	private:
+		static constexpr size_t NO_VALUE{ static_cast<size_t>(-1) };
+
+		NodeSchema(NodeType type);
+
+		NodeType _type;
+		std::vector<Slot> _slots;
+		std::vector<SlotValue> _default_values;
+		std::vector<size_t> value_indices;
+	};
+}
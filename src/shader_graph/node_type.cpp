@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <string>
@@ -195,11 +196,17 @@ boost::optional<csg::NodeTypeInfo> csg::NodeTypeInfo::from(const NodeType type)
 	}
 }
 
-boost::optional<csg::NodeTypeInfo> csg::NodeTypeInfo::from(const char* type_name)
+boost::optional<csg::NodeTypeInfo> csg::NodeTypeInfo::from(const char* const type_name)
+{
+	return from(boost::string_view{ type_name });
+}
+
+boost::optional<csg::NodeTypeInfo> csg::NodeTypeInfo::from(const boost::string_view type_name)
 {
 	static std::mutex local_mutex;
 	static std::atomic<bool> initialized{ false };
-	static std::map<std::string, NodeType> node_type_map;
+	// Transparent comparison so a view can be looked up without building a string from it
+	static std::map<std::string, NodeType, std::less<>> node_type_map;
 
 	if (initialized.load() == false) {
 		std::lock_guard<std::mutex> lock{ local_mutex };
@@ -213,10 +220,11 @@ boost::optional<csg::NodeTypeInfo> csg::NodeTypeInfo::from(const char* type_name
 	}
 
 	// Only use the const reference after the locking portion
-	const std::map<std::string, NodeType>& const_map{ node_type_map };
+	const std::map<std::string, NodeType, std::less<>>& const_map{ node_type_map };
 
-	if (const_map.count(type_name) == 1) {
-		const boost::optional<NodeTypeInfo> opt_type_info = NodeTypeInfo::from(const_map.at(type_name));
+	const auto iter{ const_map.find(type_name) };
+	if (iter != const_map.end()) {
+		const boost::optional<NodeTypeInfo> opt_type_info = NodeTypeInfo::from(iter->second);
 		return opt_type_info;
 	}
 	else {
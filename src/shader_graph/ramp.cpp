@@ -4,10 +4,20 @@
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <boost/algorithm/clamp.hpp>
 
 #include <shader_core/lerp.h>
+#include <shader_core/search.h>
+
+// Same result as csc::lerp on the Float4s, but each channel is done inline rather than through the Float4 operators
+static csc::Float4 lerp_color(const csc::Float4& a, const csc::Float4& b, const float t)
+{
+	return csc::Float4{ csc::lerp(a.x, b.x, t), csc::lerp(a.y, b.y, t), csc::lerp(a.z, b.z, t), csc::lerp(a.w, b.w, t) };
+}
 
 csg::ColorRamp::ColorRamp()
 {
@@ -17,7 +27,7 @@ csg::ColorRamp::ColorRamp()
 	sort_points();
 }
 
-csg::ColorRamp::ColorRamp(const std::vector<ColorRampPoint>& points) : points{ points }
+csg::ColorRamp::ColorRamp(std::vector<ColorRampPoint> new_points) : points{ std::move(new_points) }
 {
 	assert(points.size() >= 2);
 	sort_points();
@@ -25,38 +35,38 @@ csg::ColorRamp::ColorRamp(const std::vector<ColorRampPoint>& points) : points{ p
 
 csc::Float4 csg::ColorRamp::eval(const float pos) const
 {
-	// For speed, assume the vector is already sorted
 	assert(points.size() >= 2);
 
 	// If the pos is outside our control points, extend the boundary color
-	const float pos_begin{ points[0].pos };
-	if (pos <= pos_begin) {
-		return csc::Float4{ points[0].color, points[0].alpha };
+	// A NaN pos also gets the first color
+	const ColorRampPoint& point_first{ points.front() };
+	if ((pos > point_first.pos) == false) {
+		return csc::Float4{ point_first.color, point_first.alpha };
 	}
-	const float pos_end{ points[points.size() - 1].pos };
-	if (pos >= pos_end) {
-		return csc::Float4{ points[points.size() - 1].color, points[points.size() - 1].alpha };
+	const ColorRampPoint& point_last{ points.back() };
+	if (pos >= point_last.pos) {
+		return csc::Float4{ point_last.color, point_last.alpha };
 	}
 
-	// Find the bounding points
-	// We know that a pos both before and after the input position must exist
-	csg::ColorRampPoint point_before{ points[0] };
-	csg::ColorRampPoint point_after{ points[points.size() - 1] };
-	for (const csg::ColorRampPoint this_point : points) {
-		if (this_point.pos > point_before.pos && this_point.pos < pos) {
-			point_before = this_point;
-		}
-		if (this_point.pos < point_after.pos && this_point.pos > pos) {
-			point_after = this_point;
-		}
-	}
+	// Points are sorted, so the bounding points are the last one at or before pos and the one after it
+	// Both exist because pos is after the first point and before the last
+	const size_t after_index{ csc::count_before(points.data(), points.size(), [pos](const ColorRampPoint& point) { return point.pos <= pos; }) };
+	const ColorRampPoint& point_before{ points[after_index - 1] };
+	const ColorRampPoint& point_after{ points[after_index] };
 
 	const float fraction{ (pos - point_before.pos) / (point_after.pos - point_before.pos) };
 
 	const csc::Float4 result_before{ point_before.color, point_before.alpha };
 	const csc::Float4 result_after{ point_after.color, point_after.alpha };
 
-	return csc::lerp(result_before, result_after, fraction);
+	return lerp_color(result_before, result_after, fraction);
+}
+
+void csg::ColorRamp::eval_many(const float* const pos, csc::Float4* const output, const size_t count) const
+{
+	for (size_t i = 0; i < count; i++) {
+		output[i] = eval(pos[i]);
+	}
 }
 
 void csg::ColorRamp::set(const size_t index, ColorRampPoint new_point)
@@ -84,6 +94,30 @@ void csg::ColorRamp::remove(size_t index)
 	sort_points();
 }
 
+void csg::ColorRamp::set_lut_size(const size_t size)
+{
+	bake_lut(size);
+}
+
+const std::vector<csc::Float4>& csg::ColorRamp::get_lut() const
+{
+	static const std::vector<csc::Float4> empty_lut;
+	return lut ? *lut : empty_lut;
+}
+
+csc::Float4 csg::ColorRamp::eval_lut(const float pos) const
+{
+	assert(lut && lut->size() >= 2);
+	const std::vector<csc::Float4>& table{ *lut };
+
+	// Outside of 0 to 1 the entries at the ends are used, NaN gets the first like it does in eval
+	const float clamped_pos{ (pos > 0.0f) ? std::min(pos, 1.0f) : 0.0f };
+	const float scaled_pos{ clamped_pos * static_cast<float>(table.size() - 1) };
+	const size_t index{ std::min(static_cast<size_t>(scaled_pos), table.size() - 2) };
+
+	return lerp_color(table[index], table[index + 1], scaled_pos - static_cast<float>(index));
+}
+
 bool csg::ColorRamp::similar(const ColorRamp& other, const float margin) const
 {
 	if (points.size() != other.points.size()) {
@@ -124,4 +158,21 @@ void csg::ColorRamp::sort_points()
 		return false;
 	};
 	std::sort(points.begin(), points.end(), lt_pos);
+	bake_lut(lut_size());
+}
+
+void csg::ColorRamp::bake_lut(const size_t size)
+{
+	if (size < 2) {
+		lut.reset();
+		return;
+	}
+
+	std::vector<float> lut_pos(size);
+	for (size_t i = 0; i < size; i++) {
+		lut_pos[i] = static_cast<float>(i) / static_cast<float>(size - 1);
+	}
+	std::vector<csc::Float4> new_lut(size);
+	eval_many(lut_pos.data(), new_lut.data(), size);
+	lut = std::make_shared<const std::vector<csc::Float4>>(std::move(new_lut));
 }
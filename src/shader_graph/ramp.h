@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "shader_core/vector.h"
@@ -19,26 +20,41 @@ namespace csg {
 	class ColorRamp {
 	public:
 		ColorRamp();
-		ColorRamp(const std::vector<ColorRampPoint>& points);
+		ColorRamp(std::vector<ColorRampPoint> points);
 
 		csc::Float4 eval(float pos) const;
+		// Gives the same result as eval for each position
+		void eval_many(const float* pos, csc::Float4* output, size_t count) const;
 
 		size_t size() const { return points.size(); }
 
-		ColorRampPoint get(size_t index) const {
+		const ColorRampPoint& get(size_t index) const {
 			assert(index < points.size());
 			return points[index];
 		}
-		std::vector<ColorRampPoint> get() const { return points; }
+		const std::vector<ColorRampPoint>& get() const { return points; }
 
 		void set(size_t index, ColorRampPoint new_point);
 		void remove(size_t index);
 
+		// Keeps a table of eval results at this many evenly spaced positions from 0 to 1, rebuilt whenever the points change
+		// A size below 2 turns the table off
+		void set_lut_size(size_t size);
+		size_t lut_size() const { return lut ? lut->size() : 0; }
+		// Empty if the table is off
+		const std::vector<csc::Float4>& get_lut() const;
+		// Approximates eval by interpolating between table entries, the table must be on
+		csc::Float4 eval_lut(float pos) const;
+
 		bool similar(const ColorRamp& other, float margin) const;
 
 	private:
+		// Must be called after any change to points
 		void sort_points();
+		void bake_lut(size_t size);
 
 		std::vector<ColorRampPoint> points;
+		// Shared between copies, it is replaced rather than modified when points change
+		std::shared_ptr<const std::vector<csc::Float4>> lut;
 	};
 }
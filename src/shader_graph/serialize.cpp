@@ -2,18 +2,29 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <deque>
+#include <functional>
 #include <iomanip>
-#include <list>
+#include <istream>
 #include <map>
 #include <memory>
+#include <ostream>
 #include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include <boost/tokenizer.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "shader_core/config.h"
 #include "shader_core/rect.h"
@@ -25,6 +36,7 @@
 #include "node.h"
 #include "node_enums.h"
 #include "node_id.h"
+#include "node_schema.h"
 #include "node_type.h"
 #include "ramp.h"
 #include "slot.h"
@@ -41,18 +53,92 @@ static const char* const NODE_END{ "node_end" };
 
 static const char* const NODE_ID_PREFIX{ "_nodeid_" };
 
-static std::string name_from_node_id(const csg::NodeId node_id)
+// All output is appended to a single string, these write directly into it without any temporary strings or streams
+
+static void append_int(std::string& out, const int64_t value)
+{
+	// Enough for every digit of a 64 bit value and a sign
+	std::array<char, 24> buffer;
+	char* const buffer_end{ buffer.data() + buffer.size() };
+	char* begin{ buffer_end };
+	uint64_t magnitude{ (value < 0) ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value) };
+	do {
+		*--begin = static_cast<char>('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (value < 0) {
+		*--begin = '-';
+	}
+	out.append(begin, buffer_end);
+}
+
+static constexpr int64_t power_of_ten(const int exponent)
+{
+	int64_t result{ 1 };
+	for (int i = 0; i < exponent; i++) {
+		result *= 10;
+	}
+	return result;
+}
+
+// Writes the same text as a stream with std::fixed and std::setprecision(SERIALIZED_GRAPH_PRECISION)
+static void append_float(std::string& out, const float value)
+{
+	// A float has 24 bits of mantissa and 10^8 needs 19 more, so the scaled value below is always exact in a double
+	static_assert(SERIALIZED_GRAPH_PRECISION >= 0 && SERIALIZED_GRAPH_PRECISION <= 8, "Fast float formatting requires 0-8 digits of precision");
+	constexpr int64_t SCALE{ power_of_ten(SERIALIZED_GRAPH_PRECISION) };
+	constexpr double MAX_FAST_SCALED{ 9.0e18 };
+
+	const double scaled{ static_cast<double>(value) * static_cast<double>(SCALE) };
+	if (std::isfinite(scaled) == false || std::fabs(scaled) >= MAX_FAST_SCALED) {
+		// Very large values and non-finite values are rare enough to hand to a stream
+		std::stringstream stream;
+		stream << std::fixed << std::setprecision(SERIALIZED_GRAPH_PRECISION) << value;
+		out += stream.str();
+		return;
+	}
+
+	// Rounding the exact scaled value to an integer in the current rounding mode matches what printf does for "%.*f"
+	const int64_t rounded{ static_cast<int64_t>(std::nearbyint(scaled)) };
+	const uint64_t magnitude{ static_cast<uint64_t>((rounded < 0) ? -rounded : rounded) };
+	if (std::signbit(value)) {
+		// Negative values that round to zero are still written with a sign
+		out += '-';
+	}
+	append_int(out, static_cast<int64_t>(magnitude / SCALE));
+	if (SERIALIZED_GRAPH_PRECISION > 0) {
+		std::array<char, SERIALIZED_GRAPH_PRECISION + 1> fraction;
+		fraction[0] = '.';
+		uint64_t fraction_value{ magnitude % SCALE };
+		for (size_t i = fraction.size() - 1; i > 0; i--) {
+			fraction[i] = static_cast<char>('0' + fraction_value % 10);
+			fraction_value /= 10;
+		}
+		out.append(fraction.data(), fraction.size());
+	}
+}
+
+static void append_float3(std::string& out, const csc::Float3 value)
+{
+	append_float(out, value.x);
+	out += ',';
+	append_float(out, value.y);
+	out += ',';
+	append_float(out, value.z);
+}
+
+static void append_node_name(std::string& out, const csg::NodeId node_id)
 {
 	const size_t size_src{ sizeof(csg::NodeId) };
 	const size_t size_dest{ ext::base64::encoded_size(size_src) };
 	std::array<char, 24> result_array;
 	assert(size_dest < result_array.size());
-	result_array.fill('\0');
-	ext::base64::encode(result_array.data(), &node_id, size_src);
-	return std::string{ NODE_ID_PREFIX } + result_array.data();
+	const size_t written{ ext::base64::encode(result_array.data(), &node_id, size_src) };
+	out += NODE_ID_PREFIX;
+	out.append(result_array.data(), written);
 }
 
-static std::string serialize_curve(const csg::Curve& curve)
+static void append_curve(std::string& out, const csg::Curve& curve)
 {
 	constexpr char SEPARATOR{ ',' };
 
@@ -68,119 +154,114 @@ static std::string serialize_curve(const csg::Curve& curve)
 		}
 	};
 
-	std::stringstream sstream;
-	sstream << std::fixed << std::setprecision(SERIALIZED_GRAPH_PRECISION);
-
 	bool write_opening_separator{ false };
 	for (const csg::CurvePoint point : curve.control_points()) {
 		if (write_opening_separator) {
-			sstream << SEPARATOR;
+			out += SEPARATOR;
 		}
-		sstream << point.pos.x << SEPARATOR << point.pos.y << SEPARATOR << interp_as_char(point.interp);
+		append_float(out, point.pos.x);
+		out += SEPARATOR;
+		append_float(out, point.pos.y);
+		out += SEPARATOR;
+		out += interp_as_char(point.interp);
 		write_opening_separator = true;
 	}
-	return sstream.str();
 }
 
-static std::string serialize_slot_value(const csg::SlotValue& slot_value)
+static void append_slot_value(std::string& out, const csg::SlotValue& slot_value)
 {
 	switch (slot_value.type()) {
 	case csg::SlotType::BOOL:
-		if (slot_value.as<csg::BoolSlotValue>().has_value()) {
-			const csg::BoolSlotValue bool_slot_value{ slot_value.as<csg::BoolSlotValue>().value() };
-			if (bool_slot_value.get()) {
-				return "1";
-			}
-			else {
-				return "0";
-			}
+		if (const csg::BoolSlotValue* const bool_slot_ptr{ slot_value.as_ptr<csg::BoolSlotValue>() }) {
+			out += bool_slot_ptr->get() ? '1' : '0';
+			return;
 		}
 		break;
 	case csg::SlotType::COLOR:
-		if (slot_value.as<csg::ColorSlotValue>().has_value()) {
-			const csg::ColorSlotValue color_slot_value{ slot_value.as<csg::ColorSlotValue>().value() };
-			const csc::Float3 color{ color_slot_value.get() };
-			std::stringstream sstream;
-			sstream << std::fixed << std::setprecision(SERIALIZED_GRAPH_PRECISION) << color.x << ',' << color.y << ',' << color.z;
-			return sstream.str();
+		if (const csg::ColorSlotValue* const color_slot_ptr{ slot_value.as_ptr<csg::ColorSlotValue>() }) {
+			append_float3(out, color_slot_ptr->get());
+			return;
 		}
 		break;
 	case csg::SlotType::ENUM:
-		if (slot_value.as<csg::EnumSlotValue>().has_value()) {
-			const csg::EnumSlotValue enum_slot_value{ slot_value.as<csg::EnumSlotValue>().value() };
-			return std::string{ enum_slot_value.internal_name() };
+		if (const csg::EnumSlotValue* const enum_slot_ptr{ slot_value.as_ptr<csg::EnumSlotValue>() }) {
+			out += enum_slot_ptr->internal_name();
+			return;
 		}
 		break;
 	case csg::SlotType::FLOAT:
-		if (slot_value.as<csg::FloatSlotValue>().has_value()) {
-			const csg::FloatSlotValue float_slot_value{ slot_value.as<csg::FloatSlotValue>().value() };
-			std::stringstream sstream;
-			sstream << std::fixed << std::setprecision(SERIALIZED_GRAPH_PRECISION) << float_slot_value.get();
-			return sstream.str();
+		if (const csg::FloatSlotValue* const float_slot_ptr{ slot_value.as_ptr<csg::FloatSlotValue>() }) {
+			append_float(out, float_slot_ptr->get());
+			return;
 		}
 		break;
 	case csg::SlotType::INT:
-		if (slot_value.as<csg::IntSlotValue>().has_value()) {
-			const csg::IntSlotValue int_slot_value{ slot_value.as<csg::IntSlotValue>().value() };
-			std::stringstream sstream;
-			sstream << int_slot_value.get();
-			return sstream.str();
+		if (const csg::IntSlotValue* const int_slot_ptr{ slot_value.as_ptr<csg::IntSlotValue>() }) {
+			append_int(out, int_slot_ptr->get());
+			return;
 		}
 		break;
 	case csg::SlotType::VECTOR:
-		if (slot_value.as<csg::VectorSlotValue>().has_value()) {
-			const csg::VectorSlotValue vec_slot_value{ slot_value.as<csg::VectorSlotValue>().value() };
-			const csc::Float3 color{ vec_slot_value.get() };
-			std::stringstream sstream;
-			sstream << std::fixed << std::setprecision(SERIALIZED_GRAPH_PRECISION) << color.x << ',' << color.y << ',' << color.z;
-			return sstream.str();
+		if (const csg::VectorSlotValue* const vec_slot_ptr{ slot_value.as_ptr<csg::VectorSlotValue>() }) {
+			append_float3(out, vec_slot_ptr->get());
+			return;
 		}
 		break;
 	case csg::SlotType::CURVE_RGB:
-		if (slot_value.as<csg::RGBCurveSlotValue>().has_value()) {
+		if (const csg::RGBCurveSlotValue* const rgb_slot_ptr{ slot_value.as_ptr<csg::RGBCurveSlotValue>() }) {
 			constexpr char CURVE_SEPARATOR{ '/' };
-			const csg::RGBCurveSlotValue rgb_slot_value{ slot_value.as<csg::RGBCurveSlotValue>().value() };
-			std::stringstream sstream;
-			sstream << std::fixed << std::setprecision(SERIALIZED_GRAPH_PRECISION);
-			sstream << "curve_rgb_00" << CURVE_SEPARATOR << "00" << CURVE_SEPARATOR;
-			sstream << serialize_curve(rgb_slot_value.get_all()) << CURVE_SEPARATOR;
-			sstream << serialize_curve(rgb_slot_value.get_r()) << CURVE_SEPARATOR;
-			sstream << serialize_curve(rgb_slot_value.get_g()) << CURVE_SEPARATOR;
-			sstream << serialize_curve(rgb_slot_value.get_b());
-			return sstream.str();
+			const csg::RGBCurveSlotValue& rgb_slot_value{ *rgb_slot_ptr };
+			out += "curve_rgb_00";
+			out += CURVE_SEPARATOR;
+			out += "00";
+			out += CURVE_SEPARATOR;
+			append_curve(out, rgb_slot_value.get_all());
+			out += CURVE_SEPARATOR;
+			append_curve(out, rgb_slot_value.get_r());
+			out += CURVE_SEPARATOR;
+			append_curve(out, rgb_slot_value.get_g());
+			out += CURVE_SEPARATOR;
+			append_curve(out, rgb_slot_value.get_b());
+			return;
 		}
 		break;
 	case csg::SlotType::CURVE_VECTOR:
-		if (slot_value.as<csg::VectorCurveSlotValue>().has_value()) {
+		if (const csg::VectorCurveSlotValue* const curve_slot_ptr{ slot_value.as_ptr<csg::VectorCurveSlotValue>() }) {
 			constexpr char CURVE_SEPARATOR{ '/' };
-			const csg::VectorCurveSlotValue curve_slot_value{ slot_value.as<csg::VectorCurveSlotValue>().value() };
-			std::stringstream sstream;
-			sstream << std::fixed << std::setprecision(SERIALIZED_GRAPH_PRECISION);
-			sstream << "curve_vec_00" << CURVE_SEPARATOR << "00" << CURVE_SEPARATOR;
-			sstream << curve_slot_value.get_min().x << "," << curve_slot_value.get_min().y << CURVE_SEPARATOR;
-			sstream << curve_slot_value.get_max().x << "," << curve_slot_value.get_max().y << CURVE_SEPARATOR;
-			sstream << serialize_curve(curve_slot_value.get_x()) << CURVE_SEPARATOR;
-			sstream << serialize_curve(curve_slot_value.get_y()) << CURVE_SEPARATOR;
-			sstream << serialize_curve(curve_slot_value.get_z());
-			return sstream.str();
+			const csg::VectorCurveSlotValue& curve_slot_value{ *curve_slot_ptr };
+			out += "curve_vec_00";
+			out += CURVE_SEPARATOR;
+			out += "00";
+			out += CURVE_SEPARATOR;
+			append_float(out, curve_slot_value.get_min().x);
+			out += ',';
+			append_float(out, curve_slot_value.get_min().y);
+			out += CURVE_SEPARATOR;
+			append_float(out, curve_slot_value.get_max().x);
+			out += ',';
+			append_float(out, curve_slot_value.get_max().y);
+			out += CURVE_SEPARATOR;
+			append_curve(out, curve_slot_value.get_x());
+			out += CURVE_SEPARATOR;
+			append_curve(out, curve_slot_value.get_y());
+			out += CURVE_SEPARATOR;
+			append_curve(out, curve_slot_value.get_z());
+			return;
 		}
 		break;
 	case csg::SlotType::COLOR_RAMP:
-		if (slot_value.as<csg::ColorRampSlotValue>().has_value()) {
+		if (const csg::ColorRampSlotValue* const ramp_slot_ptr{ slot_value.as_ptr<csg::ColorRampSlotValue>() }) {
 			constexpr char RAMP_SEPARATOR{ ',' };
-			const csg::ColorRampSlotValue ramp_slot_value{ slot_value.as<csg::ColorRampSlotValue>().value() };
-			std::stringstream sstream;
-			sstream << std::fixed << std::setprecision(SERIALIZED_GRAPH_PRECISION);
-			sstream << "ramp00";
-			for (const auto& this_point : ramp_slot_value.get().get()) {
-				const float a = this_point.pos;
-				const float b = this_point.color.x;
-				const float c = this_point.color.y;
-				const float d = this_point.color.z;
-				const float e = this_point.alpha;
-				sstream << RAMP_SEPARATOR << a << RAMP_SEPARATOR << b << RAMP_SEPARATOR << c << RAMP_SEPARATOR << d << RAMP_SEPARATOR << e;
+			const csg::ColorRamp& ramp{ ramp_slot_ptr->get() };
+			out += "ramp00";
+			for (size_t i = 0; i < ramp.size(); i++) {
+				const csg::ColorRampPoint this_point{ ramp.get(i) };
+				for (const float this_float : { this_point.pos, this_point.color.x, this_point.color.y, this_point.color.z, this_point.alpha }) {
+					out += RAMP_SEPARATOR;
+					append_float(out, this_float);
+				}
 			}
-			return sstream.str();
+			return;
 		}
 		break;
 	default:
@@ -188,166 +269,603 @@ static std::string serialize_slot_value(const csg::SlotValue& slot_value)
 		break;
 	}
 
-	return "ERROR";
+	out += "ERROR";
 }
 
-std::string csg::serialize_graph(const Graph& graph)
+// Appends everything from the type name to the node end marker, the text depends on nothing outside the node
+static void append_node(std::string& out, const csg::Node& node)
 {
-	// Make a local sorted copy of all nodes and connections
-	const auto& graph_connections = graph.connections();
-	std::vector<Connection> connections{ graph_connections.begin(), graph_connections.end() };
-	std::sort(connections.begin(), connections.end());
+	using namespace csg;
+
+	const boost::optional<NodeTypeInfo> info{ NodeTypeInfo::from(node.type()) };
+	if (info.has_value() == false) {
+		return;
+	}
+	out += info->name();
+	out += '|';
+	append_node_name(out, node.id());
+	out += '|';
+	append_int(out, node.position.x);
+	out += '|';
+	append_int(out, node.position.y);
+	out += '|';
+	const std::vector<Slot>& slots{ node.schema().slots() };
+	for (size_t i = 0; i < slots.size(); i++) {
+		const SlotValue* const slot_value{ node.slot_value_ptr(i) };
+		if (slots[i].dir() == SlotDirection::INPUT && slot_value) {
+			out += slots[i].name();
+			out += '|';
+			append_slot_value(out, *slot_value);
+			out += '|';
+		}
+	}
+	out += NODE_END;
+	out += '|';
+}
+
+// Takes the schemas of the two nodes rather than the nodes, either may be nullptr if the node does not exist
+// Connections to missing nodes or slots are not written
+static void append_connection(std::string& out, const csg::Connection& connection, const csg::NodeSchema* const schema_src, const csg::NodeSchema* const schema_dest)
+{
+	using namespace csg;
+
+	if (schema_src == nullptr || schema_dest == nullptr) {
+		// Either source or dest node does not exist, ignore this connection
+		return;
+	}
+
+	// Now we need to get the slots to find the slot names
+	const size_t index_src{ connection.source().index() };
+	const size_t index_dest{ connection.dest().index() };
+	if (index_src >= schema_src->slots().size() || index_dest >= schema_dest->slots().size()) {
+		// One of the slots is not real, ignore this connection
+		return;
+	}
+
+	append_node_name(out, connection.source().node_id());
+	out += '|';
+	out += schema_src->slots()[index_src].disp_name();
+	out += '|';
+	append_node_name(out, connection.dest().node_id());
+	out += '|';
+	out += schema_dest->slots()[index_dest].disp_name();
+	out += '|';
+}
 
-	std::vector<Node> nodes;
+// Same order as Connection::operator<, but visible to the compiler so sorting many connections is not a chain of calls
+static bool connection_less(const csg::Connection& a, const csg::Connection& b)
+{
+	const csg::SlotId a_src{ a.source() };
+	const csg::SlotId b_src{ b.source() };
+	const csg::SlotId a_dest{ a.dest() };
+	const csg::SlotId b_dest{ b.dest() };
+	return std::make_tuple(a_src.node_id(), a_src.index(), a_dest.node_id(), a_dest.index()) <
+		std::make_tuple(b_src.node_id(), b_src.index(), b_dest.node_id(), b_dest.index());
+}
+
+// Size at which streamed output is handed to the stream, small enough to keep memory bounded and large enough to keep writes few
+static constexpr size_t STREAM_CHUNK_SIZE{ 64 * 1024 };
+
+static void flush_chunk(std::string& result, std::ostream* const stream, const size_t min_size)
+{
+	if (stream && result.size() >= min_size) {
+		stream->write(result.data(), static_cast<std::streamsize>(result.size()));
+		result.clear();
+	}
+}
+
+// Writes the whole graph to result, or when a stream is given writes it in chunks and leaves result empty
+static void write_graph(const csg::Graph& graph, std::string& result, std::ostream* const stream)
+{
+	using namespace csg;
+
+	// Sort pointers to the nodes rather than copies, the graph keeps every node alive until this function returns
+	std::vector<const Node*> nodes;
+	nodes.reserve(graph.nodes().size());
 	for (const auto& node : graph.nodes()) {
-		nodes.push_back(*node);
+		nodes.push_back(node.get());
 	}
 	std::sort(nodes.begin(), nodes.end(),
-		[](const Node& a, const Node& b) {
-			return a.id() < b.id();
+		[](const Node* const a, const Node* const b) {
+			return a->id() < b->id();
 		}
 	);
 
-	std::stringstream result_stream;
+	const auto& graph_connections = graph.connections();
+	std::vector<Connection> connections{ graph_connections.begin(), graph_connections.end() };
+	std::sort(connections.begin(), connections.end(), connection_less);
+
+	result.clear();
+	if (stream) {
+		result.reserve(STREAM_CHUNK_SIZE * 2);
+	}
+	else {
+		// Rough size of a typical node and connection, reserving this up front avoids most reallocation as the output grows
+		constexpr size_t RESERVE_PER_NODE{ 96 };
+		constexpr size_t RESERVE_PER_VALUE{ 16 };
+		constexpr size_t RESERVE_PER_CONNECTION{ 64 };
+		size_t reserve_size{ 64 + connections.size() * RESERVE_PER_CONNECTION };
+		for (const Node* const node : nodes) {
+			reserve_size += RESERVE_PER_NODE + node->schema().default_values().size() * RESERVE_PER_VALUE;
+		}
+		result.reserve(reserve_size);
+	}
 
 	// Header
-	result_stream << MAGIC_WORD << "|" << VERSION_OUTPUT << "|";
+	result += MAGIC_WORD;
+	result += '|';
+	result += VERSION_OUTPUT;
+	result += '|';
 
 	// Node section
-	result_stream << SECTION_NODES << "|";
-	std::map<NodeId, std::string> names_by_id;
-	for (const Node& node : nodes) {
-		const std::string node_name{ name_from_node_id(node.id()) };
-		names_by_id[node.id()] = node_name;
-		const boost::optional<NodeTypeInfo> info{ NodeTypeInfo::from(node.type()) };
-		if (info.has_value()) {
-			result_stream << info->name() << "|" << node_name << "|";
-			result_stream << node.position.x << "|" << node.position.y << "|";
-			for (const Slot& slot : node.slots()) {
-				if (slot.dir() == SlotDirection::INPUT && slot.value.has_value()) {
-					result_stream << slot.name() << "|" << serialize_slot_value(slot.value.value()) << "|";
-				}
-			}
-			result_stream << "node_end|";
-		}
-		else {
-			continue;
-		}
+	result += SECTION_NODES;
+	result += '|';
+	for (const Node* const node : nodes) {
+		append_node(result, *node);
+		flush_chunk(result, stream, STREAM_CHUNK_SIZE);
 	}
 
 	// Connection section
-	result_stream << SECTION_CONNECTIONS << "|";
+	result += SECTION_CONNECTIONS;
+	result += '|';
+
+	// The sorted node list doubles as a lookup table for connection endpoints
+	const auto find_sorted_schema = [&nodes](const NodeId id) -> const NodeSchema* {
+		const auto iter{ std::lower_bound(nodes.begin(), nodes.end(), id,
+			[](const Node* const node, const NodeId id) {
+				return node->id() < id;
+			}
+		) };
+		return (iter != nodes.end() && (*iter)->id() == id) ? &(*iter)->schema() : nullptr;
+	};
 
 	for (const Connection& connection : connections) {
-		const csg::NodeId id_src{ connection.source().node_id() };
-		const csg::NodeId id_dest{ connection.dest().node_id() };
-		if (names_by_id.count(id_src) == 0 || names_by_id.count(id_dest) == 0) {
-			// Either source or dest node does not exist, ignore this connection
-			continue;
-		}
-		const std::string name_src{ names_by_id[id_src] };
-		const std::string name_dest{ names_by_id[id_dest] };
-		const auto opt_node_src{ graph.get(id_src) };
-		const auto opt_node_dest{ graph.get(id_dest) };
+		append_connection(result, connection, find_sorted_schema(connection.source().node_id()), find_sorted_schema(connection.dest().node_id()));
+		flush_chunk(result, stream, STREAM_CHUNK_SIZE);
+	}
+
+	flush_chunk(result, stream, 0);
+}
 
-		// We already checked that these nodes exist, so the optionals here should always hold a value
-		assert(opt_node_src.use_count() > 0);
-		assert(opt_node_dest.use_count() > 0);
+std::string csg::serialize_graph(const Graph& graph)
+{
+	std::string result;
+	write_graph(graph, result, nullptr);
+	return result;
+}
 
-		// Now we need to get the slots to find the slot names
-		const auto opt_slot_src{ opt_node_src->slot(connection.source().index()) };
-		const auto opt_slot_dest{ opt_node_dest->slot(connection.dest().index()) };
-		if (opt_slot_src.has_value() == false || opt_slot_dest.has_value() == false) {
-			// One of the slots is not real, ignore this connection
-			continue;
+bool csg::serialize_graph(const Graph& graph, std::ostream& output)
+{
+	std::string buffer;
+	write_graph(graph, buffer, &output);
+	return output.good();
+}
+
+std::string csg::SerializeCache::serialize(const Graph& graph)
+{
+	// Sorting ids next to pointers keeps the sort from touching every node
+	std::vector<std::pair<NodeId, const std::shared_ptr<const Node>*>> nodes;
+	nodes.reserve(graph.nodes().size());
+	for (const auto& node : graph.nodes()) {
+		nodes.push_back(std::make_pair(node->id(), &node));
+	}
+	std::sort(nodes.begin(), nodes.end(),
+		[](const std::pair<NodeId, const std::shared_ptr<const Node>*>& a, const std::pair<NodeId, const std::shared_ptr<const Node>*>& b) {
+			return a.first < b.first;
 		}
+	);
 
-		result_stream << name_src << "|" << opt_slot_src->disp_name() << "|";
-		result_stream << name_dest << "|" << opt_slot_dest->disp_name() << "|";
+	// Merge with the fragments from the last call, both lists are sorted by id
+	// A fragment holds a reference to its node, so the graph copies the node before any edit and a changed node
+	// never has the same address as the cached one
+	std::vector<NodeFragment> next_fragments;
+	next_fragments.reserve(nodes.size());
+	std::vector<NodeId> node_ids;
+	node_ids.reserve(nodes.size());
+	size_t old_index{ 0 };
+	size_t text_size{ 0 };
+	for (const auto& id_node : nodes) {
+		while (old_index < fragments.size() && fragments[old_index].id < id_node.first) {
+			old_index++;
+		}
+		if (old_index < fragments.size() && fragments[old_index].id == id_node.first && fragments[old_index].node == *id_node.second) {
+			next_fragments.push_back(std::move(fragments[old_index]));
+		}
+		else {
+			NodeFragment fragment;
+			fragment.id = id_node.first;
+			fragment.node = *id_node.second;
+			fragment.schema = &fragment.node->schema();
+			append_node(fragment.text, *fragment.node);
+			next_fragments.push_back(std::move(fragment));
+		}
+		node_ids.push_back(id_node.first);
+		text_size += next_fragments.back().text.size();
+	}
+	fragments = std::move(next_fragments);
+
+	const auto& graph_connections = graph.connections();
+	std::vector<Connection> connections{ graph_connections.begin(), graph_connections.end() };
+	std::sort(connections.begin(), connections.end(), connection_less);
+
+	constexpr size_t RESERVE_PER_CONNECTION{ 64 };
+	std::string result;
+	result.reserve(64 + text_size + connections.size() * RESERVE_PER_CONNECTION);
+	result += MAGIC_WORD;
+	result += '|';
+	result += VERSION_OUTPUT;
+	result += '|';
+	result += SECTION_NODES;
+	result += '|';
+	for (const NodeFragment& fragment : fragments) {
+		result += fragment.text;
 	}
 
-	return result_stream.str();
+	// Connections are cheap to format compared to nodes, they are written fresh each time
+	result += SECTION_CONNECTIONS;
+	result += '|';
+	// Schemas are kept in the fragments so this does not have to visit every node again
+	const auto find_schema = [this, &node_ids](const NodeId id) -> const NodeSchema* {
+		const auto iter{ std::lower_bound(node_ids.begin(), node_ids.end(), id) };
+		return (iter != node_ids.end() && *iter == id) ? fragments[iter - node_ids.begin()].schema : nullptr;
+	};
+	for (const Connection& connection : connections) {
+		append_connection(result, connection, find_schema(connection.source().node_id()), find_schema(connection.dest().node_id()));
+	}
+
+	return result;
 }
 
-// Check whether iter is able to successfully increment count times without becoming equal to end
-template<typename T>
-static bool iter_has_contents(T iter, const T end, size_t count)
+void csg::SerializeCache::clear()
 {
-	while (count > 0) {
-		if (iter == end) {
+	fragments.clear();
+}
+
+// Walks through the tokens of a string separated by a single character without copying them
+// Empty tokens are skipped, matching the behavior of boost::char_separator
+class TokenReader {
+public:
+	TokenReader(const boost::string_view input, const char separator) :
+		remaining{ input }, input_end{ input.data() + input.size() }, separator{ separator }
+	{
+		advance();
+	}
+
+	bool at_end() const { return current.empty(); }
+
+	// Where the next token begins, or the end of the input once every token has been read
+	const char* position() const { return at_end() ? input_end : current.data(); }
+
+	// Check whether count more tokens can be read before reaching the end
+	bool has_tokens(size_t count) const
+	{
+		if (count == 0) {
+			return true;
+		}
+		if (at_end()) {
 			return false;
 		}
 		count--;
-		iter++;
+		size_t pos{ 0 };
+		while (count > 0) {
+			pos = remaining.find_first_not_of(separator, pos);
+			if (pos == boost::string_view::npos) {
+				return false;
+			}
+			pos = remaining.find(separator, pos);
+			count--;
+		}
+		return true;
 	}
-	return true;
+
+	// The token that will be returned by the next call to next(), empty at the end of input
+	boost::string_view peek() const { return current; }
+
+	boost::string_view next()
+	{
+		const boost::string_view result{ current };
+		advance();
+		return result;
+	}
+
+	// Tokens already point into the input, which outlives the reader
+	boost::string_view keep(const boost::string_view token) { return token; }
+
+private:
+	void advance()
+	{
+		const size_t begin{ remaining.find_first_not_of(separator) };
+		if (begin == boost::string_view::npos) {
+			current = boost::string_view{};
+			remaining = boost::string_view{};
+			return;
+		}
+		remaining.remove_prefix(begin);
+		const size_t end{ std::min(remaining.find(separator), remaining.size()) };
+		current = remaining.substr(0, end);
+		remaining.remove_prefix(end);
+	}
+
+	boost::string_view current;
+	boost::string_view remaining;
+	const char* input_end;
+	char separator;
+};
+
+// Reads tokens from a stream through a buffer that only holds the unread tail of the input plus one chunk
+// A view returned by next() stays valid until the next call to at_end(), has_tokens() or peek(), only those refill the buffer
+class StreamTokenReader {
+public:
+	StreamTokenReader(std::istream& input, const char separator) : input{ input }, separator{ separator } {}
+
+	bool at_end() { return has_tokens(1) == false; }
+
+	// Check whether count more tokens can be read before reaching the end, reading more input if needed
+	bool has_tokens(const size_t count)
+	{
+		while (true) {
+			const boost::string_view unread{ boost::string_view{ buffer }.substr(pos) };
+			size_t found{ 0 };
+			size_t scan{ 0 };
+			while (found < count) {
+				const size_t begin{ unread.find_first_not_of(separator, scan) };
+				if (begin == boost::string_view::npos) {
+					break;
+				}
+				// A token is only complete once its separator has been read, or at the end of input
+				const size_t end{ unread.find(separator, begin) };
+				if (end == boost::string_view::npos && input_done == false) {
+					break;
+				}
+				found++;
+				scan = std::min(end, unread.size());
+			}
+			if (found == count) {
+				return true;
+			}
+			if (input_done) {
+				return false;
+			}
+			refill();
+		}
+	}
+
+	boost::string_view peek()
+	{
+		if (has_tokens(1) == false) {
+			return boost::string_view{};
+		}
+		return next_token(false);
+	}
+
+	boost::string_view next() { return next_token(true); }
+
+	// Copy a token somewhere it will outlive the buffer
+	boost::string_view keep(const boost::string_view token)
+	{
+		kept.emplace_back(token.data(), token.size());
+		return kept.back();
+	}
+
+private:
+	boost::string_view next_token(const bool consume)
+	{
+		const boost::string_view unread{ boost::string_view{ buffer }.substr(pos) };
+		const size_t begin{ std::min(unread.find_first_not_of(separator), unread.size()) };
+		const size_t end{ std::min(unread.find(separator, begin), unread.size()) };
+		if (consume) {
+			pos += end;
+		}
+		return unread.substr(begin, end - begin);
+	}
+
+	// Drop everything already consumed and append the next chunk of input
+	void refill()
+	{
+		buffer.erase(0, pos);
+		pos = 0;
+		const size_t old_size{ buffer.size() };
+		buffer.resize(old_size + STREAM_CHUNK_SIZE);
+		input.read(&buffer[old_size], static_cast<std::streamsize>(STREAM_CHUNK_SIZE));
+		const size_t read_size{ static_cast<size_t>(input.gcount()) };
+		buffer.resize(old_size + read_size);
+		if (read_size < STREAM_CHUNK_SIZE) {
+			input_done = true;
+		}
+	}
+
+	std::istream& input;
+	char separator;
+	std::string buffer;
+	size_t pos{ 0 };
+	bool input_done{ false };
+	// Deque so that growing it never moves earlier strings
+	std::deque<std::string> kept;
+};
+
+struct StringViewHash {
+	size_t operator()(const boost::string_view view) const { return boost::hash_range(view.begin(), view.end()); }
+};
+
+// Normal stoi/stof will use system locale which may be a problem, these always use the default locale
+// The fast paths below produce exactly what reading from a std::stringstream would, anything they
+// cannot handle exactly is passed to the stream instead
+
+static bool is_stream_space(const char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
 }
 
-// Normal stoi/stof will use system locale which may be a problem, this way uses default locale
+static bool is_digit(const char c)
+{
+	return c >= '0' && c <= '9';
+}
 
-static int my_stoi(const std::string& input)
+static int my_stoi_stream(const boost::string_view input)
 {
-	std::stringstream stream{ input };
+	std::stringstream stream{ std::string{ input.begin(), input.end() } };
 	int result{ 0 };
 	stream >> result;
 	return result;
 }
 
-static float my_stof(const std::string& input)
+static float my_stof_stream(const boost::string_view input)
 {
-	std::stringstream stream{ input };
+	std::stringstream stream{ std::string{ input.begin(), input.end() } };
 	float result{ 0.0f };
 	stream >> result;
 	return result;
 }
 
-static csc::Float2 my_stof2(const std::string& input)
+static int my_stoi(const boost::string_view input)
+{
+	const char* iter{ input.begin() };
+	const char* const end{ input.end() };
+	while (iter != end && is_stream_space(*iter)) {
+		iter++;
+	}
+	bool negative{ false };
+	if (iter != end && (*iter == '-' || *iter == '+')) {
+		negative = (*iter == '-');
+		iter++;
+	}
+
+	// Up to 9 digits can never overflow an int
+	constexpr size_t MAX_FAST_DIGITS{ 9 };
+	const char* const digits_begin{ iter };
+	int64_t value{ 0 };
+	while (iter != end && is_digit(*iter) && static_cast<size_t>(iter - digits_begin) < MAX_FAST_DIGITS) {
+		value = value * 10 + (*iter - '0');
+		iter++;
+	}
+	if (iter == digits_begin) {
+		// A stream that fails to read anything leaves 0
+		return 0;
+	}
+	if (iter != end && is_digit(*iter)) {
+		// Long enough that it may overflow, let the stream decide how to clamp it
+		return my_stoi_stream(input);
+	}
+	return static_cast<int>(negative ? -value : value);
+}
+
+static float my_stof(const boost::string_view input)
 {
-	const boost::char_separator<char> sep{ "," };
-	const boost::tokenizer<boost::char_separator<char>> tokenizer{ input, sep };
+	const char* iter{ input.begin() };
+	const char* const end{ input.end() };
+	while (iter != end && is_stream_space(*iter)) {
+		iter++;
+	}
+	bool negative{ false };
+	if (iter != end && (*iter == '-' || *iter == '+')) {
+		negative = (*iter == '-');
+		iter++;
+	}
 
-	auto token_iter = tokenizer.begin();
-	if (iter_has_contents(token_iter, tokenizer.end(), 2) == false) {
+	// Collect all digits into one integer mantissa with a power of ten exponent
+	// Leading zeros do not count toward the digit limit
+	constexpr int MAX_DIGITS{ 19 };
+	uint64_t mantissa{ 0 };
+	int mantissa_digits{ 0 };
+	int exponent{ 0 };
+	bool found_digit{ false };
+	while (iter != end && is_digit(*iter)) {
+		found_digit = true;
+		if (mantissa_digits < MAX_DIGITS) {
+			mantissa = mantissa * 10 + static_cast<uint64_t>(*iter - '0');
+			mantissa_digits += (mantissa != 0) ? 1 : 0;
+		}
+		else {
+			return my_stof_stream(input);
+		}
+		iter++;
+	}
+	if (iter != end && *iter == '.') {
+		iter++;
+		while (iter != end && is_digit(*iter)) {
+			found_digit = true;
+			if (mantissa_digits < MAX_DIGITS) {
+				mantissa = mantissa * 10 + static_cast<uint64_t>(*iter - '0');
+				mantissa_digits += (mantissa != 0) ? 1 : 0;
+				exponent--;
+			}
+			else {
+				return my_stof_stream(input);
+			}
+			iter++;
+		}
+	}
+	if (found_digit == false) {
+		// A stream that fails to read anything leaves 0
+		return 0.0f;
+	}
+	if (iter != end && (*iter == 'e' || *iter == 'E')) {
+		return my_stof_stream(input);
+	}
+
+	if (mantissa == 0) {
+		return negative ? -0.0f : 0.0f;
+	}
+	while (mantissa % 10 == 0) {
+		mantissa /= 10;
+		exponent++;
+	}
+
+	// When both the mantissa and power of ten are exactly representable as floats, a single
+	// multiply or divide is correctly rounded and so gives the same result as strtof
+	static const float POWERS_OF_TEN[]{ 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+	constexpr uint64_t MAX_EXACT_MANTISSA{ 1 << 24 };
+	constexpr int MAX_EXACT_EXPONENT{ 10 };
+	if (mantissa > MAX_EXACT_MANTISSA || exponent > MAX_EXACT_EXPONENT || exponent < -MAX_EXACT_EXPONENT) {
+		return my_stof_stream(input);
+	}
+	const float value{ (exponent < 0) ?
+		static_cast<float>(mantissa) / POWERS_OF_TEN[-exponent] :
+		static_cast<float>(mantissa) * POWERS_OF_TEN[exponent]
+	};
+	return negative ? -value : value;
+}
+
+static csc::Float2 my_stof2(const boost::string_view input)
+{
+	TokenReader reader{ input, ',' };
+	if (reader.has_tokens(2) == false) {
 		// Did not find the two expected comma-separated floats
 		return csc::Float2{};
 	}
 
 	csc::Float2 result;
-	result.x = my_stof(*token_iter++);
-	result.y = my_stof(*token_iter++);
+	result.x = my_stof(reader.next());
+	result.y = my_stof(reader.next());
 	return result;
 }
 
-static csc::Float3 my_stof3(const std::string& input)
+static csc::Float3 my_stof3(const boost::string_view input)
 {
-	const boost::char_separator<char> sep{ "," };
-	const boost::tokenizer<boost::char_separator<char>> tokenizer{ input, sep };
-
-	auto token_iter = tokenizer.begin();
-	if (iter_has_contents(token_iter, tokenizer.end(), 3) == false) {
+	TokenReader reader{ input, ',' };
+	if (reader.has_tokens(3) == false) {
 		// Did not find the three expected comma-separated floats
 		return csc::Float3{};
 	}
 
 	csc::Float3 result;
-	result.x = my_stof(*token_iter++);
-	result.y = my_stof(*token_iter++);
-	result.z = my_stof(*token_iter++);
+	result.x = my_stof(reader.next());
+	result.y = my_stof(reader.next());
+	result.z = my_stof(reader.next());
 	return result;
 }
 
-static boost::optional<csg::NodeId> node_id_from_name(const std::string& node_name)
+static boost::optional<csg::NodeId> node_id_from_name(const boost::string_view node_name)
 {
-	if (node_name.find(NODE_ID_PREFIX) != 0) {
+	if (node_name.starts_with(NODE_ID_PREFIX) == false) {
 		// This name does not have the right prefix
 		return boost::none;
 	}
 
-	const size_t prefix_size = strlen(NODE_ID_PREFIX);
-	const std::string id_encoded{ node_name.substr(prefix_size, node_name.size() - prefix_size) };
+	const boost::string_view id_encoded{ node_name.substr(strlen(NODE_ID_PREFIX)) };
 	std::array<char, 32> buffer;
 	buffer.fill('\0');
-	const std::pair<size_t, size_t> decode_result = ext::base64::decode(buffer.data(), id_encoded.c_str(), std::min(static_cast<size_t>(16), id_encoded.size()));
+	const std::pair<size_t, size_t> decode_result = ext::base64::decode(buffer.data(), id_encoded.data(), std::min(static_cast<size_t>(16), id_encoded.size()));
 	if (decode_result.first < sizeof(csg::NodeId)) {
 		// ID was not long enough
 		return boost::none;
@@ -358,9 +876,9 @@ static boost::optional<csg::NodeId> node_id_from_name(const std::string& node_na
 	return result;
 }
 
-static boost::optional<csg::NodeType> get_type_from_name(const std::string& type_name)
+static boost::optional<csg::NodeType> get_type_from_name(const boost::string_view type_name)
 {
-	const boost::optional<csg::NodeTypeInfo> opt_type_info{ csg::NodeTypeInfo::from(type_name.c_str()) };
+	const boost::optional<csg::NodeTypeInfo> opt_type_info{ csg::NodeTypeInfo::from(type_name) };
 	if (opt_type_info.has_value()) {
 		return opt_type_info->type();
 	}
@@ -369,7 +887,7 @@ static boost::optional<csg::NodeType> get_type_from_name(const std::string& type
 	}
 }
 
-static csg::CurveInterp get_interp(const std::string symbol)
+static csg::CurveInterp get_interp(const boost::string_view symbol)
 {
 	if (symbol == "l") {
 		return csg::CurveInterp::LINEAR;
@@ -379,18 +897,15 @@ static csg::CurveInterp get_interp(const std::string symbol)
 	}
 }
 
-static boost::optional<csg::Curve> deserialize_curve(const std::string& curve, const csc::Float2 min, const csc::Float2 max)
+static boost::optional<csg::Curve> deserialize_curve(const boost::string_view curve, const csc::Float2 min, const csc::Float2 max)
 {
-	const boost::char_separator<char> sep{ "," };
-	const boost::tokenizer<boost::char_separator<char>> tokenizer{ curve, sep };
-
-	auto token_iter = tokenizer.begin();
+	TokenReader reader{ curve, ',' };
 
 	std::vector<csg::CurvePoint> points;
-	while (iter_has_contents(token_iter, tokenizer.end(), 3)) {
-		const float x{ my_stof(*token_iter++) };
-		const float y{ my_stof(*token_iter++) };
-		const csg::CurveInterp interp{ get_interp(*token_iter++) };
+	while (reader.has_tokens(3)) {
+		const float x{ my_stof(reader.next()) };
+		const float y{ my_stof(reader.next()) };
+		const csg::CurveInterp interp{ get_interp(reader.next()) };
 		points.push_back(csg::CurvePoint{ csc::Float2{ x, y }, interp });
 	}
 
@@ -402,27 +917,24 @@ static boost::optional<csg::Curve> deserialize_curve(const std::string& curve, c
 	}
 }
 
-static boost::optional<csg::RGBCurveSlotValue> deserialize_rgb_curve(const std::string& rgb_curve)
+static boost::optional<csg::RGBCurveSlotValue> deserialize_rgb_curve(const boost::string_view rgb_curve)
 {
-	const boost::char_separator<char> sep{ "/" };
-	const boost::tokenizer<boost::char_separator<char>> tokenizer{ rgb_curve, sep };
+	TokenReader reader{ rgb_curve, '/' };
 
-	auto token_iter = tokenizer.begin();
-
-	if (iter_has_contents(token_iter, tokenizer.end(), 6) == false) {
+	if (reader.has_tokens(6) == false) {
 		return boost::none;
 	}
 
-	const std::string curve_type{ *token_iter++ };
-	const std::string curve_version{ *token_iter++ };
+	reader.next(); // Curve type
+	reader.next(); // Curve version
 
 	const csc::Float2 min{ 0.0f, 0.0f };
 	const csc::Float2 max{ 1.0f, 1.0f };
 
-	const boost::optional<csg::Curve> opt_all{ deserialize_curve(*token_iter++, min, max) };
-	const boost::optional<csg::Curve> opt_r{ deserialize_curve(*token_iter++, min, max) };
-	const boost::optional<csg::Curve> opt_g{ deserialize_curve(*token_iter++, min, max) };
-	const boost::optional<csg::Curve> opt_b{ deserialize_curve(*token_iter++, min, max) };
+	const boost::optional<csg::Curve> opt_all{ deserialize_curve(reader.next(), min, max) };
+	const boost::optional<csg::Curve> opt_r{ deserialize_curve(reader.next(), min, max) };
+	const boost::optional<csg::Curve> opt_g{ deserialize_curve(reader.next(), min, max) };
+	const boost::optional<csg::Curve> opt_b{ deserialize_curve(reader.next(), min, max) };
 
 	csg::RGBCurveSlotValue result{};
 	if (opt_all) {
@@ -441,30 +953,27 @@ static boost::optional<csg::RGBCurveSlotValue> deserialize_rgb_curve(const std::
 	return result;
 }
 
-static boost::optional<csg::VectorCurveSlotValue> deserialize_vector_curve(const std::string& vector_curve)
+static boost::optional<csg::VectorCurveSlotValue> deserialize_vector_curve(const boost::string_view vector_curve)
 {
-	const boost::char_separator<char> sep{ "/" };
-	const boost::tokenizer<boost::char_separator<char>> tokenizer{ vector_curve, sep };
-
-	auto token_iter = tokenizer.begin();
+	TokenReader reader{ vector_curve, '/' };
 
-	if (iter_has_contents(token_iter, tokenizer.end(), 7) == false) {
+	if (reader.has_tokens(7) == false) {
 		return boost::none;
 	}
 
-	const std::string curve_type{ *token_iter++ };
-	const std::string curve_version{ *token_iter++ };
-	const csc::Float2 min{ my_stof2(*token_iter++) };
-	const csc::Float2 max{ my_stof2(*token_iter++) };
+	reader.next(); // Curve type
+	reader.next(); // Curve version
+	const csc::Float2 min{ my_stof2(reader.next()) };
+	const csc::Float2 max{ my_stof2(reader.next()) };
 
 	// Check validity of min and max before proceeding
 	if (min.x >= max.x || min.y >= max.y) {
 		return boost::none;
 	}
 
-	const boost::optional<csg::Curve> opt_x{ deserialize_curve(*token_iter++, min, max) };
-	const boost::optional<csg::Curve> opt_y{ deserialize_curve(*token_iter++, min, max) };
-	const boost::optional<csg::Curve> opt_z{ deserialize_curve(*token_iter++, min, max) };
+	const boost::optional<csg::Curve> opt_x{ deserialize_curve(reader.next(), min, max) };
+	const boost::optional<csg::Curve> opt_y{ deserialize_curve(reader.next(), min, max) };
+	const boost::optional<csg::Curve> opt_z{ deserialize_curve(reader.next(), min, max) };
 
 	csg::VectorCurveSlotValue result{ min, max };
 	if (opt_x) {
@@ -482,26 +991,23 @@ static boost::optional<csg::VectorCurveSlotValue> deserialize_vector_curve(const
 
 // For deserializing the old curve format
 // This program can only read this format, not write it
-static boost::optional<csg::Curve> deserialize_legacy_curve(const std::string& curve_string)
+static boost::optional<csg::Curve> deserialize_legacy_curve(const boost::string_view curve_string)
 {
-	const boost::char_separator<char> sep{ "," };
-	const boost::tokenizer<boost::char_separator<char>> tokenizer{ curve_string, sep };
+	TokenReader reader{ curve_string, ',' };
 
-	auto token_iter{ tokenizer.begin() };
-
-	if (iter_has_contents(token_iter, tokenizer.end(), 3) == false) {
+	if (reader.has_tokens(3) == false) {
 		return boost::none;
 	}
 
-	const std::string identifier = *token_iter++;
-	const std::string interpolation_str = *token_iter++;
-	const std::string control_point_count_str = *token_iter++;
+	const boost::string_view identifier{ reader.next() };
+	const boost::string_view interpolation_str{ reader.next() };
+	const boost::string_view control_point_count_str{ reader.next() };
 
 	if (identifier != "curve00") {
 		return boost::none;
 	}
 
-	const auto get_interp_type = [](const std::string& name) -> csg::CurveInterp
+	const auto get_interp_type = [](const boost::string_view name) -> csg::CurveInterp
 	{
 		if (name == "cubic_hermite") {
 			return csg::CurveInterp::CUBIC_HERMITE;
@@ -514,15 +1020,15 @@ static boost::optional<csg::Curve> deserialize_legacy_curve(const std::string& c
 
 	const size_t point_count{ static_cast<size_t>(my_stoi(control_point_count_str)) };
 
-	if (iter_has_contents(token_iter, tokenizer.end(), point_count * 2) == false) {
+	if (reader.has_tokens(point_count * 2) == false) {
 		return boost::none;
 	}
 
 	const csc::FloatRect valid_rect{ csc::Float2{ 0.0f, 0.0f }, csc::Float2{ 1.0f, 1.0f} };
 	std::vector<csg::CurvePoint> points;
 	for (size_t i = 0; i < point_count; i++) {
-		const float x{ my_stof(*token_iter++) };
-		const float y{ my_stof(*token_iter++) };
+		const float x{ my_stof(reader.next()) };
+		const float y{ my_stof(reader.next()) };
 		const csc::Float2 pos{ x, y };
 		if (valid_rect.contains(pos)) {
 			points.push_back(csg::CurvePoint{ pos, point_interp });
@@ -537,31 +1043,27 @@ static boost::optional<csg::Curve> deserialize_legacy_curve(const std::string& c
 	return csg::Curve{ valid_rect.begin(), valid_rect.end(), points };
 }
 
-static boost::optional<csg::ColorRamp> deserialize_ramp(const std::string& ramp_string)
+static boost::optional<csg::ColorRamp> deserialize_ramp(const boost::string_view ramp_string)
 {
 	using namespace csg;
 
-	const boost::char_separator<char> sep{ "," };
-	const boost::tokenizer<boost::char_separator<char>> tokenizer{ ramp_string, sep };
-
-	auto token_iter{ tokenizer.begin() };
+	TokenReader reader{ ramp_string, ',' };
 
-	if (iter_has_contents(token_iter, tokenizer.end(), 1) == false) {
+	if (reader.has_tokens(1) == false) {
 		return boost::none;
 	}
 
-	const std::string identifier = *token_iter++;
-	if (identifier != "ramp00") {
+	if (reader.next() != "ramp00") {
 		return boost::none;
 	}
 
 	std::vector<ColorRampPoint> ramp_points;
-	while (iter_has_contents(token_iter, tokenizer.end(), 5)) {
-		const float pos{ my_stof(*token_iter++) };
-		const float r{ my_stof(*token_iter++) };
-		const float g{ my_stof(*token_iter++) };
-		const float b{ my_stof(*token_iter++) };
-		const float a{ my_stof(*token_iter++) };
+	while (reader.has_tokens(5)) {
+		const float pos{ my_stof(reader.next()) };
+		const float r{ my_stof(reader.next()) };
+		const float g{ my_stof(reader.next()) };
+		const float b{ my_stof(reader.next()) };
+		const float a{ my_stof(reader.next()) };
 		const ColorRampPoint this_point{ pos, csc::Float3{ r, g, b }, a };
 		ramp_points.push_back(this_point);
 	}
@@ -573,315 +1075,775 @@ static boost::optional<csg::ColorRamp> deserialize_ramp(const std::string& ramp_
 	return ColorRamp{ ramp_points };
 }
 
-boost::optional<csg::Graph> csg::deserialize_graph(const std::string& graph_string)
+// Translate old parameters that don't exist anymore where possible
+template <typename TTarget>
+static void deserialize_legacy_input(TTarget& graph, const csg::NodeId node_id, const csg::NodeType node_type, const boost::string_view input_name, const boost::string_view input_value)
 {
-	const boost::char_separator<char> sep{ "|" };
-	const boost::tokenizer<boost::char_separator<char>> tokenizer{ graph_string, sep };
+	if (node_type != csg::NodeType::RGB_CURVES) {
+		return;
+	}
+	const boost::optional<csg::Curve> new_curve{ deserialize_legacy_curve(input_value) };
+	if (new_curve.has_value() == false) {
+		return;
+	}
+	const boost::optional<size_t> slot_index{ csg::NodeSchema::from(node_type).slot_index(csg::SlotDirection::INPUT, "curves") };
+	if (slot_index.has_value() == false) {
+		return;
+	}
+	const csg::SlotId slot_id{ node_id, *slot_index };
+	const csg::RGBCurveSlotValue* const opt_curve{ graph.template get_slot_value_as_ptr<csg::RGBCurveSlotValue>(slot_id) };
+	if (opt_curve == nullptr) {
+		return;
+	}
+	csg::RGBCurveSlotValue rgb_curve{ *opt_curve };
+	if (input_name == "rgb_curve") {
+		rgb_curve.set_all(*new_curve);
+		graph.set_curve_rgb(slot_id, std::move(rgb_curve));
+	}
+	else if (input_name == "r_curve") {
+		rgb_curve.set_r(*new_curve);
+		graph.set_curve_rgb(slot_id, std::move(rgb_curve));
+	}
+	else if (input_name == "g_curve") {
+		rgb_curve.set_g(*new_curve);
+		graph.set_curve_rgb(slot_id, std::move(rgb_curve));
+	}
+	else if (input_name == "b_curve") {
+		rgb_curve.set_b(*new_curve);
+		graph.set_curve_rgb(slot_id, std::move(rgb_curve));
+	}
+}
 
-	auto token_iter = tokenizer.begin();
+// Set one slot from its serialized value
+// Everything needed to interpret the value comes from the node's schema, so no reference to the node itself is held while
+// the graph is modified, holding one would force the graph to copy the node on every edit
+// TTarget is either a Graph or a SlotValueTarget, anything with the Graph setters used here
+template <typename TTarget>
+static void deserialize_slot(TTarget& graph, const csg::SlotId slot_id, const csg::NodeSchema& schema, const boost::string_view input_value)
+{
+	using namespace csg;
 
-	if (token_iter == tokenizer.end() || *token_iter != MAGIC_WORD) {
-		return boost::none;
+	const boost::optional<size_t> opt_value_index{ schema.value_index(slot_id.index()) };
+	if (opt_value_index.has_value() == false) {
+		return;
 	}
-	else {
-		++token_iter;
+
+	// Choose how we interpret 'input_value' based on the slot type
+	switch (schema.slots()[slot_id.index()].type()) {
+	case SlotType::BOOL:
+	{
+		const bool bool_value{ static_cast<bool>(my_stoi(input_value)) };
+		graph.set_bool(slot_id, bool_value);
+		break;
 	}
+	case SlotType::COLOR:
+	{
+		const csc::Float3 float3_value{ my_stof3(input_value) };
+		graph.set_color(slot_id, float3_value);
+		break;
+	}
+	case SlotType::ENUM:
+	{
+		const EnumSlotValue* const slot_value{ schema.default_values()[*opt_value_index].as_ptr<EnumSlotValue>() };
+		if (slot_value) {
+			const NodeMetaEnum meta_enum{ slot_value->get_meta() };
+			assert(NodeEnumInfo::from(meta_enum).has_value());
+			const NodeEnumInfo enum_info{ NodeEnumInfo::from(meta_enum).value() };
+			// Loop though all available internal names to look for a match
+			for (size_t i = 0; i < enum_info.count(); i++) {
+				assert(NodeEnumOptionInfo::from(meta_enum, i).has_value());
+				const NodeEnumOptionInfo option_info{ NodeEnumOptionInfo::from(meta_enum, i).value() };
+				if (input_value == option_info.internal_name()) {
+					// Match the regular internal name
+					graph.set_enum(slot_id, i);
+					break;
+				}
+				else if (option_info.alt_name() && input_value == option_info.alt_name()) {
+					// Match the alternate name if it exists
+					graph.set_enum(slot_id, i);
+					break;
+				}
+			}
+		}
+		break;
+	}
+	case SlotType::FLOAT:
+	{
+		const float float_value{ my_stof(input_value) };
+		graph.set_float(slot_id, float_value);
+		break;
+	}
+	case SlotType::INT:
+	{
+		const int int_value{ my_stoi(input_value) };
+		graph.set_int(slot_id, int_value);
+		break;
+	}
+	case SlotType::VECTOR:
+	{
+		const csc::Float3 float3_value{ my_stof3(input_value) };
+		graph.set_vector(slot_id, float3_value);
+		break;
+	}
+	case SlotType::CURVE_RGB:
+	{
+		boost::optional<csg::RGBCurveSlotValue> opt_curve_value{ deserialize_rgb_curve(input_value) };
+		if (opt_curve_value) {
+			graph.set_curve_rgb(slot_id, std::move(*opt_curve_value));
+		}
+		break;
+	}
+	case SlotType::CURVE_VECTOR:
+	{
+		boost::optional<csg::VectorCurveSlotValue> opt_curve_value{ deserialize_vector_curve(input_value) };
+		if (opt_curve_value) {
+			graph.set_curve_vec(slot_id, std::move(*opt_curve_value));
+		}
+		break;
+	}
+	case SlotType::COLOR_RAMP:
+	{
+		boost::optional<csg::ColorRamp> opt_ramp_value{ deserialize_ramp(input_value) };
+		if (opt_ramp_value) {
+			graph.set_color_ramp(slot_id, std::move(*opt_ramp_value));
+		}
+		break;
+	}
+	default:
+		// Not a type we know how to parse from a string, do nothing
+		break;
+	}
+}
 
-	if (token_iter == tokenizer.end() || *token_iter != VERSION_INPUT) {
-		return boost::none;
+// Set one input from its name and serialized value
+template <typename TTarget>
+static void deserialize_input(TTarget& graph, const csg::NodeId node_id, const csg::NodeSchema& schema, const boost::string_view input_name, const boost::string_view input_value)
+{
+	const boost::optional<size_t> opt_slot_index{ schema.slot_index(csg::SlotDirection::INPUT, input_name) };
+	if (opt_slot_index.has_value() == false) {
+		deserialize_legacy_input(graph, node_id, schema.type(), input_name, input_value);
+		return;
 	}
-	else {
-		++token_iter;
+	deserialize_slot(graph, csg::SlotId{ node_id, *opt_slot_index }, schema, input_value);
+}
+
+static boost::optional<size_t> find_slot_by_disp_name(const csg::NodeSchema& schema, const csg::SlotDirection dir, const boost::string_view disp_name)
+{
+	const std::vector<csg::Slot>& slots{ schema.slots() };
+	for (size_t i = 0; i < slots.size(); i++) {
+		if (slots[i].dir() == dir && disp_name == slots[i].disp_name()) {
+			return i;
+		}
+	}
+	return boost::none;
+}
+
+// Takes the place of a Graph when parsing the inputs of a single slot, so one value can be parsed without building a node
+// Setters for any other slot are ignored
+class SlotValueTarget {
+public:
+	SlotValueTarget(const csg::SlotId slot_id, const csg::SlotValue& default_value) : slot_id{ slot_id }, default_value{ default_value } {}
+
+	template <typename T> const T* get_slot_value_as_ptr(const csg::SlotId id) const
+	{
+		if (id != slot_id) {
+			return nullptr;
+		}
+		return value ? value->as_ptr<T>() : default_value.as_ptr<T>();
 	}
 
-	csg::Graph result{ GraphType::EMPTY };
+	bool set_bool(const csg::SlotId id, const bool new_value) { return update<csg::BoolSlotValue>(id, new_value); }
+	bool set_color(const csg::SlotId id, const csc::Float3 new_value) { return update<csg::ColorSlotValue>(id, new_value); }
+	bool set_enum(const csg::SlotId id, const size_t new_value) { return update<csg::EnumSlotValue>(id, new_value); }
+	bool set_float(const csg::SlotId id, const float new_value) { return update<csg::FloatSlotValue>(id, new_value); }
+	bool set_int(const csg::SlotId id, const int new_value) { return update<csg::IntSlotValue>(id, new_value); }
+	bool set_vector(const csg::SlotId id, const csc::Float3 new_value) { return update<csg::VectorSlotValue>(id, new_value); }
+	bool set_color_ramp(const csg::SlotId id, csg::ColorRampSlotValue new_value) { return replace(id, std::move(new_value)); }
+	bool set_curve_rgb(const csg::SlotId id, csg::RGBCurveSlotValue new_value) { return replace(id, std::move(new_value)); }
+	bool set_curve_vec(const csg::SlotId id, csg::VectorCurveSlotValue new_value) { return replace(id, std::move(new_value)); }
+
+	// Empty until a setter succeeds, the default value still applies until then
+	boost::optional<csg::SlotValue> value;
+
+private:
+	// Same as Graph, the slot's own set() applies any limits on the new value
+	template <typename TSlot, typename TRaw> bool update(const csg::SlotId id, const TRaw new_value)
+	{
+		const TSlot* const old_value{ get_slot_value_as_ptr<TSlot>(id) };
+		if (old_value == nullptr) {
+			return false;
+		}
+		TSlot new_slot_value{ *old_value };
+		new_slot_value.set(new_value);
+		value.emplace(new_slot_value);
+		return true;
+	}
 
-	// Advance iterator until we find the start of the node section
-	while (token_iter != tokenizer.end() && *token_iter != SECTION_NODES) {
-		token_iter++;
+	template <typename TSlot> bool replace(const csg::SlotId id, TSlot&& new_value)
+	{
+		if (get_slot_value_as_ptr<TSlot>(id) == nullptr) {
+			return false;
+		}
+		value.emplace(std::move(new_value));
+		return true;
 	}
 
-	if (token_iter == tokenizer.end()) {
-		// No nodes or connection section in the input, return empty graph
-		return result;
+	csg::SlotId slot_id;
+	const csg::SlotValue& default_value;
+};
+
+// Receives the content of a text graph as deserialize_tokens reads it and builds a Graph right away
+class GraphBuilder {
+public:
+	// Returns none if a node with the same id has already been added
+	boost::optional<csg::NodeId> add_node(const csg::NodeType type, const csc::Int2 pos, const boost::optional<csg::NodeId> id)
+	{
+		if (id.has_value() == false) {
+			return graph.add(type, pos);
+		}
+		else if (graph.add(type, pos, *id)) {
+			return id;
+		}
+		else {
+			return boost::none;
+		}
 	}
 
-	// Map to let us look up node ids by name
-	// This will be needed for building connections later in this function
-	std::map<std::string, NodeId> ids_by_name;
+	void add_input(const csg::NodeId node_id, const csg::NodeSchema& schema, const boost::string_view input_name, const boost::string_view input_value)
+	{
+		deserialize_input(graph, node_id, schema, input_name, input_value);
+	}
 
-	// Advance token to the start of the first node
-	token_iter++;
+	void add_connection(const csg::SlotId source, const csg::SlotId dest)
+	{
+		graph.add_connection(source, dest);
+	}
+
+	csg::Graph graph{ csg::GraphType::EMPTY };
+};
+
+typedef std::pair<csg::NodeId, const csg::NodeSchema*> NamedNode;
+typedef std::unordered_map<boost::string_view, NamedNode, StringViewHash> NodesByName;
+
+// The parsing functions below are shared by the string and stream parsers
+// Views returned by reader.next() are used before the reader looks ahead again, everything read is passed on to builder
+
+// Checks the header and advances to the first node, returns false if the header is invalid
+template <typename TReader>
+static bool deserialize_header(TReader& reader)
+{
+	if (reader.at_end() || reader.next() != MAGIC_WORD) {
+		return false;
+	}
+
+	if (reader.at_end() || reader.next() != VERSION_INPUT) {
+		return false;
+	}
+
+	// Advance until we find the start of the node section
+	while (reader.at_end() == false && reader.peek() != SECTION_NODES) {
+		reader.next();
+	}
+
+	// Advance to the start of the first node
+	if (reader.at_end() == false) {
+		reader.next();
+	}
+	return true;
+}
+
+// Reads nodes until the connections header, the end of the input, or stop() returns true at the start of a node
+// Each node's name is added to nodes_by_name to resolve connections later, returns false if the graph is invalid
+template <typename TReader, typename TBuilder, typename TStop>
+static bool deserialize_nodes(TReader& reader, TBuilder& builder, NodesByName& nodes_by_name, const TStop stop)
+{
+	using namespace csg;
+
+	const auto skip_past_node_end = [&reader]() {
+		while (reader.at_end() == false && reader.peek() != NODE_END) {
+			reader.next();
+		}
+		if (reader.at_end() == false) {
+			reader.next();
+		}
+	};
 
 	// Loop adding nodes until we see the connections header
-	while (token_iter != tokenizer.end() && *token_iter != SECTION_CONNECTIONS) {
+	while (reader.at_end() == false && reader.peek() != SECTION_CONNECTIONS && stop() == false) {
 		constexpr size_t NODE_MIN_TOKENS{ 5 }; // type, name, x, y, node_end
-		if (iter_has_contents(token_iter, tokenizer.end(), NODE_MIN_TOKENS) == false) {
+		if (reader.has_tokens(NODE_MIN_TOKENS) == false) {
 			// Not enough tokens exist to form a node, end here
-			return result;
+			// Too few tokens remain to hold a connection either
+			break;
 		}
-		assert(token_iter != tokenizer.end());
-		const std::string type_code{ *token_iter++ };
-		assert(token_iter != tokenizer.end());
-		const std::string node_name{ *token_iter++ };
-		assert(token_iter != tokenizer.end());
-		const int x{ my_stoi(*token_iter++) };
-		assert(token_iter != tokenizer.end());
-		const int y{ my_stoi(*token_iter++) };
+		const boost::string_view type_code{ reader.next() };
+		const boost::string_view node_name{ reader.next() };
+		const int x{ my_stoi(reader.next()) };
+		const int y{ my_stoi(reader.next()) };
 
 		const boost::optional<NodeType> opt_node_type{ get_type_from_name(type_code) };
 		if (opt_node_type.has_value() == false) {
 			// We do not recognize this type code
-			// Advance the iterator past this node and continue
-			while (token_iter != tokenizer.end() && *token_iter != NODE_END) {
-				token_iter++;
-			}
-			if (*token_iter == NODE_END) {
-				token_iter++;
-			}
+			// Advance past this node and continue
+			skip_past_node_end();
 			continue;
 		}
 
-		const boost::optional<NodeId> opt_node_id{ node_id_from_name(node_name) };
-		NodeId node_id;
-		if (opt_node_id.has_value()) {
-			node_id = opt_node_id.value();
-			if (result.add(opt_node_type.value(), csc::Int2{ x, y }, node_id) == false) {
-				// This node was not added because it is a duplicate id
-				// This can randomly happen but should be very rare (birthday problem with a 64 bit number)
-				// except in malformed graphs
-				return boost::none;
-			}
-		}
-		else {
-			node_id = result.add(opt_node_type.value(), csc::Int2{ x, y });
+		const boost::optional<NodeId> opt_node_id{ builder.add_node(opt_node_type.value(), csc::Int2{ x, y }, node_id_from_name(node_name)) };
+		if (opt_node_id.has_value() == false) {
+			// This node was not added because it is a duplicate id
+			// This can randomly happen but should be very rare (birthday problem with a 64 bit number)
+			// except in malformed graphs
+			return false;
 		}
-		
-		if (ids_by_name.count(node_name) != 0) {
+		const NodeId node_id{ opt_node_id.value() };
+
+		const NodeSchema& schema{ NodeSchema::from(opt_node_type.value()) };
+		if (nodes_by_name.emplace(reader.keep(node_name), NamedNode{ node_id, &schema }).second == false) {
 			// This name has already been used
 			// The graph is invalid, abort processing here
-			return boost::none;
+			return false;
 		}
-		ids_by_name[node_name] = node_id;
 
 		// Load in all input/value pairs
-		while (token_iter != tokenizer.end() && *token_iter != NODE_END && iter_has_contents(token_iter, tokenizer.end(), 2)) {
-			assert(token_iter != tokenizer.end());
-			const std::string input_name{ *token_iter++ };
-			assert(token_iter != tokenizer.end());
-			const std::string input_value{ *token_iter++ };
-
-			const std::shared_ptr<const Node> node{ result.get(node_id) };
-			assert(node.use_count() > 0);
-
-			const boost::optional<size_t> opt_slot_index{ node->slot_index(SlotDirection::INPUT, input_name) };
-			if (opt_slot_index.has_value()) {
-				const boost::optional<Slot> opt_slot = node->slot(*opt_slot_index);
-				assert(opt_slot.has_value());
-				if (opt_slot->value.has_value()) {
-					const SlotId slot_id{ node->id(), *opt_slot_index };
-					// Choose how we interpret 'input_value' based on the slot type
-					switch (opt_slot.value().type()) {
-					case SlotType::BOOL:
-					{
-						const bool bool_value{ static_cast<bool>(my_stoi(input_value)) };
-						result.set_bool(slot_id, bool_value);
-						break;
-					}
-					case SlotType::COLOR:
-					{
-						const csc::Float3 float3_value{ my_stof3(input_value) };
-						result.set_color(slot_id, float3_value);
-						break;
-					}
-					case SlotType::ENUM:
-					{
-						const boost::optional<EnumSlotValue> slot_value{ opt_slot->value->as<EnumSlotValue>() };
-						if (slot_value) {
-							const NodeMetaEnum meta_enum{ slot_value->get_meta() };
-							assert(NodeEnumInfo::from(meta_enum).has_value());
-							const NodeEnumInfo enum_info{ NodeEnumInfo::from(meta_enum).value() };
-							// Loop though all available internal names to look for a match
-							for (size_t i = 0; i < enum_info.count(); i++) {
-								assert(NodeEnumOptionInfo::from(meta_enum, i).has_value());
-								const NodeEnumOptionInfo option_info{ NodeEnumOptionInfo::from(meta_enum, i).value() };
-								if (input_value == option_info.internal_name()) {
-									// Match the regular internal name
-									result.set_enum(slot_id, i);
-									break;
-								}
-								else if (option_info.alt_name() && input_value == option_info.alt_name()) {
-									// Match the alternate name if it exists
-									result.set_enum(slot_id, i);
-									break;
-								}
-							}
-						}
-						break;
-					}
-					case SlotType::FLOAT:
-					{
-						const float float_value{ my_stof(input_value) };
-						result.set_float(slot_id, float_value);
-						break;
-					}
-					case SlotType::INT:
-					{
-						const int int_value{ my_stoi(input_value) };
-						result.set_int(slot_id, int_value);
-						break;
-					}
-					case SlotType::VECTOR:
-					{
-						const csc::Float3 float3_value{ my_stof3(input_value) };
-						result.set_vector(slot_id, float3_value);
-						break;
-					}
-					case SlotType::CURVE_RGB:
-					{
-						const boost::optional<csg::RGBCurveSlotValue> opt_curve_value{ deserialize_rgb_curve(input_value) };
-						if (opt_curve_value) {
-							result.set_curve_rgb(slot_id, *opt_curve_value);
-						}
-						break;
-					}
-					case SlotType::CURVE_VECTOR:
-					{
-						const boost::optional<csg::VectorCurveSlotValue> opt_curve_value{ deserialize_vector_curve(input_value) };
-						if (opt_curve_value) {
-							result.set_curve_vec(slot_id, *opt_curve_value);
-						}
-						break;
-					}
-					case SlotType::COLOR_RAMP:
-					{
-						const boost::optional<csg::ColorRamp> opt_ramp_value{ deserialize_ramp(input_value) };
-						if (opt_ramp_value) {
-							result.set_color_ramp(slot_id, *opt_ramp_value);
-						}
-						break;
-					}
-					default:
-						// Not a type we know how to parse from a string, do nothing
-						break;
-					}
-				}
-			}
-			else {
-				// Here we can handle old parameters that don't exist anymore and translate them if possible
-				if (opt_node_type == csg::NodeType::RGB_CURVES) {
-					const boost::optional<csg::Curve> new_curve{ deserialize_legacy_curve(input_value) };
-					if (new_curve) {
-						const boost::optional<size_t> slot_index{ node->slot_index(csg::SlotDirection::INPUT, "curves") };
-						if (slot_index) {
-							const boost::optional<csg::Slot> slot{ node->slot(*slot_index) };
-							if (slot && slot->type() == csg::SlotType::CURVE_RGB) {
-								const boost::optional<csg::RGBCurveSlotValue> opt_curve{ slot->value->as<csg::RGBCurveSlotValue>() };
-								if (opt_curve) {
-									csg::RGBCurveSlotValue rgb_curve{ *opt_curve };
-									if (input_name == "rgb_curve") {
-										rgb_curve.set_all(*new_curve);
-										result.set_curve_rgb(csg::SlotId{ node_id, *slot_index }, rgb_curve);
-									}
-									else if (input_name == "r_curve") {
-										rgb_curve.set_r(*new_curve);
-										result.set_curve_rgb(csg::SlotId{ node_id, *slot_index }, rgb_curve);
-									}
-									else if (input_name == "g_curve") {
-										rgb_curve.set_g(*new_curve);
-										result.set_curve_rgb(csg::SlotId{ node_id, *slot_index }, rgb_curve);
-									}
-									else if (input_name == "b_curve") {
-										rgb_curve.set_b(*new_curve);
-										result.set_curve_rgb(csg::SlotId{ node_id, *slot_index }, rgb_curve);
-									}
-								}
-							}
-						}
-					}
-				}
-			}
+		while (reader.at_end() == false && reader.peek() != NODE_END && reader.has_tokens(2)) {
+			const boost::string_view input_name{ reader.next() };
+			const boost::string_view input_value{ reader.next() };
+			builder.add_input(node_id, schema, input_name, input_value);
 		}
 
 		// Advance to one past the next NODE_END and continue loop
-		while (token_iter != tokenizer.end() && *token_iter != NODE_END) {
-			token_iter++;
+		skip_past_node_end();
+	}
+
+	return true;
+}
+
+// Reads the connection section, connections that do not match a node and slot are skipped
+// find_node returns the node with the given name, or none
+template <typename TReader, typename TBuilder, typename TFind>
+static void deserialize_connections(TReader& reader, TBuilder& builder, const TFind& find_node)
+{
+	using namespace csg;
+
+	// Advance until we find the start of the connection section
+	while (reader.at_end() == false && reader.peek() != SECTION_CONNECTIONS) {
+		reader.next();
+	}
+
+	if (reader.at_end()) {
+		// No connections, the graph is complete
+		return;
+	}
+
+	// Advance to the start of the first connection
+	reader.next();
+
+	constexpr size_t CONNECTION_TOKENS{ 4 };
+	while (reader.has_tokens(CONNECTION_TOKENS)) {
+		const boost::string_view name_src{ reader.next() };
+		const boost::string_view slot_src{ reader.next() };
+		const boost::string_view name_dst{ reader.next() };
+		const boost::string_view slot_dst{ reader.next() };
+		const boost::optional<NamedNode> node_src{ find_node(name_src) };
+		const boost::optional<NamedNode> node_dst{ find_node(name_dst) };
+		if (node_src.has_value() == false || node_dst.has_value() == false) {
+			// Name does not reference a real node, skip this connection
+			continue;
 		}
-		if (*token_iter == NODE_END) {
-			token_iter++;
+		const NodeId id_src{ node_src->first };
+		const NodeId id_dst{ node_dst->first };
+
+		const boost::optional<size_t> slot_index_src{ find_slot_by_disp_name(*node_src->second, SlotDirection::OUTPUT, slot_src) };
+		const boost::optional<size_t> slot_index_dst{ find_slot_by_disp_name(*node_dst->second, SlotDirection::INPUT, slot_dst) };
+
+		if (slot_index_src.has_value() == false || slot_index_dst.has_value() == false) {
+			continue;
 		}
+
+		const SlotId src_slot_id{ id_src, slot_index_src.value() };
+		const SlotId dst_slot_id{ id_dst, slot_index_dst.value() };
+
+		builder.add_connection(src_slot_id, dst_slot_id);
 	}
+}
 
-	// Advance iterator until we find the start of the connection section
-	while (token_iter != tokenizer.end() && *token_iter != SECTION_CONNECTIONS) {
-		token_iter++;
+static boost::optional<NamedNode> find_node_by_name(const NodesByName& nodes_by_name, const boost::string_view name)
+{
+	const auto iter{ nodes_by_name.find(name) };
+	if (iter == nodes_by_name.end()) {
+		return boost::none;
 	}
+	return iter->second;
+}
 
-	if (token_iter == tokenizer.end()) {
-		// No connections, return graph so far
-		return result;
+// Reads a whole graph, returns false if the graph is invalid
+template <typename TReader, typename TBuilder>
+static bool deserialize_tokens(TReader& reader, TBuilder& builder)
+{
+	NodesByName nodes_by_name;
+	if (deserialize_header(reader) == false) {
+		return false;
+	}
+	if (deserialize_nodes(reader, builder, nodes_by_name, []() { return false; }) == false) {
+		return false;
 	}
+	deserialize_connections(reader, builder, [&nodes_by_name](const boost::string_view name) {
+		return find_node_by_name(nodes_by_name, name);
+	});
+	return true;
+}
+
+boost::optional<csg::Graph> csg::deserialize_graph(const boost::string_view graph_string)
+{
+	// Every token is a view into graph_string, nothing is copied out of the input while parsing
+	TokenReader reader{ graph_string, '|' };
+	GraphBuilder builder;
+	if (deserialize_tokens(reader, builder) == false) {
+		return boost::none;
+	}
+	return builder.graph;
+}
+
+boost::optional<csg::Graph> csg::deserialize_graph(std::istream& input)
+{
+	StreamTokenReader reader{ input, '|' };
+	GraphBuilder builder;
+	if (deserialize_tokens(reader, builder) == false) {
+		return boost::none;
+	}
+	return builder.graph;
+}
+
+// A node section smaller than this is not worth handing to another thread
+static constexpr size_t PARALLEL_CHUNK_MIN_SIZE{ 64 * 1024 };
+
+// Nodes read by one thread, from a position that is only assumed to be the start of a node
+struct NodeChunk {
+	const char* begin;
+	// Reading stops at the first node that starts at or after this, the begin of the next chunk
+	const char* limit;
+	// Where reading stopped
+	const char* end;
+	bool valid;
+	// True if the node section ended within this chunk
+	bool finished;
+	// True if every node is named the way serialize_graph names it, from its id
+	bool id_names;
+	GraphBuilder builder;
+	NodesByName nodes_by_name;
+};
+
+// Returns the position just past the first whole node_end token at or after offset, or nullptr if there is none
+static const char* find_node_boundary(const boost::string_view input, size_t offset)
+{
+	const boost::string_view node_end{ NODE_END };
+	while (true) {
+		const size_t found{ input.find(node_end, offset) };
+		if (found == boost::string_view::npos) {
+			return nullptr;
+		}
+		const size_t after{ found + node_end.size() };
+		const bool whole_token{ (found == 0 || input[found - 1] == '|') && (after == input.size() || input[after] == '|') };
+		if (whole_token) {
+			return input.data() + after;
+		}
+		offset = found + 1;
+	}
+}
 
-	// Advance token to the start of the first connection
-	token_iter++;
+// Runs every task using up to thread_count threads, the calling thread takes tasks too
+// Workers exit when no task is left and are joined before this returns, so no thread outlives the load
+// If no worker can be started, the calling thread runs every task itself
+static void run_chunk_tasks(const std::vector<std::function<void()>>& tasks, const size_t thread_count)
+{
+	std::atomic<size_t> next_task{ 0 };
+	const auto work = [&tasks, &next_task]() {
+		for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+			tasks[i]();
+		}
+	};
 
-	while (token_iter != tokenizer.end()) {
-		constexpr size_t CONNECTION_TOKENS{ 4 };
-		if (iter_has_contents(token_iter, tokenizer.end(), CONNECTION_TOKENS) == false) {
-			// Not enough tokens left for a full connection, end early
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count - 1);
+	while (threads.size() + 1 < thread_count) {
+		try {
+			threads.push_back(std::thread{ work });
+		}
+		catch (const std::system_error&) {
+			// Out of threads, the workers already running and the caller share the tasks
 			break;
 		}
+	}
+	work();
+	for (std::thread& this_thread : threads) {
+		this_thread.join();
+	}
+}
 
-		const std::string name_src{ *(token_iter++) };
-		const std::string slot_src{ *(token_iter++) };
-		const std::string name_dst{ *(token_iter++) };
-		const std::string slot_dst{ *(token_iter++) };
-		if (ids_by_name.count(name_src) == 0 || ids_by_name.count(name_dst) == 0) {
-			// Name does not reference a real node, skip this connection
-			continue;
+static void deserialize_chunk(const boost::string_view graph_string, NodeChunk& chunk)
+{
+	TokenReader reader{ graph_string.substr(chunk.begin - graph_string.data()), '|' };
+	const char* const limit{ chunk.limit };
+	chunk.valid = deserialize_nodes(reader, chunk.builder, chunk.nodes_by_name, [&reader, limit]() {
+		return reader.position() >= limit;
+	});
+	chunk.end = reader.position();
+	chunk.finished = chunk.end < limit;
+
+	chunk.id_names = true;
+	std::string id_name;
+	for (const auto& name_node : chunk.nodes_by_name) {
+		id_name.clear();
+		append_node_name(id_name, name_node.second.first);
+		if (name_node.first != id_name) {
+			chunk.id_names = false;
+			break;
+		}
+	}
+}
+
+boost::optional<csg::Graph> csg::deserialize_graph(const boost::string_view graph_string, const size_t thread_count)
+{
+	TokenReader header_reader{ graph_string, '|' };
+	if (deserialize_header(header_reader) == false) {
+		return boost::none;
+	}
+
+	// Split everything after the header into chunks of about equal size, each beginning after a node_end token
+	// The end of the node section is not known yet, chunks that begin past it are discarded when merging
+	const char* const input_end{ graph_string.data() + graph_string.size() };
+	const size_t nodes_offset{ static_cast<size_t>(header_reader.position() - graph_string.data()) };
+	const size_t nodes_size{ graph_string.size() - nodes_offset };
+	const size_t chunk_count{ std::max(static_cast<size_t>(1), std::min(thread_count, nodes_size / PARALLEL_CHUNK_MIN_SIZE)) };
+	std::vector<const char*> chunk_begins{ header_reader.position() };
+	for (size_t i = 1; i < chunk_count; i++) {
+		const char* const boundary{ find_node_boundary(graph_string, nodes_offset + nodes_size * i / chunk_count) };
+		if (boundary == nullptr) {
+			break;
+		}
+		// Begin at the next token itself so it compares equal to where the previous chunk's reader stops
+		const char* const begin{ TokenReader{ boost::string_view{ boundary, static_cast<size_t>(input_end - boundary) }, '|' }.position() };
+		if (begin > chunk_begins.back()) {
+			chunk_begins.push_back(begin);
+		}
+	}
+
+	std::vector<NodeChunk> chunks(chunk_begins.size());
+	for (size_t i = 0; i < chunks.size(); i++) {
+		chunks[i].begin = chunk_begins[i];
+		chunks[i].limit = (i + 1 < chunks.size()) ? chunk_begins[i + 1] : input_end;
+	}
+	if (chunks.size() == 1) {
+		deserialize_chunk(graph_string, chunks[0]);
+	}
+	else {
+		std::vector<std::function<void()>> tasks;
+		for (NodeChunk& chunk : chunks) {
+			tasks.push_back([graph_string, &chunk]() { deserialize_chunk(graph_string, chunk); });
+		}
+		run_chunk_tasks(tasks, chunks.size());
+	}
+
+	// The first chunk holds the result, the others are added to it in order
+	// A chunk only began at a real node if the chunk before it stopped exactly there, which a node_end token inside a
+	// value can prevent, so merging stops at the first chunk that does not line up and the rest is read on this thread
+	GraphBuilder& builder{ chunks[0].builder };
+	const char* position{ chunks[0].begin };
+	size_t merged_count{ 0 };
+	bool finished{ false };
+	bool id_names{ true };
+	for (NodeChunk& chunk : chunks) {
+		if (chunk.begin != position) {
+			break;
+		}
+		if (chunk.valid == false) {
+			return boost::none;
+		}
+		if (merged_count > 0 && builder.graph.add_nodes(chunk.builder.graph) == false) {
+			return boost::none;
+		}
+		merged_count++;
+		id_names = id_names && chunk.id_names;
+		position = chunk.end;
+		if (chunk.finished) {
+			finished = true;
+			break;
+		}
+	}
+
+	TokenReader reader{ boost::string_view{ position, static_cast<size_t>(input_end - position) }, '|' };
+	if (finished && id_names) {
+		// Every name is made from its node's id, so a connection's nodes can be found from the ids in their names
+		// That avoids merging the names into one table here, and any duplicate name was already caught as a duplicate id
+		std::string id_name;
+		deserialize_connections(reader, builder, [&builder, &id_name](const boost::string_view name) -> boost::optional<NamedNode> {
+			const boost::optional<NodeId> node_id{ node_id_from_name(name) };
+			if (node_id.has_value() == false) {
+				return boost::none;
+			}
+			id_name.clear();
+			append_node_name(id_name, *node_id);
+			const std::shared_ptr<const Node> node{ builder.graph.get(*node_id) };
+			if (name != id_name || node == nullptr) {
+				return boost::none;
+			}
+			return NamedNode{ *node_id, &node->schema() };
+		});
+		return builder.graph;
+	}
+
+	NodesByName& nodes_by_name{ chunks[0].nodes_by_name };
+	for (size_t i = 1; i < merged_count; i++) {
+		for (const auto& name_node : chunks[i].nodes_by_name) {
+			if (nodes_by_name.insert(name_node).second == false) {
+				return boost::none;
+			}
 		}
-		const NodeId id_src{ ids_by_name[name_src] };
-		const NodeId id_dst{ ids_by_name[name_dst] };
+	}
+	if (finished == false && deserialize_nodes(reader, builder, nodes_by_name, []() { return false; }) == false) {
+		return boost::none;
+	}
+	deserialize_connections(reader, builder, [&nodes_by_name](const boost::string_view name) {
+		return find_node_by_name(nodes_by_name, name);
+	});
+	return builder.graph;
+}
 
-		// Find source slot
-		const auto node_src{ result.get(id_src) };
-		assert(node_src.use_count() > 0);
-		boost::optional<size_t> slot_index_src;
+boost::optional<csg::LazyGraph> csg::LazyGraph::from(const boost::string_view graph_string)
+{
+	// Records where each value is instead of parsing it
+	// Every token is a view into graph_string, so the views kept here stay valid as long as the text
+	class IndexBuilder {
+	public:
+		IndexBuilder(LazyGraph& lazy_graph) : lazy_graph{ lazy_graph } {}
+
+		boost::optional<NodeId> add_node(const NodeType type, const csc::Int2 pos, const boost::optional<NodeId> id)
 		{
-			size_t current_index{ 0 };
-			for (const Slot this_slot : node_src->slots()) {
-				if (this_slot.dir() == csg::SlotDirection::OUTPUT && slot_src == this_slot.disp_name()) {
-					slot_index_src = current_index;
-					break;
-				}
-				current_index++;
+			NodeId new_id;
+			if (id.has_value()) {
+				new_id = *id;
 			}
+			else {
+				// Only old files name nodes without an id, roll one the same way Graph::add does
+				do {
+					new_id = Node{ type, pos }.id();
+				} while (lazy_graph.index_by_id.count(new_id) != 0);
+			}
+			if (lazy_graph.index_by_id.emplace(new_id, lazy_graph._nodes.size()).second == false) {
+				return boost::none;
+			}
+			lazy_graph._nodes.push_back(NodeInfo{ new_id, type, pos });
+			lazy_graph.input_begin.push_back(lazy_graph.inputs.size());
+			return new_id;
 		}
 
-		// Find Dest slot
-		const auto node_dst{ result.get(id_dst) };
-		assert(node_dst.use_count() > 0);
-		boost::optional<size_t> slot_index_dst;
+		// Inputs always belong to the node added last
+		void add_input(NodeId, const NodeSchema& schema, const boost::string_view input_name, const boost::string_view input_value)
 		{
-			size_t current_index{ 0 };
-			for (const Slot this_slot : node_dst->slots()) {
-				if (this_slot.dir() == csg::SlotDirection::INPUT && slot_dst == this_slot.disp_name()) {
-					slot_index_dst = current_index;
-					break;
-				}
-				current_index++;
+			lazy_graph.inputs.push_back(InputText{ input_name, input_value, schema.slot_index(SlotDirection::INPUT, input_name) });
+		}
+
+		void add_connection(const SlotId source, const SlotId dest)
+		{
+			if (source.node_id() != dest.node_id()) {
+				lazy_graph._connections.push_back(Connection{ source, dest });
 			}
 		}
 
-		if (slot_index_src.has_value() == false || slot_index_dst.has_value() == false) {
-			continue;
+	private:
+		LazyGraph& lazy_graph;
+	};
+
+	LazyGraph result;
+	TokenReader reader{ graph_string, '|' };
+	IndexBuilder builder{ result };
+	if (deserialize_tokens(reader, builder) == false) {
+		return boost::none;
+	}
+	result.input_begin.push_back(result.inputs.size());
+
+	// A later connection to the same input replaces an earlier one, as it does with Graph::add_connection
+	std::vector<Connection>& connections{ result._connections };
+	std::stable_sort(connections.begin(), connections.end(), [](const Connection& a, const Connection& b) {
+		return a.dest() < b.dest();
+	});
+	size_t kept{ 0 };
+	for (size_t i = 0; i < connections.size(); i++) {
+		if (i + 1 == connections.size() || connections[i + 1].dest() != connections[i].dest()) {
+			connections[kept++] = connections[i];
 		}
+	}
+	connections.erase(connections.begin() + kept, connections.end());
+	std::sort(connections.begin(), connections.end());
 
-		const SlotId src_slot_id{ id_src, slot_index_src.value() };
-		const SlotId dst_slot_id{ id_dst, slot_index_dst.value() };
+	return result;
+}
+
+boost::optional<size_t> csg::LazyGraph::find(const NodeId id) const
+{
+	const auto iter{ index_by_id.find(id) };
+	if (iter == index_by_id.end()) {
+		return boost::none;
+	}
+	return iter->second;
+}
+
+const csg::SlotValue* csg::LazyGraph::get_slot_value_ptr(const SlotId slot_id) const
+{
+	const boost::optional<size_t> node_index{ find(slot_id.node_id()) };
+	if (node_index.has_value() == false) {
+		return nullptr;
+	}
+	const NodeSchema& schema{ NodeSchema::from(_nodes[*node_index].type) };
+	const boost::optional<size_t> value_index{ schema.value_index(slot_id.index()) };
+	if (value_index.has_value() == false) {
+		return nullptr;
+	}
 
-		result.add_connection(src_slot_id, dst_slot_id);
+	const auto parsed_iter{ parsed_values.find(slot_id) };
+	if (parsed_iter != parsed_values.end()) {
+		return &parsed_iter->second;
 	}
 
+	// Apply every input that sets this slot in the order they appear, as a full load does
+	SlotValueTarget target{ slot_id, schema.default_values()[*value_index] };
+	for (size_t i = input_begin[*node_index]; i < input_begin[*node_index + 1]; i++) {
+		const InputText& input{ inputs[i] };
+		if (input.slot_index.has_value() == false) {
+			deserialize_legacy_input(target, slot_id.node_id(), schema.type(), input.name, input.value);
+		}
+		else if (*input.slot_index == slot_id.index()) {
+			deserialize_slot(target, slot_id, schema, input.value);
+		}
+	}
+
+	if (target.value.has_value() == false) {
+		// Nothing in the text sets this slot, point at the default rather than keeping a copy of it
+		return &schema.default_values()[*value_index];
+	}
+	return &parsed_values.emplace(slot_id, *target.value).first->second;
+}
+
+csg::Graph csg::LazyGraph::to_graph() const
+{
+	Graph result{ GraphType::EMPTY };
+	for (size_t i = 0; i < _nodes.size(); i++) {
+		const NodeInfo& node{ _nodes[i] };
+		result.add(node.type, node.position, node.id);
+		const NodeSchema& schema{ NodeSchema::from(node.type) };
+		for (size_t j = input_begin[i]; j < input_begin[i + 1]; j++) {
+			const InputText& input{ inputs[j] };
+			if (input.slot_index.has_value() == false) {
+				deserialize_legacy_input(result, node.id, schema.type(), input.name, input.value);
+			}
+			else {
+				deserialize_slot(result, SlotId{ node.id, *input.slot_index }, schema, input.value);
+			}
+		}
+	}
+	for (const Connection& connection : _connections) {
+		result.add_connection(connection.source(), connection.dest());
+	}
 	return result;
 }
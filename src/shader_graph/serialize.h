@@ -1,12 +1,128 @@
 #pragma once
 
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+
+#include "shader_core/vector.h"
+
+#include "graph.h"
+#include "node_id.h"
+#include "node_type.h"
+#include "slot.h"
+#include "slot_id.h"
 
 namespace csg {
-	class Graph;
+	class Node;
+	class NodeSchema;
 
 	std::string serialize_graph(const Graph& graph);
-	boost::optional<Graph> deserialize_graph(const std::string& graph_string);
+	boost::optional<Graph> deserialize_graph(boost::string_view graph_string);
+
+	// Streaming variants of the text format, only a fixed-size buffer and the largest single token are held in memory
+	// besides the graph itself
+	bool serialize_graph(const Graph& graph, std::ostream& output);
+	boost::optional<Graph> deserialize_graph(std::istream& input);
+
+	// Same result as deserialize_graph, with the node section split between up to thread_count threads
+	// Small graphs are read on the calling thread alone, worker threads are joined before this returns
+	boost::optional<Graph> deserialize_graph(boost::string_view graph_string, size_t thread_count);
+
+	/**
+	 * @brief Keeps the text of each node between calls so only nodes that changed are formatted again.
+	 *
+	 * Output is identical to serialize_graph. Each cached node is kept alive by the cache, which makes the graph
+	 * copy that node the next time it is edited.
+	 */
+	class SerializeCache {
+	public:
+		std::string serialize(const Graph& graph);
+		void clear();
+
+	private:
+		struct NodeFragment {
+			NodeId id;
+			std::shared_ptr<const Node> node;
+			const NodeSchema* schema;
+			std::string text;
+		};
+
+		// Sorted by id, the order serialize_graph writes nodes in
+		std::vector<NodeFragment> fragments;
+	};
+
+	/**
+	 * @brief A text graph that has been indexed but not fully parsed.
+	 *
+	 * Loading records the type, id and position of each node, the connections, and where the text of each input is.
+	 * Slot values are parsed from that text the first time they are read and kept for later reads. The text must outlive
+	 * the LazyGraph, and as reading a value may parse it, a LazyGraph must not be read from more than one thread at once.
+	 */
+	class LazyGraph {
+	public:
+		struct NodeInfo {
+			NodeId id;
+			NodeType type;
+			csc::Int2 position;
+		};
+
+		// Returns none for any text deserialize_graph would reject
+		static boost::optional<LazyGraph> from(boost::string_view graph_string);
+
+		// In the order they appear in the text, which is from the bottom of the draw order to the top
+		const std::vector<NodeInfo>& nodes() const { return _nodes; }
+		boost::optional<size_t> find(NodeId id) const;
+		// Sorted by Connection::operator<
+		const std::vector<Connection>& connections() const { return _connections; }
+
+		// Returns nullptr if the slot does not exist or does not have a value
+		// The pointer is valid for as long as this LazyGraph
+		const SlotValue* get_slot_value_ptr(SlotId slot_id) const;
+		template <typename T> const T* get_slot_value_as_ptr(SlotId slot_id) const
+		{
+			const SlotValue* const value_ptr{ get_slot_value_ptr(slot_id) };
+			return value_ptr ? value_ptr->as_ptr<T>() : nullptr;
+		}
+
+		// Parses every value, the result is the graph deserialize_graph returns for the same text
+		Graph to_graph() const;
+
+	private:
+		struct InputText {
+			boost::string_view name;
+			boost::string_view value;
+			// None for names only old files use, which may still set a slot
+			boost::optional<size_t> slot_index;
+		};
+
+		std::vector<NodeInfo> _nodes;
+		// The inputs of node i are inputs[input_begin[i]] up to inputs[input_begin[i + 1]]
+		std::vector<size_t> input_begin;
+		std::vector<InputText> inputs;
+		std::unordered_map<NodeId, size_t> index_by_id;
+		std::vector<Connection> _connections;
+		// Values parsed so far, a slot that no input sets uses the schema default and is never added
+		mutable std::unordered_map<SlotId, SlotValue> parsed_values;
+	};
+
+	// Compact binary encoding of the same content, floats are stored exactly rather than rounded
+	std::string serialize_graph_binary(const Graph& graph);
+	boost::optional<Graph> deserialize_graph_binary(boost::string_view graph_string);
+	// Checks only the header, a graph that passes may still fail to deserialize
+	bool is_binary_graph(boost::string_view graph_string);
+	// Checks only the next byte without consuming it, the full header is checked when deserializing
+	bool is_binary_graph(std::istream& input);
+
+	// Binary patch describing the nodes, slot values and connections that differ between a and b, nodes are matched by id
+	// Draw order is not part of a patch
+	std::string diff(const Graph& a, const Graph& b);
+	// Turns a graph equal to the a given to diff into one equal to b
+	// Returns false and leaves the graph unchanged if the patch is malformed or does not fit the graph
+	bool apply_patch(Graph& graph, boost::string_view patch);
 }
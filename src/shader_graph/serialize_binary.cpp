@@ -0,0 +1,991 @@
+#include "serialize.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include "shader_core/rect.h"
+#include "shader_core/vector.h"
+
+#include "curves.h"
+#include "graph.h"
+#include "node.h"
+#include "node_enums.h"
+#include "node_id.h"
+#include "node_schema.h"
+#include "node_type.h"
+#include "ramp.h"
+#include "slot.h"
+#include "slot_id.h"
+
+// Layout of the binary format, all multi-byte values are little-endian:
+//   magic "\x89CSG", varint format version
+//   string table: varint count, then each string as a varint length followed by its bytes
+//   nodes: varint count, then for each node
+//     varint type name string, varint zigzag id delta from the previous node, varint zigzag x and y
+//     varint value count, then for each value a varint slot name string, a value tag byte, and the value
+//   connections: varint count, then for each connection
+//     varint source node index, varint source slot display name string, varint dest node index, varint dest slot display name string
+// Nodes are written sorted by id so the id deltas stay positive, connections refer to nodes by their position in the node list
+// Values carry a tag so a reader can skip values whose slot has changed type or no longer exists
+
+static const char BINARY_MAGIC[]{ '\x89', 'C', 'S', 'G' };
+static const uint64_t BINARY_VERSION{ 1 };
+
+// Patches share the string table and value encoding, with the body:
+//   removed connections: varint count, then for each the varint dest node id and varint dest slot display name string
+//   removed nodes: varint count, then each varint node id
+//   added nodes: varint count, then each node as in a graph but with its full varint id rather than a delta
+//   changed nodes: varint count, then for each
+//     varint node id, a flags byte, varint zigzag x and y only if PATCH_NODE_MOVED is set, then values as in a graph
+//   added connections: varint count, then for each
+//     varint source node id, varint source slot display name string, varint dest node id, varint dest slot display name string
+// Node ids are written as their unsigned bit pattern, changed nodes only list values that differ
+static const char PATCH_MAGIC[]{ '\x89', 'C', 'S', 'P' };
+static const uint64_t PATCH_VERSION{ 1 };
+static const uint8_t PATCH_NODE_MOVED{ 1 };
+
+enum class BinaryValueTag : uint8_t {
+	BOOL = 1,
+	COLOR = 2,
+	ENUM = 3,
+	FLOAT = 4,
+	INT = 5,
+	VECTOR = 6,
+	CURVE_RGB = 7,
+	CURVE_VECTOR = 8,
+	COLOR_RAMP = 9,
+};
+
+struct StringViewHash {
+	size_t operator()(const boost::string_view view) const { return boost::hash_range(view.begin(), view.end()); }
+};
+
+static uint64_t zigzag_encode(const int64_t value)
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t zigzag_decode(const uint64_t value)
+{
+	return static_cast<int64_t>((value >> 1) ^ (0 - (value & 1)));
+}
+
+// Builds the body of a binary graph, strings are collected into a table that is written ahead of the body
+class BinaryWriter {
+public:
+	void write_u8(const uint8_t value) { body += static_cast<char>(value); }
+
+	void write_varint(uint64_t value)
+	{
+		while (value >= 0x80) {
+			body += static_cast<char>((value & 0x7f) | 0x80);
+			value >>= 7;
+		}
+		body += static_cast<char>(value);
+	}
+
+	void write_i32(const int32_t value)
+	{
+		const uint32_t bits{ static_cast<uint32_t>(value) };
+		for (size_t i = 0; i < sizeof(bits); i++) {
+			body += static_cast<char>((bits >> (i * 8)) & 0xff);
+		}
+	}
+
+	void write_f32(const float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		write_i32(static_cast<int32_t>(bits));
+	}
+
+	void write_float2(const csc::Float2 value)
+	{
+		write_f32(value.x);
+		write_f32(value.y);
+	}
+
+	void write_float3(const csc::Float3 value)
+	{
+		write_f32(value.x);
+		write_f32(value.y);
+		write_f32(value.z);
+	}
+
+	// Only for strings with static storage, the same few names are written many times so they are first looked up by address
+	void write_string(const char* const value)
+	{
+		const auto pointer_iter{ indices_by_pointer.find(value) };
+		if (pointer_iter != indices_by_pointer.end()) {
+			write_varint(pointer_iter->second);
+			return;
+		}
+		const auto inserted{ indices_by_string.emplace(boost::string_view{ value }, strings.size()) };
+		if (inserted.second) {
+			strings.push_back(value);
+		}
+		indices_by_pointer.emplace(value, inserted.first->second);
+		write_varint(inserted.first->second);
+	}
+
+	// Magic is always four bytes
+	std::string finish(const char* const magic, const uint64_t version)
+	{
+		BinaryWriter header;
+		header.body.append(magic, sizeof(BINARY_MAGIC));
+		header.write_varint(version);
+		header.write_varint(strings.size());
+		for (const boost::string_view this_string : strings) {
+			header.write_varint(this_string.size());
+			header.body.append(this_string.data(), this_string.size());
+		}
+		header.body.reserve(header.body.size() + body.size());
+		header.body += body;
+		return std::move(header.body);
+	}
+
+	std::string body;
+
+private:
+	std::vector<boost::string_view> strings;
+	std::unordered_map<const char*, size_t> indices_by_pointer;
+	// Different names may share text, this keeps each string in the table once
+	std::unordered_map<boost::string_view, size_t, StringViewHash> indices_by_string;
+};
+
+// Reads values from a binary graph, any read past the end of input marks the reader as failed and returns zero
+class BinaryReader {
+public:
+	BinaryReader(const boost::string_view input) : remaining{ input } {}
+
+	bool failed() const { return _failed; }
+
+	void fail()
+	{
+		_failed = true;
+		remaining = boost::string_view{};
+	}
+
+	uint8_t read_u8()
+	{
+		if (remaining.empty()) {
+			fail();
+			return 0;
+		}
+		const uint8_t result{ static_cast<uint8_t>(remaining[0]) };
+		remaining.remove_prefix(1);
+		return result;
+	}
+
+	uint64_t read_varint()
+	{
+		uint64_t result{ 0 };
+		for (unsigned int shift = 0; shift < 64; shift += 7) {
+			const uint8_t this_byte{ read_u8() };
+			result |= static_cast<uint64_t>(this_byte & 0x7f) << shift;
+			if ((this_byte & 0x80) == 0) {
+				return result;
+			}
+		}
+		// Longer than any 64 bit value can be
+		fail();
+		return 0;
+	}
+
+	// Reads a count of items that each take at least min_item_size bytes, fails if the input is too short to hold them
+	size_t read_count(const size_t min_item_size)
+	{
+		const uint64_t count{ read_varint() };
+		if (count > remaining.size() / min_item_size) {
+			fail();
+			return 0;
+		}
+		return static_cast<size_t>(count);
+	}
+
+	int32_t read_i32()
+	{
+		if (remaining.size() < sizeof(uint32_t)) {
+			fail();
+			return 0;
+		}
+		uint32_t bits{ 0 };
+		for (size_t i = 0; i < sizeof(bits); i++) {
+			bits |= static_cast<uint32_t>(static_cast<uint8_t>(remaining[i])) << (i * 8);
+		}
+		remaining.remove_prefix(sizeof(bits));
+		return static_cast<int32_t>(bits);
+	}
+
+	float read_f32()
+	{
+		const uint32_t bits{ static_cast<uint32_t>(read_i32()) };
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	csc::Float2 read_float2()
+	{
+		const float x{ read_f32() };
+		const float y{ read_f32() };
+		return csc::Float2{ x, y };
+	}
+
+	csc::Float3 read_float3()
+	{
+		const float x{ read_f32() };
+		const float y{ read_f32() };
+		const float z{ read_f32() };
+		return csc::Float3{ x, y, z };
+	}
+
+	boost::string_view read_bytes(const size_t size)
+	{
+		if (remaining.size() < size) {
+			fail();
+			return boost::string_view{};
+		}
+		const boost::string_view result{ remaining.substr(0, size) };
+		remaining.remove_prefix(size);
+		return result;
+	}
+
+	// Index into the string table, fails if the index is out of range
+	size_t read_string_index(const size_t table_size)
+	{
+		const uint64_t index{ read_varint() };
+		if (index >= table_size) {
+			fail();
+			return 0;
+		}
+		return static_cast<size_t>(index);
+	}
+
+	boost::string_view read_string(const std::vector<boost::string_view>& table)
+	{
+		const size_t index{ read_string_index(table.size()) };
+		return failed() ? boost::string_view{} : table[index];
+	}
+
+private:
+	boost::string_view remaining;
+	bool _failed{ false };
+};
+
+static void write_curve(BinaryWriter& writer, const csg::Curve& curve)
+{
+	writer.write_varint(curve.control_points().size());
+	for (const csg::CurvePoint& this_point : curve.control_points()) {
+		writer.write_float2(this_point.pos);
+		writer.write_u8(this_point.interp == csg::CurveInterp::LINEAR ? 1 : 0);
+	}
+}
+
+static void write_slot_value(BinaryWriter& writer, const csg::SlotValue& slot_value)
+{
+	if (const csg::BoolSlotValue* const bool_ptr{ slot_value.as_ptr<csg::BoolSlotValue>() }) {
+		writer.write_u8(static_cast<uint8_t>(BinaryValueTag::BOOL));
+		writer.write_u8(bool_ptr->get() ? 1 : 0);
+	}
+	else if (const csg::ColorSlotValue* const color_ptr{ slot_value.as_ptr<csg::ColorSlotValue>() }) {
+		writer.write_u8(static_cast<uint8_t>(BinaryValueTag::COLOR));
+		writer.write_float3(color_ptr->get());
+	}
+	else if (const csg::EnumSlotValue* const enum_ptr{ slot_value.as_ptr<csg::EnumSlotValue>() }) {
+		// Enums are stored by name like the text format so reordering an enum does not change saved graphs
+		writer.write_u8(static_cast<uint8_t>(BinaryValueTag::ENUM));
+		writer.write_string(enum_ptr->internal_name());
+	}
+	else if (const csg::FloatSlotValue* const float_ptr{ slot_value.as_ptr<csg::FloatSlotValue>() }) {
+		writer.write_u8(static_cast<uint8_t>(BinaryValueTag::FLOAT));
+		writer.write_f32(float_ptr->get());
+	}
+	else if (const csg::IntSlotValue* const int_ptr{ slot_value.as_ptr<csg::IntSlotValue>() }) {
+		writer.write_u8(static_cast<uint8_t>(BinaryValueTag::INT));
+		writer.write_i32(int_ptr->get());
+	}
+	else if (const csg::VectorSlotValue* const vector_ptr{ slot_value.as_ptr<csg::VectorSlotValue>() }) {
+		writer.write_u8(static_cast<uint8_t>(BinaryValueTag::VECTOR));
+		writer.write_float3(vector_ptr->get());
+	}
+	else if (const csg::RGBCurveSlotValue* const rgb_ptr{ slot_value.as_ptr<csg::RGBCurveSlotValue>() }) {
+		writer.write_u8(static_cast<uint8_t>(BinaryValueTag::CURVE_RGB));
+		write_curve(writer, rgb_ptr->get_all());
+		write_curve(writer, rgb_ptr->get_r());
+		write_curve(writer, rgb_ptr->get_g());
+		write_curve(writer, rgb_ptr->get_b());
+	}
+	else if (const csg::VectorCurveSlotValue* const vec_curve_ptr{ slot_value.as_ptr<csg::VectorCurveSlotValue>() }) {
+		writer.write_u8(static_cast<uint8_t>(BinaryValueTag::CURVE_VECTOR));
+		writer.write_float2(vec_curve_ptr->get_min());
+		writer.write_float2(vec_curve_ptr->get_max());
+		write_curve(writer, vec_curve_ptr->get_x());
+		write_curve(writer, vec_curve_ptr->get_y());
+		write_curve(writer, vec_curve_ptr->get_z());
+	}
+	else if (const csg::ColorRampSlotValue* const ramp_ptr{ slot_value.as_ptr<csg::ColorRampSlotValue>() }) {
+		writer.write_u8(static_cast<uint8_t>(BinaryValueTag::COLOR_RAMP));
+		const csg::ColorRamp& ramp{ ramp_ptr->get() };
+		writer.write_varint(ramp.size());
+		for (size_t i = 0; i < ramp.size(); i++) {
+			const csg::ColorRampPoint this_point{ ramp.get(i) };
+			writer.write_f32(this_point.pos);
+			writer.write_float3(this_point.color);
+			writer.write_f32(this_point.alpha);
+		}
+	}
+	else {
+		assert(false);
+	}
+}
+
+// Writes the input values of node, if base is set only values that differ from base are written
+static void write_node_values(BinaryWriter& writer, const csg::Node& node, const csg::Node* const base)
+{
+	using namespace csg;
+
+	const auto should_write = [&node, base](const size_t index) {
+		const SlotValue* const slot_value{ node.slot_value_ptr(index) };
+		if (node.schema().slots()[index].dir() != SlotDirection::INPUT || slot_value == nullptr) {
+			return false;
+		}
+		const SlotValue* const base_value{ base ? base->slot_value_ptr(index) : nullptr };
+		return base_value == nullptr || *base_value != *slot_value;
+	};
+
+	const std::vector<Slot>& slots{ node.schema().slots() };
+	size_t value_count{ 0 };
+	for (size_t i = 0; i < slots.size(); i++) {
+		if (should_write(i)) {
+			value_count++;
+		}
+	}
+	writer.write_varint(value_count);
+	for (size_t i = 0; i < slots.size(); i++) {
+		if (should_write(i)) {
+			writer.write_string(slots[i].name());
+			write_slot_value(writer, *node.slot_value_ptr(i));
+		}
+	}
+}
+
+std::string csg::serialize_graph_binary(const Graph& graph)
+{
+	std::vector<const Node*> nodes;
+	nodes.reserve(graph.nodes().size());
+	for (const auto& node : graph.nodes()) {
+		nodes.push_back(node.get());
+	}
+	std::sort(nodes.begin(), nodes.end(),
+		[](const Node* const a, const Node* const b) {
+			return a->id() < b->id();
+		}
+	);
+
+	const auto& graph_connections = graph.connections();
+	std::vector<Connection> connections{ graph_connections.begin(), graph_connections.end() };
+	std::sort(connections.begin(), connections.end());
+
+	// Rough size of a typical node, most values are a few bytes each
+	constexpr size_t RESERVE_PER_NODE{ 48 };
+	BinaryWriter writer;
+	writer.body.reserve(nodes.size() * RESERVE_PER_NODE);
+
+	writer.write_varint(nodes.size());
+	NodeId previous_id{ 0 };
+	for (const Node* const node : nodes) {
+		const boost::optional<NodeTypeInfo> info{ NodeTypeInfo::from(node->type()) };
+		assert(info.has_value());
+		writer.write_string(info->name());
+		writer.write_varint(zigzag_encode(static_cast<int64_t>(static_cast<uint64_t>(node->id()) - static_cast<uint64_t>(previous_id))));
+		previous_id = node->id();
+		writer.write_varint(zigzag_encode(node->position.x));
+		writer.write_varint(zigzag_encode(node->position.y));
+
+		write_node_values(writer, *node, nullptr);
+	}
+
+	const auto find_node_index = [&nodes](const NodeId id) -> boost::optional<size_t> {
+		const auto iter{ std::lower_bound(nodes.begin(), nodes.end(), id,
+			[](const Node* const node, const NodeId id) {
+				return node->id() < id;
+			}
+		) };
+		if (iter != nodes.end() && (*iter)->id() == id) {
+			return static_cast<size_t>(iter - nodes.begin());
+		}
+		return boost::none;
+	};
+
+	// Count first, connections to missing nodes or slots are dropped the same way the text format drops them
+	std::vector<std::pair<size_t, size_t>> connection_nodes;
+	std::vector<std::pair<const Slot*, const Slot*>> connection_slots;
+	connection_nodes.reserve(connections.size());
+	connection_slots.reserve(connections.size());
+	for (const Connection& connection : connections) {
+		const boost::optional<size_t> index_src{ find_node_index(connection.source().node_id()) };
+		const boost::optional<size_t> index_dest{ find_node_index(connection.dest().node_id()) };
+		if (index_src.has_value() == false || index_dest.has_value() == false) {
+			continue;
+		}
+		const Slot* const slot_src{ nodes[*index_src]->slot(connection.source().index()) };
+		const Slot* const slot_dest{ nodes[*index_dest]->slot(connection.dest().index()) };
+		if (slot_src == nullptr || slot_dest == nullptr) {
+			continue;
+		}
+		connection_nodes.push_back(std::make_pair(*index_src, *index_dest));
+		connection_slots.push_back(std::make_pair(slot_src, slot_dest));
+	}
+	writer.write_varint(connection_nodes.size());
+	for (size_t i = 0; i < connection_nodes.size(); i++) {
+		writer.write_varint(connection_nodes[i].first);
+		writer.write_string(connection_slots[i].first->disp_name());
+		writer.write_varint(connection_nodes[i].second);
+		writer.write_string(connection_slots[i].second->disp_name());
+	}
+
+	return writer.finish(BINARY_MAGIC, BINARY_VERSION);
+}
+
+bool csg::is_binary_graph(const boost::string_view graph_string)
+{
+	return graph_string.size() >= sizeof(BINARY_MAGIC) && std::memcmp(graph_string.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+}
+
+bool csg::is_binary_graph(std::istream& input)
+{
+	// The text format always begins with printable characters, so the first byte is enough to tell them apart
+	return input.peek() == std::char_traits<char>::to_int_type(BINARY_MAGIC[0]);
+}
+
+static boost::optional<csg::Curve> read_curve(BinaryReader& reader, const csc::Float2 min, const csc::Float2 max)
+{
+	constexpr size_t POINT_SIZE{ 9 };
+	const size_t point_count{ reader.read_count(POINT_SIZE) };
+	std::vector<csg::CurvePoint> points;
+	points.reserve(point_count);
+	bool valid{ point_count >= 2 };
+	const csc::FloatRect bounds{ min, max };
+	for (size_t i = 0; i < point_count; i++) {
+		const csc::Float2 pos{ reader.read_float2() };
+		const csg::CurveInterp interp{ reader.read_u8() == 1 ? csg::CurveInterp::LINEAR : csg::CurveInterp::CUBIC_HERMITE };
+		valid = valid && bounds.contains(pos);
+		points.push_back(csg::CurvePoint{ pos, interp });
+	}
+	if (valid == false || reader.failed()) {
+		return boost::none;
+	}
+	return csg::Curve{ min, max, points };
+}
+
+// Reads one tagged value and sets it on the graph if the slot exists and has a matching type
+// The whole value is always read so the reader stays in position even when the value is discarded
+static void read_slot_value(BinaryReader& reader, csg::Graph& graph, const boost::optional<csg::SlotId> slot_id, const boost::optional<csg::SlotType> slot_type, const std::vector<boost::string_view>& strings)
+{
+	using namespace csg;
+
+	const BinaryValueTag tag{ static_cast<BinaryValueTag>(reader.read_u8()) };
+	const auto matches = [&](const SlotType type) {
+		return reader.failed() == false && slot_id.has_value() && slot_type == type;
+	};
+
+	switch (tag) {
+	case BinaryValueTag::BOOL:
+	{
+		const bool value{ reader.read_u8() != 0 };
+		if (matches(SlotType::BOOL)) {
+			graph.set_bool(*slot_id, value);
+		}
+		break;
+	}
+	case BinaryValueTag::COLOR:
+	{
+		const csc::Float3 value{ reader.read_float3() };
+		if (matches(SlotType::COLOR)) {
+			graph.set_color(*slot_id, value);
+		}
+		break;
+	}
+	case BinaryValueTag::ENUM:
+	{
+		const boost::string_view name{ reader.read_string(strings) };
+		if (matches(SlotType::ENUM)) {
+			const EnumSlotValue* const slot_value{ graph.get_slot_value_as_ptr<EnumSlotValue>(*slot_id) };
+			if (slot_value) {
+				const NodeMetaEnum meta_enum{ slot_value->get_meta() };
+				assert(NodeEnumInfo::from(meta_enum).has_value());
+				const NodeEnumInfo enum_info{ NodeEnumInfo::from(meta_enum).value() };
+				for (size_t i = 0; i < enum_info.count(); i++) {
+					assert(NodeEnumOptionInfo::from(meta_enum, i).has_value());
+					if (name == NodeEnumOptionInfo::from(meta_enum, i)->internal_name()) {
+						graph.set_enum(*slot_id, i);
+						break;
+					}
+				}
+			}
+		}
+		break;
+	}
+	case BinaryValueTag::FLOAT:
+	{
+		const float value{ reader.read_f32() };
+		if (matches(SlotType::FLOAT)) {
+			graph.set_float(*slot_id, value);
+		}
+		break;
+	}
+	case BinaryValueTag::INT:
+	{
+		const int value{ reader.read_i32() };
+		if (matches(SlotType::INT)) {
+			graph.set_int(*slot_id, value);
+		}
+		break;
+	}
+	case BinaryValueTag::VECTOR:
+	{
+		const csc::Float3 value{ reader.read_float3() };
+		if (matches(SlotType::VECTOR)) {
+			graph.set_vector(*slot_id, value);
+		}
+		break;
+	}
+	case BinaryValueTag::CURVE_RGB:
+	{
+		const csc::Float2 min{ 0.0f, 0.0f };
+		const csc::Float2 max{ 1.0f, 1.0f };
+		const boost::optional<Curve> opt_all{ read_curve(reader, min, max) };
+		const boost::optional<Curve> opt_r{ read_curve(reader, min, max) };
+		const boost::optional<Curve> opt_g{ read_curve(reader, min, max) };
+		const boost::optional<Curve> opt_b{ read_curve(reader, min, max) };
+		if (matches(SlotType::CURVE_RGB)) {
+			RGBCurveSlotValue value{};
+			if (opt_all) {
+				value.set_all(*opt_all);
+			}
+			if (opt_r) {
+				value.set_r(*opt_r);
+			}
+			if (opt_g) {
+				value.set_g(*opt_g);
+			}
+			if (opt_b) {
+				value.set_b(*opt_b);
+			}
+			graph.set_curve_rgb(*slot_id, std::move(value));
+		}
+		break;
+	}
+	case BinaryValueTag::CURVE_VECTOR:
+	{
+		const csc::Float2 min{ reader.read_float2() };
+		const csc::Float2 max{ reader.read_float2() };
+		// Curves are still read with invalid bounds to stay in position, but are discarded afterward
+		const bool valid_bounds{ min.x < max.x && min.y < max.y };
+		const boost::optional<Curve> opt_x{ read_curve(reader, min, max) };
+		const boost::optional<Curve> opt_y{ read_curve(reader, min, max) };
+		const boost::optional<Curve> opt_z{ read_curve(reader, min, max) };
+		if (matches(SlotType::CURVE_VECTOR) && valid_bounds) {
+			VectorCurveSlotValue value{ min, max };
+			if (opt_x) {
+				value.set_x(*opt_x);
+			}
+			if (opt_y) {
+				value.set_y(*opt_y);
+			}
+			if (opt_z) {
+				value.set_z(*opt_z);
+			}
+			graph.set_curve_vec(*slot_id, std::move(value));
+		}
+		break;
+	}
+	case BinaryValueTag::COLOR_RAMP:
+	{
+		constexpr size_t POINT_SIZE{ 20 };
+		const size_t point_count{ reader.read_count(POINT_SIZE) };
+		std::vector<ColorRampPoint> points;
+		points.reserve(point_count);
+		for (size_t i = 0; i < point_count; i++) {
+			const float pos{ reader.read_f32() };
+			const csc::Float3 color{ reader.read_float3() };
+			const float alpha{ reader.read_f32() };
+			points.push_back(ColorRampPoint{ pos, color, alpha });
+		}
+		if (matches(SlotType::COLOR_RAMP) && points.size() >= 2) {
+			graph.set_color_ramp(*slot_id, ColorRamp{ std::move(points) });
+		}
+		break;
+	}
+	default:
+		// Values are not length-prefixed, so an unknown tag means the rest of the input cannot be read
+		reader.fail();
+		break;
+	}
+}
+
+// Reads the string table that follows the header, strings are views into the input
+static std::vector<boost::string_view> read_string_table(BinaryReader& reader)
+{
+	const size_t string_count{ reader.read_count(1) };
+	std::vector<boost::string_view> result;
+	result.reserve(string_count);
+	for (size_t i = 0; i < string_count; i++) {
+		const size_t string_size{ reader.read_count(1) };
+		result.push_back(reader.read_bytes(string_size));
+	}
+	return result;
+}
+
+// Reads the values written by write_node_values, values are dropped if type is none or the slot does not exist
+static void read_node_values(BinaryReader& reader, csg::Graph& graph, const csg::NodeId id, const boost::optional<csg::NodeType> type, const std::vector<boost::string_view>& strings)
+{
+	using namespace csg;
+
+	constexpr size_t MIN_VALUE_SIZE{ 2 };
+	const size_t value_count{ reader.read_count(MIN_VALUE_SIZE) };
+	for (size_t i = 0; i < value_count && reader.failed() == false; i++) {
+		const boost::string_view slot_name{ reader.read_string(strings) };
+		boost::optional<SlotId> slot_id;
+		boost::optional<SlotType> slot_type;
+		if (type.has_value()) {
+			const NodeSchema& schema{ NodeSchema::from(*type) };
+			const boost::optional<size_t> slot_index{ schema.slot_index(SlotDirection::INPUT, slot_name) };
+			if (slot_index.has_value() && schema.value_index(*slot_index).has_value()) {
+				slot_id = SlotId{ id, *slot_index };
+				slot_type = schema.slots()[*slot_index].type();
+			}
+		}
+		read_slot_value(reader, graph, slot_id, slot_type, strings);
+	}
+}
+
+// Slots in connections are stored by display name, the node must exist in the graph
+static boost::optional<size_t> find_slot(const csg::Graph& graph, const csg::NodeId id, const csg::SlotDirection dir, const boost::string_view disp_name)
+{
+	const std::vector<csg::Slot>& slots{ graph.get(id)->schema().slots() };
+	for (size_t slot_index = 0; slot_index < slots.size(); slot_index++) {
+		if (slots[slot_index].dir() == dir && disp_name == slots[slot_index].disp_name()) {
+			return slot_index;
+		}
+	}
+	return boost::none;
+}
+
+boost::optional<csg::Graph> csg::deserialize_graph_binary(const boost::string_view graph_string)
+{
+	if (is_binary_graph(graph_string) == false) {
+		return boost::none;
+	}
+
+	BinaryReader reader{ graph_string.substr(sizeof(BINARY_MAGIC)) };
+	if (reader.read_varint() != BINARY_VERSION || reader.failed()) {
+		return boost::none;
+	}
+
+	// Views into the input, type names are looked up once per table entry rather than once per node
+	const std::vector<boost::string_view> strings{ read_string_table(reader) };
+	if (reader.failed()) {
+		return boost::none;
+	}
+	std::vector<boost::optional<NodeType>> types_by_string(strings.size());
+	std::vector<bool> types_looked_up(strings.size(), false);
+
+	Graph result{ GraphType::EMPTY };
+
+	// Nodes with an unrecognized type are skipped, connections to them are dropped
+	constexpr size_t MIN_NODE_SIZE{ 5 };
+	const size_t node_count{ reader.read_count(MIN_NODE_SIZE) };
+	std::vector<boost::optional<NodeId>> node_ids;
+	node_ids.reserve(node_count);
+	uint64_t previous_id{ 0 };
+	for (size_t i = 0; i < node_count; i++) {
+		const size_t type_index{ reader.read_string_index(strings.size()) };
+		previous_id += static_cast<uint64_t>(zigzag_decode(reader.read_varint()));
+		const NodeId id{ static_cast<NodeId>(previous_id) };
+		const int x{ static_cast<int>(zigzag_decode(reader.read_varint())) };
+		const int y{ static_cast<int>(zigzag_decode(reader.read_varint())) };
+		if (reader.failed()) {
+			return boost::none;
+		}
+
+		if (types_looked_up[type_index] == false) {
+			const boost::optional<NodeTypeInfo> info{ NodeTypeInfo::from(strings[type_index]) };
+			if (info.has_value()) {
+				types_by_string[type_index] = info->type();
+			}
+			types_looked_up[type_index] = true;
+		}
+		const boost::optional<NodeType> opt_type{ types_by_string[type_index] };
+		if (opt_type.has_value()) {
+			if (result.add(*opt_type, csc::Int2{ x, y }, id) == false) {
+				// Duplicate id, only possible in a malformed graph
+				return boost::none;
+			}
+			node_ids.push_back(id);
+		}
+		else {
+			node_ids.push_back(boost::none);
+		}
+
+		read_node_values(reader, result, id, opt_type, strings);
+		if (reader.failed()) {
+			return boost::none;
+		}
+	}
+
+	constexpr size_t MIN_CONNECTION_SIZE{ 4 };
+	const size_t connection_count{ reader.read_count(MIN_CONNECTION_SIZE) };
+	for (size_t i = 0; i < connection_count; i++) {
+		const uint64_t index_src{ reader.read_varint() };
+		const boost::string_view slot_src{ reader.read_string(strings) };
+		const uint64_t index_dest{ reader.read_varint() };
+		const boost::string_view slot_dest{ reader.read_string(strings) };
+		if (reader.failed()) {
+			return boost::none;
+		}
+		if (index_src >= node_ids.size() || index_dest >= node_ids.size()) {
+			return boost::none;
+		}
+		const boost::optional<NodeId> id_src{ node_ids[index_src] };
+		const boost::optional<NodeId> id_dest{ node_ids[index_dest] };
+		if (id_src.has_value() == false || id_dest.has_value() == false) {
+			continue;
+		}
+		const boost::optional<size_t> slot_index_src{ find_slot(result, *id_src, SlotDirection::OUTPUT, slot_src) };
+		const boost::optional<size_t> slot_index_dest{ find_slot(result, *id_dest, SlotDirection::INPUT, slot_dest) };
+		if (slot_index_src.has_value() && slot_index_dest.has_value()) {
+			result.add_connection(SlotId{ *id_src, *slot_index_src }, SlotId{ *id_dest, *slot_index_dest });
+		}
+	}
+	if (reader.failed()) {
+		return boost::none;
+	}
+
+	return result;
+}
+
+std::string csg::diff(const Graph& a, const Graph& b)
+{
+	BinaryWriter writer;
+
+	const auto& connections_a_range = a.connections();
+	const auto& connections_b_range = b.connections();
+	std::vector<Connection> connections_a{ connections_a_range.begin(), connections_a_range.end() };
+	std::vector<Connection> connections_b{ connections_b_range.begin(), connections_b_range.end() };
+	std::sort(connections_a.begin(), connections_a.end());
+	std::sort(connections_b.begin(), connections_b.end());
+	std::vector<Connection> removed_connections;
+	std::vector<Connection> added_connections;
+	std::set_difference(connections_a.begin(), connections_a.end(), connections_b.begin(), connections_b.end(), std::back_inserter(removed_connections));
+	std::set_difference(connections_b.begin(), connections_b.end(), connections_a.begin(), connections_a.end(), std::back_inserter(added_connections));
+
+	// Nodes whose type changed under the same id are replaced rather than changed
+	std::vector<NodeId> removed_nodes;
+	for (const auto& node_a : a.nodes()) {
+		const std::shared_ptr<const Node> node_b{ b.get(node_a->id()) };
+		if (node_b.use_count() == 0 || node_b->type() != node_a->type()) {
+			removed_nodes.push_back(node_a->id());
+		}
+	}
+	std::vector<const Node*> added_nodes;
+	std::vector<std::pair<const Node*, const Node*>> changed_nodes;
+	std::set<NodeId> replaced_nodes;
+	for (const auto& node_b : b.nodes()) {
+		const std::shared_ptr<const Node> node_a{ a.get(node_b->id()) };
+		if (node_a.use_count() == 0 || node_a->type() != node_b->type()) {
+			added_nodes.push_back(node_b.get());
+			if (node_a.use_count() > 0) {
+				replaced_nodes.insert(node_b->id());
+			}
+		}
+		else if (node_a != node_b && *node_a != *node_b) {
+			// Graphs copied from each other share unchanged nodes, so most nodes are skipped by the pointer check
+			changed_nodes.push_back(std::make_pair(node_a.get(), node_b.get()));
+		}
+	}
+
+	// Removing a replaced node also removes connections that both graphs share, so those have to be added again
+	if (replaced_nodes.empty() == false) {
+		for (const Connection& connection : connections_b) {
+			const bool touches_replaced{ replaced_nodes.count(connection.source().node_id()) > 0 || replaced_nodes.count(connection.dest().node_id()) > 0 };
+			if (touches_replaced && std::binary_search(connections_a.begin(), connections_a.end(), connection)) {
+				added_connections.push_back(connection);
+			}
+		}
+	}
+
+	const auto write_id = [&writer](const NodeId id) {
+		writer.write_varint(static_cast<uint64_t>(id));
+	};
+	const auto write_slot_name = [&writer](const Graph& graph, const SlotId slot_id) {
+		writer.write_string(graph.get(slot_id.node_id())->slot(slot_id.index())->disp_name());
+	};
+
+	writer.write_varint(removed_connections.size());
+	for (const Connection& connection : removed_connections) {
+		write_id(connection.dest().node_id());
+		write_slot_name(a, connection.dest());
+	}
+
+	writer.write_varint(removed_nodes.size());
+	for (const NodeId id : removed_nodes) {
+		write_id(id);
+	}
+
+	writer.write_varint(added_nodes.size());
+	for (const Node* const node : added_nodes) {
+		const boost::optional<NodeTypeInfo> info{ NodeTypeInfo::from(node->type()) };
+		assert(info.has_value());
+		writer.write_string(info->name());
+		write_id(node->id());
+		writer.write_varint(zigzag_encode(node->position.x));
+		writer.write_varint(zigzag_encode(node->position.y));
+		write_node_values(writer, *node, nullptr);
+	}
+
+	writer.write_varint(changed_nodes.size());
+	for (const auto& node_pair : changed_nodes) {
+		const Node& node_a{ *node_pair.first };
+		const Node& node_b{ *node_pair.second };
+		write_id(node_b.id());
+		const bool moved{ node_a.position != node_b.position };
+		writer.write_u8(moved ? PATCH_NODE_MOVED : 0);
+		if (moved) {
+			writer.write_varint(zigzag_encode(node_b.position.x));
+			writer.write_varint(zigzag_encode(node_b.position.y));
+		}
+		write_node_values(writer, node_b, &node_a);
+	}
+
+	writer.write_varint(added_connections.size());
+	for (const Connection& connection : added_connections) {
+		write_id(connection.source().node_id());
+		write_slot_name(b, connection.source());
+		write_id(connection.dest().node_id());
+		write_slot_name(b, connection.dest());
+	}
+
+	return writer.finish(PATCH_MAGIC, PATCH_VERSION);
+}
+
+bool csg::apply_patch(Graph& graph, const boost::string_view patch)
+{
+	if (patch.size() < sizeof(PATCH_MAGIC) || std::memcmp(patch.data(), PATCH_MAGIC, sizeof(PATCH_MAGIC)) != 0) {
+		return false;
+	}
+
+	BinaryReader reader{ patch.substr(sizeof(PATCH_MAGIC)) };
+	if (reader.read_varint() != PATCH_VERSION || reader.failed()) {
+		return false;
+	}
+	const std::vector<boost::string_view> strings{ read_string_table(reader) };
+	if (reader.failed()) {
+		return false;
+	}
+
+	// Edits are made to a copy so a patch that fails partway leaves the graph untouched, the copy shares all nodes until edited
+	Graph result{ graph };
+	const auto read_id = [&reader]() {
+		return static_cast<NodeId>(reader.read_varint());
+	};
+
+	constexpr size_t MIN_REMOVED_CONNECTION_SIZE{ 2 };
+	const size_t removed_connection_count{ reader.read_count(MIN_REMOVED_CONNECTION_SIZE) };
+	for (size_t i = 0; i < removed_connection_count; i++) {
+		const NodeId id_dest{ read_id() };
+		const boost::string_view slot_dest{ reader.read_string(strings) };
+		if (reader.failed() || result.contains(id_dest) == false) {
+			return false;
+		}
+		const boost::optional<size_t> slot_index_dest{ find_slot(result, id_dest, SlotDirection::INPUT, slot_dest) };
+		if (slot_index_dest.has_value() == false || result.remove_connection(SlotId{ id_dest, *slot_index_dest }).has_value() == false) {
+			return false;
+		}
+	}
+
+	const size_t removed_node_count{ reader.read_count(1) };
+	std::set<NodeId> removed_nodes;
+	for (size_t i = 0; i < removed_node_count; i++) {
+		const NodeId id{ read_id() };
+		if (reader.failed() || result.contains(id) == false) {
+			return false;
+		}
+		removed_nodes.insert(id);
+	}
+	result.remove(removed_nodes);
+
+	constexpr size_t MIN_NODE_SIZE{ 5 };
+	const size_t added_node_count{ reader.read_count(MIN_NODE_SIZE) };
+	for (size_t i = 0; i < added_node_count; i++) {
+		const boost::string_view type_name{ reader.read_string(strings) };
+		const NodeId id{ read_id() };
+		const int x{ static_cast<int>(zigzag_decode(reader.read_varint())) };
+		const int y{ static_cast<int>(zigzag_decode(reader.read_varint())) };
+		if (reader.failed()) {
+			return false;
+		}
+		// A node type this build does not know cannot be added, so the patch cannot be applied faithfully
+		const boost::optional<NodeTypeInfo> info{ NodeTypeInfo::from(type_name) };
+		if (info.has_value() == false || result.add(info->type(), csc::Int2{ x, y }, id) == false) {
+			return false;
+		}
+		read_node_values(reader, result, id, info->type(), strings);
+	}
+
+	constexpr size_t MIN_CHANGED_NODE_SIZE{ 3 };
+	const size_t changed_node_count{ reader.read_count(MIN_CHANGED_NODE_SIZE) };
+	for (size_t i = 0; i < changed_node_count; i++) {
+		const NodeId id{ read_id() };
+		const uint8_t flags{ reader.read_u8() };
+		const std::shared_ptr<const Node> node{ result.get(id) };
+		if (reader.failed() || node.use_count() == 0) {
+			return false;
+		}
+		if (flags & PATCH_NODE_MOVED) {
+			const int x{ static_cast<int>(zigzag_decode(reader.read_varint())) };
+			const int y{ static_cast<int>(zigzag_decode(reader.read_varint())) };
+			const csc::Int2 delta{ csc::Int2{ x, y } - node->position };
+			result.move(std::set<NodeId>{ id }, csc::Float2{ delta });
+		}
+		read_node_values(reader, result, id, node->type(), strings);
+	}
+
+	constexpr size_t MIN_CONNECTION_SIZE{ 4 };
+	const size_t added_connection_count{ reader.read_count(MIN_CONNECTION_SIZE) };
+	for (size_t i = 0; i < added_connection_count; i++) {
+		const NodeId id_src{ read_id() };
+		const boost::string_view slot_src{ reader.read_string(strings) };
+		const NodeId id_dest{ read_id() };
+		const boost::string_view slot_dest{ reader.read_string(strings) };
+		if (reader.failed() || result.contains(id_src) == false || result.contains(id_dest) == false) {
+			return false;
+		}
+		const boost::optional<size_t> slot_index_src{ find_slot(result, id_src, SlotDirection::OUTPUT, slot_src) };
+		const boost::optional<size_t> slot_index_dest{ find_slot(result, id_dest, SlotDirection::INPUT, slot_dest) };
+		if (slot_index_src.has_value() == false || slot_index_dest.has_value() == false) {
+			return false;
+		}
+		result.add_connection(SlotId{ id_src, *slot_index_src }, SlotId{ id_dest, *slot_index_dest });
+	}
+
+	if (reader.failed()) {
+		return false;
+	}
+	graph = result;
+	return true;
+}
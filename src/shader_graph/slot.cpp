@@ -1,12 +1,16 @@
 #include "slot.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 
 #include <boost/algorithm/clamp.hpp>
 #include <boost/optional.hpp>
 
 #include "shader_core/config.h"
+#include "shader_core/hash.h"
 #include "shader_core/rect.h"
 #include "shader_core/vector.h"
 
@@ -19,6 +23,44 @@ static bool set_curve(csg::Curve& curve, const csg::Curve& new_value)
 	return true;
 }
 
+// Colors and vectors are evaluated this many at a time, one channel at a time so each curve runs over a plain array
+static constexpr size_t CURVE_BLOCK_SIZE{ 256 };
+
+// Runs apply_curves(channel, values, count) over each of the first three channels of four-float values
+template <typename TApply>
+static void eval_four_channels(const float* const input, float* const output, const size_t count, const TApply& apply_curves)
+{
+	std::array<float, CURVE_BLOCK_SIZE> values;
+	for (size_t begin = 0; begin < count; begin += CURVE_BLOCK_SIZE) {
+		const size_t block_count{ std::min(CURVE_BLOCK_SIZE, count - begin) };
+		const float* const block_input{ input + begin * 4 };
+		float* const block_output{ output + begin * 4 };
+		for (size_t channel = 0; channel < 3; channel++) {
+			for (size_t i = 0; i < block_count; i++) {
+				values[i] = block_input[i * 4 + channel];
+			}
+			apply_curves(channel, values.data(), block_count);
+			for (size_t i = 0; i < block_count; i++) {
+				block_output[i * 4 + channel] = values[i];
+			}
+		}
+		for (size_t i = 0; i < block_count; i++) {
+			block_output[i * 4 + 3] = block_input[i * 4 + 3];
+		}
+	}
+}
+
+static void hash_curve(csc::Hasher& hasher, const csg::Curve& curve)
+{
+	hasher.add(curve.min());
+	hasher.add(curve.max());
+	hasher.add(static_cast<uint64_t>(curve.control_points_size()));
+	for (const csg::CurvePoint& this_point : curve.control_points()) {
+		hasher.add(this_point.pos);
+		hasher.add(static_cast<int>(this_point.interp));
+	}
+}
+
 bool csg::ColorSlotValue::operator==(const ColorSlotValue& other) const
 {
 	return value.similar(other.value, FLOAT_COMPARE_DIFF);
@@ -107,6 +149,15 @@ bool csg::RGBCurveSlotValue::set_b(const Curve& value)
 	return set_curve(curve_b, value);
 }
 
+void csg::RGBCurveSlotValue::eval_many(const float* const input, float* const output, const size_t count) const
+{
+	const std::array<const Curve*, 3> channel_curves{ &curve_r, &curve_g, &curve_b };
+	eval_four_channels(input, output, count, [this, &channel_curves](const size_t channel, float* const values, const size_t value_count) {
+		curve_all.eval_many(values, values, value_count);
+		channel_curves[channel]->eval_many(values, values, value_count);
+	});
+}
+
 bool csg::RGBCurveSlotValue::operator==(const RGBCurveSlotValue& other) const
 {
 	return (
@@ -117,6 +168,14 @@ bool csg::RGBCurveSlotValue::operator==(const RGBCurveSlotValue& other) const
 		);
 }
 
+void csg::RGBCurveSlotValue::hash(csc::Hasher& hasher) const
+{
+	hash_curve(hasher, curve_all);
+	hash_curve(hasher, curve_r);
+	hash_curve(hasher, curve_g);
+	hash_curve(hasher, curve_b);
+}
+
 csg::VectorCurveSlotValue::VectorCurveSlotValue(const csc::Float2 min, const csc::Float2 max) :
 	curve_x{ min, max },
 	curve_y{ min, max },
@@ -160,6 +219,14 @@ bool csg::VectorCurveSlotValue::set_bounds(const csc::FloatRect bounds_rect)
 	}
 }
 
+void csg::VectorCurveSlotValue::eval_many(const float* const input, float* const output, const size_t count) const
+{
+	const std::array<const Curve*, 3> channel_curves{ &curve_x, &curve_y, &curve_z };
+	eval_four_channels(input, output, count, [&channel_curves](const size_t channel, float* const values, const size_t value_count) {
+		channel_curves[channel]->eval_many(values, values, value_count);
+	});
+}
+
 bool csg::VectorCurveSlotValue::operator==(const VectorCurveSlotValue& other) const
 {
 	return (
@@ -171,11 +238,30 @@ bool csg::VectorCurveSlotValue::operator==(const VectorCurveSlotValue& other) co
 	);
 }
 
+void csg::VectorCurveSlotValue::hash(csc::Hasher& hasher) const
+{
+	hash_curve(hasher, curve_x);
+	hash_curve(hasher, curve_y);
+	hash_curve(hasher, curve_z);
+	hasher.add(min);
+	hasher.add(max);
+}
+
 bool csg::ColorRampSlotValue::operator==(const ColorRampSlotValue& other) const
 {
 	return ramp.similar(other.ramp, FLOAT_COMPARE_DIFF);
 }
 
+void csg::ColorRampSlotValue::hash(csc::Hasher& hasher) const
+{
+	hasher.add(static_cast<uint64_t>(ramp.size()));
+	for (const ColorRampPoint& this_point : ramp.get()) {
+		hasher.add(this_point.pos);
+		hasher.add(this_point.color);
+		hasher.add(this_point.alpha);
+	}
+}
+
 csg::SlotValue& csg::SlotValue::operator=(const SlotValue& other)
 {
 	_type = other._type;
@@ -185,7 +271,7 @@ csg::SlotValue& csg::SlotValue::operator=(const SlotValue& other)
 		curve_rgb_value = std::make_unique<RGBCurveSlotValue>(*other.curve_rgb_value);
 	}
 	else {
-		curve_vector_value = std::unique_ptr<VectorCurveSlotValue>();
+		curve_rgb_value = std::unique_ptr<RGBCurveSlotValue>();
 	}
 
 	if (other.curve_vector_value) {
@@ -233,6 +319,104 @@ template <> boost::optional<csg::ColorRampSlotValue> csg::SlotValue::as() const
 	return (type() != SlotType::COLOR_RAMP || static_cast<bool>(color_ramp_value) == false) ? boost::none : boost::optional<csg::ColorRampSlotValue>{ *color_ramp_value };
 }
 
+template <> const csg::BoolSlotValue* csg::SlotValue::as_ptr() const {
+	return (type() != SlotType::BOOL) ? nullptr : &value_union.bool_value;
+}
+template <> const csg::ColorSlotValue* csg::SlotValue::as_ptr() const {
+	return (type() != SlotType::COLOR) ? nullptr : &value_union.color_value;
+}
+template <> const csg::EnumSlotValue* csg::SlotValue::as_ptr() const {
+	return (type() != SlotType::ENUM) ? nullptr : &value_union.enum_value;
+}
+template <> const csg::FloatSlotValue* csg::SlotValue::as_ptr() const {
+	return (type() != SlotType::FLOAT) ? nullptr : &value_union.float_value;
+}
+template <> const csg::IntSlotValue* csg::SlotValue::as_ptr() const {
+	return (type() != SlotType::INT) ? nullptr : &value_union.int_value;
+}
+template <> const csg::VectorSlotValue* csg::SlotValue::as_ptr() const {
+	return (type() != SlotType::VECTOR) ? nullptr : &value_union.vector_value;
+}
+template <> const csg::RGBCurveSlotValue* csg::SlotValue::as_ptr() const {
+	return (type() != SlotType::CURVE_RGB) ? nullptr : curve_rgb_value.get();
+}
+template <> const csg::VectorCurveSlotValue* csg::SlotValue::as_ptr() const {
+	return (type() != SlotType::CURVE_VECTOR) ? nullptr : curve_vector_value.get();
+}
+template <> const csg::ColorRampSlotValue* csg::SlotValue::as_ptr() const {
+	return (type() != SlotType::COLOR_RAMP) ? nullptr : color_ramp_value.get();
+}
+
+template <> csg::BoolSlotValue* csg::SlotValue::as_ptr() {
+	return (type() != SlotType::BOOL) ? nullptr : &value_union.bool_value;
+}
+template <> csg::ColorSlotValue* csg::SlotValue::as_ptr() {
+	return (type() != SlotType::COLOR) ? nullptr : &value_union.color_value;
+}
+template <> csg::EnumSlotValue* csg::SlotValue::as_ptr() {
+	return (type() != SlotType::ENUM) ? nullptr : &value_union.enum_value;
+}
+template <> csg::FloatSlotValue* csg::SlotValue::as_ptr() {
+	return (type() != SlotType::FLOAT) ? nullptr : &value_union.float_value;
+}
+template <> csg::IntSlotValue* csg::SlotValue::as_ptr() {
+	return (type() != SlotType::INT) ? nullptr : &value_union.int_value;
+}
+template <> csg::VectorSlotValue* csg::SlotValue::as_ptr() {
+	return (type() != SlotType::VECTOR) ? nullptr : &value_union.vector_value;
+}
+template <> csg::RGBCurveSlotValue* csg::SlotValue::as_ptr() {
+	return (type() != SlotType::CURVE_RGB) ? nullptr : curve_rgb_value.get();
+}
+template <> csg::VectorCurveSlotValue* csg::SlotValue::as_ptr() {
+	return (type() != SlotType::CURVE_VECTOR) ? nullptr : curve_vector_value.get();
+}
+template <> csg::ColorRampSlotValue* csg::SlotValue::as_ptr() {
+	return (type() != SlotType::COLOR_RAMP) ? nullptr : color_ramp_value.get();
+}
+
+void csg::SlotValue::hash(csc::Hasher& hasher) const
+{
+	hasher.add(static_cast<int>(_type));
+	switch (_type) {
+		case SlotType::BOOL:
+			hasher.add(value_union.bool_value.get());
+			break;
+		case SlotType::COLOR:
+			hasher.add(value_union.color_value.get());
+			break;
+		case SlotType::ENUM:
+			hasher.add(static_cast<int>(value_union.enum_value.get_meta()));
+			hasher.add(static_cast<uint64_t>(value_union.enum_value.get()));
+			break;
+		case SlotType::FLOAT:
+			hasher.add(value_union.float_value.get());
+			hasher.add(static_cast<uint64_t>(value_union.float_value.precision()));
+			break;
+		case SlotType::INT:
+			hasher.add(value_union.int_value.get());
+			break;
+		case SlotType::VECTOR:
+			hasher.add(value_union.vector_value.get());
+			hasher.add(static_cast<uint64_t>(value_union.vector_value.precision()));
+			break;
+		case SlotType::CURVE_RGB:
+			assert(curve_rgb_value.get() != nullptr);
+			curve_rgb_value->hash(hasher);
+			break;
+		case SlotType::CURVE_VECTOR:
+			assert(curve_vector_value.get() != nullptr);
+			curve_vector_value->hash(hasher);
+			break;
+		case SlotType::COLOR_RAMP:
+			assert(color_ramp_value.get() != nullptr);
+			color_ramp_value->hash(hasher);
+			break;
+		default:
+			break;
+	}
+}
+
 bool csg::SlotValue::operator==(const SlotValue& other) const
 {
 	if (_type != other._type) {
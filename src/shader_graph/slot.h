@@ -3,6 +3,7 @@
 #include <cassert>
 #include <cstddef>
 #include <memory>
+#include <utility>
 
 #include <boost/optional.hpp>
 
@@ -14,6 +15,7 @@
 
 namespace csc {
 	class FloatRect;
+	class Hasher;
 }
 
 namespace csg {
@@ -157,10 +159,10 @@ namespace csg {
 	public:
 		RGBCurveSlotValue();
 
-		Curve get_all() const { return curve_all; }
-		Curve get_r() const { return curve_r; }
-		Curve get_g() const { return curve_g; }
-		Curve get_b() const { return curve_b; }
+		const Curve& get_all() const { return curve_all; }
+		const Curve& get_r() const { return curve_r; }
+		const Curve& get_g() const { return curve_g; }
+		const Curve& get_b() const { return curve_b; }
 
 		void set(const RGBCurveSlotValue& value) { *this = RGBCurveSlotValue{ value }; }
 		bool set_all (const Curve& value);
@@ -168,6 +170,14 @@ namespace csg {
 		bool set_g(const Curve& value);
 		bool set_b(const Curve& value);
 
+		// Applies the curves to count colors of four floats each (r, g, b, a), alpha is copied unchanged
+		// Each channel goes through the combined curve and then its own, as Cycles applies them
+		// Input and output may be the same array
+		void eval_many(const float* input, float* output, size_t count) const;
+
+		// Adds this value to hasher, values that compare exactly equal add the same data
+		void hash(csc::Hasher& hasher) const;
+
 		bool operator==(const RGBCurveSlotValue& other) const;
 		bool operator!=(const RGBCurveSlotValue& other) const { return operator==(other) == false; }
 
@@ -182,9 +192,9 @@ namespace csg {
 	public:
 		VectorCurveSlotValue(csc::Float2 min, csc::Float2 max);
 
-		Curve get_x() const { return curve_x; }
-		Curve get_y() const { return curve_y; }
-		Curve get_z() const { return curve_z; }
+		const Curve& get_x() const { return curve_x; }
+		const Curve& get_y() const { return curve_y; }
+		const Curve& get_z() const { return curve_z; }
 
 		csc::Float2 get_min() const { return min; }
 		csc::Float2 get_max() const { return max; }
@@ -195,6 +205,13 @@ namespace csg {
 		bool set_z(const Curve& value);
 		bool set_bounds(csc::FloatRect bounds_rect);
 
+		// Applies the curves to count vectors of four floats each (x, y, z, w), w is copied unchanged
+		// Input and output may be the same array
+		void eval_many(const float* input, float* output, size_t count) const;
+
+		// Adds this value to hasher, values that compare exactly equal add the same data
+		void hash(csc::Hasher& hasher) const;
+
 		bool operator==(const VectorCurveSlotValue& other) const;
 		bool operator!=(const VectorCurveSlotValue& other) const { return operator==(other) == false; }
 
@@ -209,12 +226,15 @@ namespace csg {
 	class ColorRampSlotValue {
 	public:
 		ColorRampSlotValue() {}
-		ColorRampSlotValue(ColorRamp ramp) : ramp{ ramp } {}
+		ColorRampSlotValue(ColorRamp ramp) : ramp{ std::move(ramp) } {}
 
-		ColorRamp get() const { return ramp; }
+		const ColorRamp& get() const { return ramp; }
 		void set(ColorRamp new_ramp) { ramp = new_ramp; }
 		void set(ColorRampSlotValue new_ramp) { *this = new_ramp; }
 
+		// Adds this value to hasher, values that compare exactly equal add the same data
+		void hash(csc::Hasher& hasher) const;
+
 		bool operator==(const ColorRampSlotValue& other) const;
 		bool operator!=(const ColorRampSlotValue& other) const { return operator==(other) == false; }
 
@@ -234,6 +254,9 @@ namespace csg {
 		SlotValue(const RGBCurveSlotValue& curve_value) : _type{ SlotType::CURVE_RGB }, curve_rgb_value{ std::make_unique<RGBCurveSlotValue>(curve_value) } {}
 		SlotValue(const VectorCurveSlotValue& curve_value) : _type{ SlotType::CURVE_VECTOR }, curve_vector_value{ std::make_unique<VectorCurveSlotValue>(curve_value) } {}
 		SlotValue(const ColorRampSlotValue& ramp_value) : _type{ SlotType::COLOR_RAMP }, color_ramp_value{ std::make_unique<ColorRampSlotValue>(ramp_value) } {}
+		SlotValue(RGBCurveSlotValue&& curve_value) : _type{ SlotType::CURVE_RGB }, curve_rgb_value{ std::make_unique<RGBCurveSlotValue>(std::move(curve_value)) } {}
+		SlotValue(VectorCurveSlotValue&& curve_value) : _type{ SlotType::CURVE_VECTOR }, curve_vector_value{ std::make_unique<VectorCurveSlotValue>(std::move(curve_value)) } {}
+		SlotValue(ColorRampSlotValue&& ramp_value) : _type{ SlotType::COLOR_RAMP }, color_ramp_value{ std::make_unique<ColorRampSlotValue>(std::move(ramp_value)) } {}
 
 		// Copy constructor and copy assignment operator, constructor defers to assignment
 		SlotValue(const SlotValue& other) : value_union{ FloatSlotValue{ 0.0f, 0.0f, 0.0f } } { this->operator=(other); }
@@ -244,6 +267,13 @@ namespace csg {
 		// Base template function to get this object's value
 		// Needs to be specialized for each type
 		template <typename T> boost::optional<T> as() const { assert(false); }
+		// Same as as(), but points to the stored value instead of copying it
+		// Returns nullptr if this value holds a different type
+		template <typename T> const T* as_ptr() const { assert(false); return nullptr; }
+		template <typename T> T* as_ptr() { assert(false); return nullptr; }
+
+		// Adds this value to hasher, values that compare exactly equal add the same data
+		void hash(csc::Hasher& hasher) const;
 
 		bool operator==(const SlotValue& other) const;
 		bool operator!=(const SlotValue& other) const { return operator==(other) == false; }
@@ -289,6 +319,26 @@ namespace csg {
 	template <> boost::optional<VectorCurveSlotValue> SlotValue::as() const;
 	template <> boost::optional<ColorRampSlotValue> SlotValue::as() const;
 
+	template <> const BoolSlotValue* SlotValue::as_ptr() const;
+	template <> const ColorSlotValue* SlotValue::as_ptr() const;
+	template <> const EnumSlotValue* SlotValue::as_ptr() const;
+	template <> const FloatSlotValue* SlotValue::as_ptr() const;
+	template <> const IntSlotValue* SlotValue::as_ptr() const;
+	template <> const VectorSlotValue* SlotValue::as_ptr() const;
+	template <> const RGBCurveSlotValue* SlotValue::as_ptr() const;
+	template <> const VectorCurveSlotValue* SlotValue::as_ptr() const;
+	template <> const ColorRampSlotValue* SlotValue::as_ptr() const;
+
+	template <> BoolSlotValue* SlotValue::as_ptr();
+	template <> ColorSlotValue* SlotValue::as_ptr();
+	template <> EnumSlotValue* SlotValue::as_ptr();
+	template <> FloatSlotValue* SlotValue::as_ptr();
+	template <> IntSlotValue* SlotValue::as_ptr();
+	template <> VectorSlotValue* SlotValue::as_ptr();
+	template <> RGBCurveSlotValue* SlotValue::as_ptr();
+	template <> VectorCurveSlotValue* SlotValue::as_ptr();
+	template <> ColorRampSlotValue* SlotValue::as_ptr();
+
 	class Slot {
 	public:
 		// Creates a slot that does not have an editable value
@@ -334,9 +384,11 @@ namespace csg {
 		bool operator==(const Slot& other) const;
 		bool operator!=(const Slot& other) const { return operator==(other) == false; }
 
+	private:
+		// Only used to pass the default value to NodeSchema, which keeps values separately
+		friend class NodeSchema;
 		boost::optional<SlotValue> value;
 
-	private:
 		const char* _disp_name;
 		const char* _name;
 		SlotDirection _dir;
@@ -6,6 +6,7 @@
  */
 
 #include <cstddef>
+#include <functional>
 
 #include "node_id.h"
 
@@ -31,3 +32,13 @@ namespace csg {
 		size_t _index;
 	};
 }
+
+namespace std {
+	template <> struct hash<csg::SlotId> {
+		size_t operator()(const csg::SlotId& slot_id) const
+		{
+			// Node ids are random so they hash well on their own, the index only needs to be mixed in
+			return std::hash<csg::NodeId>{}(slot_id.node_id()) ^ (slot_id.index() * static_cast<size_t>(0x9e3779b97f4a7c15ULL));
+		}
+	};
+}